@@ -46,3 +46,8 @@ int*     calloc_1d_int(int n1, const int alignment) { return calloc_1d<int, int>
 int**    calloc_2d_int(int n1, int n2) { return calloc_2d<int, int>(n1, n2); }
 double*  calloc_1d_double(int n1, const int alignment) { return calloc_1d<double, int>(n1, alignment); }
 double** calloc_2d_double(int n1, int n2) { return calloc_2d<double, int>(n1, n2); }
+float*   calloc_1d_float(int n1, const int alignment) { return calloc_1d<float, int>(n1, alignment); }
+float**  calloc_2d_float(int n1, int n2) { return calloc_2d<float, int>(n1, n2); }
+
+void free_1d_float(float* f) { return free_1d<float>(f); }
+void free_2d_float(float** ff) { return free_2d<float>(ff); }
@@ -206,4 +206,9 @@ int *    calloc_1d_int(int n1, const int alignment = MEMORY_ALIGNMENT);
 int **   calloc_2d_int(int n1, int n2);
 double * calloc_1d_double(int n1, const int alignment = MEMORY_ALIGNMENT);
 double **calloc_2d_double(int n1, int n2);
+float *  calloc_1d_float(int n1, const int alignment = MEMORY_ALIGNMENT);
+float ** calloc_2d_float(int n1, int n2);
+
+void free_1d_float(float *f);
+void free_2d_float(float **ff);
 #endif
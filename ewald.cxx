@@ -7,6 +7,15 @@
  */
 #include "ewald.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern void rdft3d(int n1, int n2, int n3, int sign, double*** a, double* t, int* ip, double* w);
+extern void rdft3dsort(int, int, int, int, double***);
+#ifdef __cplusplus
+}
+#endif
+
 parallelepiped::parallelepiped(const double a[DIM], const double b[DIM], const double c[DIM]) {
     /*
       Let (') denote quantities referring to new cell frame, otherwise
@@ -139,6 +148,7 @@ void ewald::info(FILE* stream) const {
     fprintf(stream, "# k2_max            : %8g\n", k2max);
     fprintf(stream, "# k cut (kx, ky, kz): %d %d %d\n", kmax_l, kmax_m, kmax_n);
     fprintf(stream, "# rcut (r2max)      : %8g (%8g)\n", rcut, r2max);
+    fprintf(stream, "# real-space cells  : %d %d %d\n", ncell[0], ncell[1], ncell[2]);
     fprintf(stream, "# eta (eta * L)     : %8g (%8g) \n", eta, eta * rcut * 2);
     fprintf(stream, "#\n");
 }
@@ -253,20 +263,26 @@ void ewald::init_domain_k(const double& ewald_delta, const double& ewald_conv) {
     kmax_m = max_m;
     kmax_n = max_n;
 
-    coskr_l = alloc_2d_double(kmax_l + 1, nump);
-    sinkr_l = alloc_2d_double(kmax_l + 1, nump);
+    // row 1 is always needed to start the recurrences
+    coskr_l = alloc_2d_double(MAX(kmax_l, 1) + 1, nump);
+    sinkr_l = alloc_2d_double(MAX(kmax_l, 1) + 1, nump);
 
-    coskr_m = alloc_2d_double(kmax_m + 1, nump);
-    sinkr_m = alloc_2d_double(kmax_m + 1, nump);
+    coskr_m = alloc_2d_double(MAX(kmax_m, 1) + 1, nump);
+    sinkr_m = alloc_2d_double(MAX(kmax_m, 1) + 1, nump);
 
-    coskr_n = alloc_2d_double(kmax_n + 1, nump);
-    sinkr_n = alloc_2d_double(kmax_n + 1, nump);
+    coskr_n = alloc_2d_double(MAX(kmax_n, 1) + 1, nump);
+    sinkr_n = alloc_2d_double(MAX(kmax_n, 1) + 1, nump);
 
-    coskr_lm = alloc_1d_double(nump);
-    sinkr_lm = alloc_1d_double(nump);
+    kdamp    = alloc_1d_double(ewald_domain);
+    rho_k_re = alloc_1d_double(ewald_domain);
+    rho_k_im = alloc_1d_double(ewald_domain);
+    for (int i = 0; i < ewald_domain; i++) {
+        double kk = SQ(ewald_k[i][0]) + SQ(ewald_k[i][1]) + SQ(ewald_k[i][2]);
+        kdamp[i]  = exp(kk * eta_exp) / kk;
+    }
 
-    coskr = alloc_1d_double(nump);
-    sinkr = alloc_1d_double(nump);
+    soa_in  = alloc_2d_double(4, nump);
+    soa_out = alloc_2d_double(12, nump);
 
     // fprintf(stderr, "# Number of k-points: %d\n", ewald_domain);
     // fprintf(stderr, "# k cut (kx, ky, kz): %d %d %d\n",
@@ -288,6 +304,7 @@ void ewald::init_domain_k(const double& ewald_delta, const double& ewald_conv) {
 }
 
 void ewald::free_domain_k() {
+    if (ewald_cell == nullptr) return;
     free_2d_int(ewald_cell);
     free_2d_double(ewald_k);
 
@@ -297,10 +314,33 @@ void ewald::free_domain_k() {
     free_2d_double(sinkr_m);
     free_2d_double(coskr_n);
     free_2d_double(sinkr_n);
-    free_1d_double(coskr_lm);
-    free_1d_double(sinkr_lm);
-    free_1d_double(coskr);
-    free_1d_double(sinkr);
+    free_1d_double(kdamp);
+    free_1d_double(rho_k_re);
+    free_1d_double(rho_k_im);
+    free_2d_double(soa_in);
+    free_2d_double(soa_out);
+}
+
+ewald::ewald() {
+    TINFOIL = CHARGE = DIPOLE = false;
+    nump                      = 0;
+    group                     = nullptr;
+    cell                      = nullptr;
+    ewald_domain              = 0;
+    ewald_cell                = nullptr;
+    ewald_k                   = nullptr;
+    coskr_l = coskr_m = coskr_n = nullptr;
+    sinkr_l = sinkr_m = sinkr_n = nullptr;
+    kdamp = rho_k_re = rho_k_im = nullptr;
+    soa_in = soa_out = nullptr;
+    cell_nbr = nullptr;
+    cell_id = cell_start = cell_list = nullptr;
+    pol_ialpha = pol_res = pol_z = pol_p = pol_Ap = nullptr;
+
+    MIRROR         = false;
+    mirror_axis    = 0;
+    mirror_pos     = 0.0;
+    mirror_flip[0] = mirror_flip[1] = mirror_flip[2] = 1.0;
 }
 
 ewald::ewald(parallelepiped* _cell,
@@ -310,15 +350,20 @@ ewald::ewald(parallelepiped* _cell,
              const double&   ewald_conv,
              const int&      num_particles,
              const bool&     with_charge,
-             const bool&     with_dipole) {
-    TINFOIL = CHARGE = DIPOLE = false;
-    ewald_cell                = nullptr;
-    ewald_k                   = nullptr;
-    coskr_l = coskr_m = coskr_n = nullptr;
-    sinkr_l = sinkr_m = sinkr_n = nullptr;
-    coskr_lm = sinkr_lm = nullptr;
-    coskr = sinkr = nullptr;
+             const bool&     with_dipole,
+             const double&   ewald_rcut)
+    : ewald() {
+    this->init_params(_cell, ewald_alpha, ewald_epsilon, num_particles, with_charge, with_dipole, ewald_rcut);
+    this->init_domain_k(ewald_delta, ewald_conv);
+}
 
+void ewald::init_params(parallelepiped* _cell,
+                        const double&   ewald_alpha,
+                        const double&   ewald_epsilon,
+                        const int&      num_particles,
+                        const bool&     with_charge,
+                        const bool&     with_dipole,
+                        const double&   ewald_rcut) {
     cell = _cell;
 
     {  // particle parameters
@@ -331,7 +376,7 @@ ewald::ewald(parallelepiped* _cell,
     }
 
     {  // ewald parameters
-        rcut  = (cell->wmin) / 2.0;
+        rcut  = (ewald_rcut > 0.0 ? MIN(ewald_rcut, (cell->wmin) / 2.0) : (cell->wmin) / 2.0);
         r2max = rcut * rcut;
         eta   = ewald_alpha / (rcut * 2.0);
         //    fprintf(stderr, "#ewald alpha = %12.6E\n", eta);
@@ -343,13 +388,107 @@ ewald::ewald(parallelepiped* _cell,
         TINFOIL = (epsilon_bnd < 0 ? true : false);
         CHARGE  = (with_charge ? true : false);
         DIPOLE  = (with_dipole ? true : false);
+    }
+
+    this->init_cell_list();
+}
+
+void ewald::init_cell_list() {
+    const double w[DIM] = {cell->w0, cell->w1, cell->w2};
+    int          noff[DIM];  // distinct neighbour offsets along each edge
+    for (int d = 0; d < DIM; d++) {
+        ncell[d] = MAX(1, static_cast<int>(w[d] / rcut));
+        noff[d]  = MIN(3, ncell[d]);
+    }
+    ncell_tot = ncell[0] * ncell[1] * ncell[2];
+    ncell_nbr = noff[0] * noff[1] * noff[2];
+
+    cell_nbr   = alloc_2d_int(ncell_tot, ncell_nbr);
+    cell_id    = alloc_1d_int(nump);
+    cell_start = alloc_1d_int(ncell_tot + 1);
+    cell_list  = alloc_1d_int(nump);
+
+    for (int c0 = 0; c0 < ncell[0]; c0++) {
+        for (int c1 = 0; c1 < ncell[1]; c1++) {
+            for (int c2 = 0; c2 < ncell[2]; c2++) {
+                const int c = (c0 * ncell[1] + c1) * ncell[2] + c2;
+                int       n = 0;
+                // with fewer than 3 cells along an edge, -1 and +1 refer to the same (or the central) cell
+                for (int o0 = 0; o0 < noff[0]; o0++) {
+                    const int n0 = (c0 + o0 - (noff[0] == 3 ? 1 : 0) + ncell[0]) % ncell[0];
+                    for (int o1 = 0; o1 < noff[1]; o1++) {
+                        const int n1 = (c1 + o1 - (noff[1] == 3 ? 1 : 0) + ncell[1]) % ncell[1];
+                        for (int o2 = 0; o2 < noff[2]; o2++) {
+                            const int n2     = (c2 + o2 - (noff[2] == 3 ? 1 : 0) + ncell[2]) % ncell[2];
+                            cell_nbr[c][n++] = (n0 * ncell[1] + n1) * ncell[2] + n2;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+void ewald::free_cell_list() {
+    if (cell_nbr == nullptr) return;
+    free_2d_int(cell_nbr);
+    free_1d_int(cell_id);
+    free_1d_int(cell_start);
+    free_1d_int(cell_list);
+}
+
+/*
+  Bucket num items with bucket ids id[i] in [0, nbucket) (counting sort), items of bucket b are
+  list[start[b]], ..., list[start[b + 1] - 1]
+ */
+static void bucket_sort(const int& num, const int& nbucket, const int* id, int* start, int* list) {
+    for (int b = 0; b <= nbucket; b++) start[b] = 0;
+    for (int i = 0; i < num; i++) start[id[i] + 1]++;
+    for (int b = 0; b < nbucket; b++) start[b + 1] += start[b];
+    for (int i = 0; i < num; i++) list[start[id[i]]++] = i;
+    for (int b = nbucket; b > 0; b--) start[b] = start[b - 1];
+    start[0] = 0;
+}
 
-        this->init_domain_k(ewald_delta, ewald_conv);
+int ewald::cell_index(double const* r) const {
+    double* iH = (cell->iLambda)[0];
+    int     ci[DIM];
+    for (int d = 0; d < DIM; d++) {
+        double s = iH[d * DIM] * r[0] + iH[d * DIM + 1] * r[1] + iH[d * DIM + 2] * r[2];
+        s -= floor(s);
+        ci[d] = MIN(static_cast<int>(s * ncell[d]), ncell[d] - 1);
     }
+    return (ci[0] * ncell[1] + ci[1]) * ncell[2] + ci[2];
+}
+
+void ewald::build_cell_list(double const* r) {
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < nump; i++) cell_id[i] = this->cell_index(&r[i * DIM]);
+    bucket_sort(nump, ncell_tot, cell_id, cell_start, cell_list);
 }
 ewald::~ewald() {
-    free_1d_int(group);
+    if (group != nullptr) free_1d_int(group);
+    this->free_cell_list();
     this->free_domain_k();
+    this->free_polarizable();
+}
+
+void ewald::set_mirror(const int& axis, const double& pos) {
+    assert(axis >= 0 && axis < DIM);
+    // the reflection maps the periodic lattice onto itself only for rectangular cells
+    for (int a = 0; a < DIM; a++) {
+        for (int b = 0; b < DIM; b++) {
+            if (a != b) assert(ABS((cell->Lambda)[a][b]) < 1.0e-12 * (cell->wmax));
+        }
+    }
+    MIRROR      = true;
+    mirror_axis = axis;
+    mirror_pos  = pos;
+
+    // Rk flips the sign of the axis index, for axis = 0 take -Rk to stay in the l >= 0 half
+    for (int d = 0; d < DIM; d++) mirror_flip[d] = (d == axis ? -1.0 : 1.0);
+    if (axis == 0) {
+        for (int d = 0; d < DIM; d++) mirror_flip[d] = -mirror_flip[d];
+    }
 }
 
 void ewald::add_group(const int& gid, const int& num_elem, const int* pid) {
@@ -463,7 +602,22 @@ void ewald::compute_surface(double&       energy,
         double sum_qr_mu0 = sum_qr0 + sum_mu0;
         double sum_qr_mu1 = sum_qr1 + sum_mu1;
         double sum_qr_mu2 = sum_qr2 + sum_mu2;
-        energy += dmy_factor * (sum_qr_mu0 * sum_qr_mu0 + sum_qr_mu1 * sum_qr_mu1 + sum_qr_mu2 * sum_qr_mu2);
+        double dmy_scale  = 1.0;
+        if (MIRROR) {
+            // images add sum (q' r' + mu') = -R sum (q r + mu) - 2 pos e_axis sum q, only the axis component remains
+            double sum_q = 0.0;
+            if (CHARGE) {
+#pragma omp parallel for schedule(static) reduction(+ : sum_q)
+                for (int i = 0; i < nump; i++) sum_q += q[i];
+            }
+            double* sum_qr_mu[DIM] = {&sum_qr_mu0, &sum_qr_mu1, &sum_qr_mu2};
+            for (int d = 0; d < DIM; d++) {
+                *sum_qr_mu[d] = (d == mirror_axis ? 2.0 * (*sum_qr_mu[d] - mirror_pos * sum_q) : 0.0);
+            }
+            dmy_scale = 0.5;
+        }
+        energy += dmy_scale * dmy_factor *
+                  (sum_qr_mu0 * sum_qr_mu0 + sum_qr_mu1 * sum_qr_mu1 + sum_qr_mu2 * sum_qr_mu2);
 
         dmy_factor *= (-2.0);
 #pragma omp parallel for schedule(static)
@@ -486,217 +640,333 @@ void ewald::compute_surface(double&       energy,
     }
 }
 
+double ewald::compute_pair_r(const double  rij[DIM],
+                             const double& drij_sq,
+                             const bool&   same_group,
+                             const double& qi,
+                             const double* mui,
+                             const double& qj,
+                             const double* muj,
+                             double        dmy_force[DIM],
+                             double        dmy_efieldi[DIM],
+                             double        dmy_efieldj[DIM],
+                             double        dmy_efieldi_grad[DIM][DIM],
+                             double        dmy_efieldj_grad[DIM][DIM]) const {
+    double  energy = 0.0;
+    double  erfc_ewald;
+    double  drij, drij2;
+    double  Br, Cr, Dr, Er, Fr;
+    double  mui_r, muj_r, mui_muj;
+    double  dmy_0, dmy_1, dmy_2, dmy_3;
+    double* dmy_efieldi_dx = dmy_efieldi_grad[0];
+    double* dmy_efieldi_dy = dmy_efieldi_grad[1];
+    double* dmy_efieldi_dz = dmy_efieldi_grad[2];
+    double* dmy_efieldj_dx = dmy_efieldj_grad[0];
+    double* dmy_efieldj_dy = dmy_efieldj_grad[1];
+    double* dmy_efieldj_dz = dmy_efieldj_grad[2];
+
+    dmy_force[0] = dmy_force[1] = dmy_force[2] = 0.0;
+    dmy_efieldi[0] = dmy_efieldi[1] = dmy_efieldi[2] = 0.0;
+    dmy_efieldj[0] = dmy_efieldj[1] = dmy_efieldj[2] = 0.0;
+
+    dmy_efieldi_dx[0] = dmy_efieldi_dx[1] = dmy_efieldi_dx[2] = 0.0;
+    dmy_efieldi_dy[0] = dmy_efieldi_dy[1] = dmy_efieldi_dy[2] = 0.0;
+    dmy_efieldi_dz[0] = dmy_efieldi_dz[1] = dmy_efieldi_dz[2] = 0.0;
+
+    dmy_efieldj_dx[0] = dmy_efieldj_dx[1] = dmy_efieldj_dx[2] = 0.0;
+    dmy_efieldj_dy[0] = dmy_efieldj_dy[1] = dmy_efieldj_dy[2] = 0.0;
+    dmy_efieldj_dz[0] = dmy_efieldj_dz[1] = dmy_efieldj_dz[2] = 0.0;
+
+    drij       = sqrt(drij_sq);
+    erfc_ewald = (!same_group ? erfc(eta * drij) : -erf(eta * drij));
+    dmy_0      = exp(-eta2 * drij * drij);
+    drij       = 1.0 / drij;
+    drij2      = drij * drij;
+
+    dmy_0 *= 2.0 * eta * iRoot_PI;
+    Br = (erfc_ewald * drij + dmy_0) * drij2;
+
+    dmy_0 *= 2.0 * eta2;
+    Cr = (3.0 * Br + dmy_0) * drij2;
+
+    dmy_0 *= 2.0 * eta2;
+    Dr = (5.0 * Cr + dmy_0) * drij2;
+
+    dmy_0 *= 2.0 * eta2;
+    Er = (7.0 * Dr + dmy_0) * drij2;
+
+    dmy_0 *= 2.0 * eta2;
+    Fr = (9.0 * Er + dmy_0) * drij2;
+
+    if (CHARGE) {
+        energy += erfc_ewald * drij * qi * qj;
+
+        for (int d = 0; d < DIM; d++) {
+            dmy_0 = Br * rij[d];
+            dmy_force[d] += qj * qi * dmy_0;
+            dmy_efieldi[d] += qj * dmy_0;
+            dmy_efieldj[d] += (-qi * dmy_0);
+
+            dmy_0 = (-Cr * rij[d]);
+            dmy_1 = qj * dmy_0;
+            dmy_2 = qi * dmy_0;
+            dmy_efieldi_dx[d] += (dmy_1 * rij[0]);
+            dmy_efieldi_dy[d] += (dmy_1 * rij[1]);
+            dmy_efieldi_dz[d] += (dmy_1 * rij[2]);
+            dmy_efieldj_dx[d] += (dmy_2 * rij[0]);
+            dmy_efieldj_dy[d] += (dmy_2 * rij[1]);
+            dmy_efieldj_dz[d] += (dmy_2 * rij[2]);
+        }
+
+        dmy_0 = qj * Br;
+        dmy_1 = qi * Br;
+        dmy_efieldi_dx[0] += dmy_0;
+        dmy_efieldi_dy[1] += dmy_0;
+        dmy_efieldi_dz[2] += dmy_0;
+        dmy_efieldj_dx[0] += dmy_1;
+        dmy_efieldj_dy[1] += dmy_1;
+        dmy_efieldj_dz[2] += dmy_1;
+    }
+
+    if (DIPOLE) {
+        mui_r   = v_inner_prod(mui, rij);
+        muj_r   = v_inner_prod(muj, rij);
+        mui_muj = v_inner_prod(mui, muj);
+
+        // charge - dipole
+        if (CHARGE) {
+            energy += Br * (qi * muj_r - qj * mui_r);
+            dmy_0 = Cr * (qi * muj_r - qj * mui_r);
+            dmy_1 = qj * Br;
+            dmy_2 = -qi * Br;
+            for (int d = 0; d < DIM; d++)
+                dmy_force[d] += (dmy_0 * rij[d] + dmy_1 * mui[d] + dmy_2 * muj[d]);
+        }
+
+        // dipole - dipole
+        energy += (Br * mui_muj - Cr * mui_r * muj_r);
+        for (int d = 0; d < DIM; d++) {
+            dmy_0 = rij[d] * Cr;
+            dmy_1 = muj[d] * Cr;
+            dmy_2 = mui[d] * Cr;
+            dmy_3 = -rij[d] * muj_r * Dr;
+
+            dmy_force[d] += (dmy_0 * mui_muj + (dmy_1 + dmy_3) * mui_r + dmy_2 * muj_r);
+            dmy_efieldi[d] += (-Br * muj[d] + dmy_0 * muj_r);
+            dmy_efieldj[d] += (-Br * mui[d] + dmy_0 * mui_r);
+
+            dmy_efieldi_dx[d] += (dmy_0 * muj[0] + dmy_1 * rij[0] + dmy_3 * rij[0]);
+            dmy_efieldi_dy[d] += (dmy_0 * muj[1] + dmy_1 * rij[1] + dmy_3 * rij[1]);
+            dmy_efieldi_dz[d] += (dmy_0 * muj[2] + dmy_1 * rij[2] + dmy_3 * rij[2]);
+
+            dmy_3 = -rij[d] * mui_r * Dr;
+            dmy_efieldj_dx[d] -= (dmy_0 * mui[0] + dmy_2 * rij[0] + dmy_3 * rij[0]);
+            dmy_efieldj_dy[d] -= (dmy_0 * mui[1] + dmy_2 * rij[1] + dmy_3 * rij[1]);
+            dmy_efieldj_dz[d] -= (dmy_0 * mui[2] + dmy_2 * rij[2] + dmy_3 * rij[2]);
+        }
+        dmy_0 = Cr * muj_r;
+        dmy_1 = -Cr * mui_r;
+        dmy_efieldi_dx[0] += dmy_0;
+        dmy_efieldi_dy[1] += dmy_0;
+        dmy_efieldi_dz[2] += dmy_0;
+        dmy_efieldj_dx[0] += dmy_1;
+        dmy_efieldj_dy[1] += dmy_1;
+        dmy_efieldj_dz[2] += dmy_1;
+    }
+    return energy;
+}
+
 void ewald::compute_r(double&       energy,
                       double*       force,
                       double*       efield,
                       double*       efield_grad,
                       double const* r,
                       double const* q,
-                      double const* mu) const {
+                      double const* mu) {
+    this->build_cell_list(r);
+
     double dmy_energy = 0.0;
-#pragma omp parallel for schedule(dynamic, 1) reduction(+ : dmy_energy)
+#pragma omp parallel for schedule(dynamic, 16) reduction(+ : dmy_energy)
     for (int j = 1; j < nump; j++) {
         const int jj  = j * DIM;
         const int jjj = jj * DIM;
         const int jid = group[j];
 
-        double rij[DIM];
-        double erfc_ewald;
-        double drij, drij2;
-        double Br, Cr, Dr, Er, Fr;
-        double mui_r, muj_r, mui_muj;
-        double dmy_0, dmy_1, dmy_2, dmy_3;
-
-        double dmy_force[DIM];
-        double dmy_efieldi[DIM], dmy_efieldj[DIM];
-        double dmy_efieldi_dx[DIM], dmy_efieldi_dy[DIM], dmy_efieldi_dz[DIM];
-        double dmy_efieldj_dx[DIM], dmy_efieldj_dy[DIM], dmy_efieldj_dz[DIM];
+        double  rij[DIM];
+        double  drij;
+        double  dmy_force[DIM];
+        double  dmy_efieldi[DIM], dmy_efieldj[DIM];
+        double  dmy_efieldi_grad[DIM][DIM], dmy_efieldj_grad[DIM][DIM];
+        double* dmy_efieldi_dx = dmy_efieldi_grad[0];
+        double* dmy_efieldi_dy = dmy_efieldi_grad[1];
+        double* dmy_efieldi_dz = dmy_efieldi_grad[2];
+        double* dmy_efieldj_dx = dmy_efieldj_grad[0];
+        double* dmy_efieldj_dy = dmy_efieldj_grad[1];
+        double* dmy_efieldj_dz = dmy_efieldj_grad[2];
 
         const double  qj  = (CHARGE ? q[j] : 0.0);
         const double* muj = (DIPOLE ? &mu[jj] : mu_zero);
-        for (int i = 0; i < j; i++) {
-            const int ii  = i * DIM;
-            const int iii = ii * DIM;
-            const int iid = group[i];
-
-            cell->distance_MI(&r[ii], &r[jj], rij);
-            drij = rij[0] * rij[0] + rij[1] * rij[1] + rij[2] * rij[2];
-            // i and j within cutoff distance
-            if (drij < r2max) {
-                const double  qi  = (CHARGE ? q[i] : 0.0);
-                const double* mui = (DIPOLE ? &mu[ii] : mu_zero);
-
-                dmy_force[0] = dmy_force[1] = dmy_force[2] = 0.0;
-                dmy_efieldi[0] = dmy_efieldi[1] = dmy_efieldi[2] = 0.0;
-                dmy_efieldj[0] = dmy_efieldj[1] = dmy_efieldj[2] = 0.0;
-
-                dmy_efieldi_dx[0] = dmy_efieldi_dx[1] = dmy_efieldi_dx[2] = 0.0;
-                dmy_efieldi_dy[0] = dmy_efieldi_dy[1] = dmy_efieldi_dy[2] = 0.0;
-                dmy_efieldi_dz[0] = dmy_efieldi_dz[1] = dmy_efieldi_dz[2] = 0.0;
-
-                dmy_efieldj_dx[0] = dmy_efieldj_dx[1] = dmy_efieldj_dx[2] = 0.0;
-                dmy_efieldj_dy[0] = dmy_efieldj_dy[1] = dmy_efieldj_dy[2] = 0.0;
-                dmy_efieldj_dz[0] = dmy_efieldj_dz[1] = dmy_efieldj_dz[2] = 0.0;
-
-                drij       = sqrt(drij);
-                erfc_ewald = (iid != jid ? erfc(eta * drij) : -erf(eta * drij));
-                dmy_0      = exp(-eta2 * drij * drij);
-                drij       = 1.0 / drij;
-                drij2      = drij * drij;
-
-                dmy_0 *= 2.0 * eta * iRoot_PI;
-                Br = (erfc_ewald * drij + dmy_0) * drij2;
-
-                dmy_0 *= 2.0 * eta2;
-                Cr = (3.0 * Br + dmy_0) * drij2;
-
-                dmy_0 *= 2.0 * eta2;
-                Dr = (5.0 * Cr + dmy_0) * drij2;
-
-                dmy_0 *= 2.0 * eta2;
-                Er = (7.0 * Dr + dmy_0) * drij2;
-
-                dmy_0 *= 2.0 * eta2;
-                Fr = (9.0 * Er + dmy_0) * drij2;
-
-                if (CHARGE) {
-                    dmy_energy += erfc_ewald * drij * qi * qj;
-
-                    for (int d = 0; d < DIM; d++) {
-                        dmy_0 = Br * rij[d];
-                        dmy_force[d] += qj * qi * dmy_0;
-                        dmy_efieldi[d] += qj * dmy_0;
-                        dmy_efieldj[d] += (-qi * dmy_0);
-
-                        dmy_0 = (-Cr * rij[d]);
-                        dmy_1 = qj * dmy_0;
-                        dmy_2 = qi * dmy_0;
-                        dmy_efieldi_dx[d] += (dmy_1 * rij[0]);
-                        dmy_efieldi_dy[d] += (dmy_1 * rij[1]);
-                        dmy_efieldi_dz[d] += (dmy_1 * rij[2]);
-                        dmy_efieldj_dx[d] += (dmy_2 * rij[0]);
-                        dmy_efieldj_dy[d] += (dmy_2 * rij[1]);
-                        dmy_efieldj_dz[d] += (dmy_2 * rij[2]);
-                    }
-
-                    dmy_0 = qj * Br;
-                    dmy_1 = qi * Br;
-                    dmy_efieldi_dx[0] += dmy_0;
-                    dmy_efieldi_dy[1] += dmy_0;
-                    dmy_efieldi_dz[2] += dmy_0;
-                    dmy_efieldj_dx[0] += dmy_1;
-                    dmy_efieldj_dy[1] += dmy_1;
-                    dmy_efieldj_dz[2] += dmy_1;
-                }
-
-                if (DIPOLE) {
-                    mui_r   = v_inner_prod(mui, rij);
-                    muj_r   = v_inner_prod(muj, rij);
-                    mui_muj = v_inner_prod(mui, muj);
-
-                    // charge - dipole
-                    if (CHARGE) {
-                        dmy_energy += Br * (qi * muj_r - qj * mui_r);
-                        dmy_0 = Cr * (qi * muj_r - qj * mui_r);
-                        dmy_1 = qj * Br;
-                        dmy_2 = -qi * Br;
-                        for (int d = 0; d < DIM; d++)
-                            dmy_force[d] += (dmy_0 * rij[d] + dmy_1 * mui[d] + dmy_2 * muj[d]);
-                    }
-
-                    // dipole - dipole
-                    dmy_energy += (Br * mui_muj - Cr * mui_r * muj_r);
-                    for (int d = 0; d < DIM; d++) {
-                        dmy_0 = rij[d] * Cr;
-                        dmy_1 = muj[d] * Cr;
-                        dmy_2 = mui[d] * Cr;
-                        dmy_3 = -rij[d] * muj_r * Dr;
-
-                        dmy_force[d] += (dmy_0 * mui_muj + (dmy_1 + dmy_3) * mui_r + dmy_2 * muj_r);
-                        dmy_efieldi[d] += (-Br * muj[d] + dmy_0 * muj_r);
-                        dmy_efieldj[d] += (-Br * mui[d] + dmy_0 * mui_r);
-
-                        dmy_efieldi_dx[d] += (dmy_0 * muj[0] + dmy_1 * rij[0] + dmy_3 * rij[0]);
-                        dmy_efieldi_dy[d] += (dmy_0 * muj[1] + dmy_1 * rij[1] + dmy_3 * rij[1]);
-                        dmy_efieldi_dz[d] += (dmy_0 * muj[2] + dmy_1 * rij[2] + dmy_3 * rij[2]);
-
-                        dmy_3 = -rij[d] * mui_r * Dr;
-                        dmy_efieldj_dx[d] -= (dmy_0 * mui[0] + dmy_2 * rij[0] + dmy_3 * rij[0]);
-                        dmy_efieldj_dy[d] -= (dmy_0 * mui[1] + dmy_2 * rij[1] + dmy_3 * rij[1]);
-                        dmy_efieldj_dz[d] -= (dmy_0 * mui[2] + dmy_2 * rij[2] + dmy_3 * rij[2]);
-                    }
-                    dmy_0 = Cr * muj_r;
-                    dmy_1 = -Cr * mui_r;
-                    dmy_efieldi_dx[0] += dmy_0;
-                    dmy_efieldi_dy[1] += dmy_0;
-                    dmy_efieldi_dz[2] += dmy_0;
-                    dmy_efieldj_dx[0] += dmy_1;
-                    dmy_efieldj_dy[1] += dmy_1;
-                    dmy_efieldj_dz[2] += dmy_1;
-                }
 
-                {
-                    // forces
+        const int* nbr = cell_nbr[cell_id[j]];
+        for (int c = 0; c < ncell_nbr; c++) {
+            for (int n = cell_start[nbr[c]]; n < cell_start[nbr[c] + 1]; n++) {
+                const int i = cell_list[n];
+                if (i >= j) continue;
+                const int ii  = i * DIM;
+                const int iii = ii * DIM;
+                const int iid = group[i];
+
+                cell->distance_MI(&r[ii], &r[jj], rij);
+                drij = rij[0] * rij[0] + rij[1] * rij[1] + rij[2] * rij[2];
+                // i and j within cutoff distance
+                if (drij < r2max) {
+                    const double  qi  = (CHARGE ? q[i] : 0.0);
+                    const double* mui = (DIPOLE ? &mu[ii] : mu_zero);
+
+                    dmy_energy += this->compute_pair_r(rij,
+                                                       drij,
+                                                       (iid == jid),
+                                                       qi,
+                                                       mui,
+                                                       qj,
+                                                       muj,
+                                                       dmy_force,
+                                                       dmy_efieldi,
+                                                       dmy_efieldj,
+                                                       dmy_efieldi_grad,
+                                                       dmy_efieldj_grad);
+
+                    {
+                        // forces
 #pragma omp atomic
-                    force[ii] += dmy_force[0];
+                        force[ii] += dmy_force[0];
 #pragma omp atomic
-                    force[ii + 1] += dmy_force[1];
+                        force[ii + 1] += dmy_force[1];
 #pragma omp atomic
-                    force[ii + 2] += dmy_force[2];
+                        force[ii + 2] += dmy_force[2];
 
-                    force[jj] -= dmy_force[0];
-                    force[jj + 1] -= dmy_force[1];
-                    force[jj + 2] -= dmy_force[2];
-                }
+                        force[jj] -= dmy_force[0];
+                        force[jj + 1] -= dmy_force[1];
+                        force[jj + 2] -= dmy_force[2];
+                    }
 
-                {
-                    // electric fields
+                    {
+                        // electric fields
 #pragma omp atomic
-                    efield[ii] += dmy_efieldi[0];
+                        efield[ii] += dmy_efieldi[0];
 #pragma omp atomic
-                    efield[ii + 1] += dmy_efieldi[1];
+                        efield[ii + 1] += dmy_efieldi[1];
 #pragma omp atomic
-                    efield[ii + 2] += dmy_efieldi[2];
+                        efield[ii + 2] += dmy_efieldi[2];
 
-                    efield[jj] += dmy_efieldj[0];
-                    efield[jj + 1] += dmy_efieldj[1];
-                    efield[jj + 2] += dmy_efieldj[2];
-                }
+                        efield[jj] += dmy_efieldj[0];
+                        efield[jj + 1] += dmy_efieldj[1];
+                        efield[jj + 2] += dmy_efieldj[2];
+                    }
 
-                // gradient of electric fields
-                {
+                    // gradient of electric fields
+                    {
 #pragma omp atomic
-                    efield_grad[iii] += dmy_efieldi_dx[0];
+                        efield_grad[iii] += dmy_efieldi_dx[0];
 #pragma omp atomic
-                    efield_grad[iii + 1] += dmy_efieldi_dx[1];
+                        efield_grad[iii + 1] += dmy_efieldi_dx[1];
 #pragma omp atomic
-                    efield_grad[iii + 2] += dmy_efieldi_dx[2];
+                        efield_grad[iii + 2] += dmy_efieldi_dx[2];
 #pragma omp atomic
-                    efield_grad[iii + 3] += dmy_efieldi_dy[0];
+                        efield_grad[iii + 3] += dmy_efieldi_dy[0];
 #pragma omp atomic
-                    efield_grad[iii + 4] += dmy_efieldi_dy[1];
+                        efield_grad[iii + 4] += dmy_efieldi_dy[1];
 #pragma omp atomic
-                    efield_grad[iii + 5] += dmy_efieldi_dy[2];
+                        efield_grad[iii + 5] += dmy_efieldi_dy[2];
 #pragma omp atomic
-                    efield_grad[iii + 6] += dmy_efieldi_dz[0];
+                        efield_grad[iii + 6] += dmy_efieldi_dz[0];
 #pragma omp atomic
-                    efield_grad[iii + 7] += dmy_efieldi_dz[1];
+                        efield_grad[iii + 7] += dmy_efieldi_dz[1];
 #pragma omp atomic
-                    efield_grad[iii + 8] += dmy_efieldi_dz[2];
-
-                    efield_grad[jjj] += dmy_efieldj_dx[0];
-                    efield_grad[jjj + 1] += dmy_efieldj_dx[1];
-                    efield_grad[jjj + 2] += dmy_efieldj_dx[2];
-                    efield_grad[jjj + 3] += dmy_efieldj_dy[0];
-                    efield_grad[jjj + 4] += dmy_efieldj_dy[1];
-                    efield_grad[jjj + 5] += dmy_efieldj_dy[2];
-                    efield_grad[jjj + 6] += dmy_efieldj_dz[0];
-                    efield_grad[jjj + 7] += dmy_efieldj_dz[1];
-                    efield_grad[jjj + 8] += dmy_efieldj_dz[2];
-                }
-            }  // rij < r2max
-        }      // i
-    }          // j
+                        efield_grad[iii + 8] += dmy_efieldi_dz[2];
+
+                        efield_grad[jjj] += dmy_efieldj_dx[0];
+                        efield_grad[jjj + 1] += dmy_efieldj_dx[1];
+                        efield_grad[jjj + 2] += dmy_efieldj_dx[2];
+                        efield_grad[jjj + 3] += dmy_efieldj_dy[0];
+                        efield_grad[jjj + 4] += dmy_efieldj_dy[1];
+                        efield_grad[jjj + 5] += dmy_efieldj_dy[2];
+                        efield_grad[jjj + 6] += dmy_efieldj_dz[0];
+                        efield_grad[jjj + 7] += dmy_efieldj_dz[1];
+                        efield_grad[jjj + 8] += dmy_efieldj_dz[2];
+                    }
+                }  // rij < r2max
+            }      // i
+        }          // c
+    }              // j
+
+    if (MIRROR) {
+        // image pairs i, j': r_i - r_j' = R (R r_i + t - r_j), so the sources are found in the cells around the
+        // mirrored target. Each real-image pair enters the energy of the doubled system once, and is halved.
+        double dmy_energy_img = 0.0;
+#pragma omp parallel for schedule(dynamic, 16) reduction(+ : dmy_energy_img)
+        for (int i = 0; i < nump; i++) {
+            const int     ii  = i * DIM;
+            const int     iii = ii * DIM;
+            const double  qi  = (CHARGE ? q[i] : 0.0);
+            const double* mui = (DIPOLE ? &mu[ii] : mu_zero);
+
+            double ri_img[DIM], rij[DIM];
+            double drij;
+            double dmy_force[DIM];
+            double dmy_efieldi[DIM], dmy_efieldj[DIM];
+            double dmy_efieldi_grad[DIM][DIM], dmy_efieldj_grad[DIM][DIM];
+            double sum_force[DIM]            = {0.0, 0.0, 0.0};
+            double sum_efield[DIM]           = {0.0, 0.0, 0.0};
+            double sum_efield_grad[DIM][DIM] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+            this->mirror_position(&r[ii], ri_img);
+            const int* nbr = cell_nbr[this->cell_index(ri_img)];
+            for (int c = 0; c < ncell_nbr; c++) {
+                for (int n = cell_start[nbr[c]]; n < cell_start[nbr[c] + 1]; n++) {
+                    const int j  = cell_list[n];
+                    const int jj = j * DIM;
+
+                    cell->distance_MI(ri_img, &r[jj], rij);
+                    drij = rij[0] * rij[0] + rij[1] * rij[1] + rij[2] * rij[2];
+                    if (drij < r2max) {
+                        rij[mirror_axis] = -rij[mirror_axis];
+
+                        // image charge and dipole: q' = -q, mu' = -R mu
+                        const double qj_img = (CHARGE ? -q[j] : 0.0);
+                        double       muj_img[DIM];
+                        for (int d = 0; d < DIM; d++) muj_img[d] = (DIPOLE ? -mu[jj + d] : 0.0);
+                        muj_img[mirror_axis] = -muj_img[mirror_axis];
+
+                        dmy_energy_img += this->compute_pair_r(rij,
+                                                               drij,
+                                                               false,
+                                                               qi,
+                                                               mui,
+                                                               qj_img,
+                                                               muj_img,
+                                                               dmy_force,
+                                                               dmy_efieldi,
+                                                               dmy_efieldj,
+                                                               dmy_efieldi_grad,
+                                                               dmy_efieldj_grad);
+                        for (int a = 0; a < DIM; a++) {
+                            sum_force[a] += dmy_force[a];
+                            sum_efield[a] += dmy_efieldi[a];
+                            for (int b = 0; b < DIM; b++) sum_efield_grad[a][b] += dmy_efieldi_grad[a][b];
+                        }
+                    }  // rij < r2max
+                }      // j
+            }          // c
+
+            for (int a = 0; a < DIM; a++) {
+                force[ii + a] += sum_force[a];
+                efield[ii + a] += sum_efield[a];
+                for (int b = 0; b < DIM; b++) efield_grad[iii + a * DIM + b] += sum_efield_grad[a][b];
+            }
+        }  // i
+        dmy_energy += 0.5 * dmy_energy_img;
+    }
     energy += dmy_energy;
 }
 
@@ -757,116 +1027,401 @@ void ewald::compute_mu_induced(double* mu, double const* polarizability, double
     }
 }
 
-void ewald::precompute_trig_k(double const* r) {
-    double* iH = (cell->iLambda)[0];
-#pragma omp parallel for schedule(dynamic, 1)
-    for (int i = 0; i < nump; i++) {
-        const double* ri = &r[i * DIM];
-        /*
-          Transform UNIT k vectors to cartesian coordinates to compute k.r
-          k.r = k_i . r^i = ( (tiLambda)_{ij'} k_j' ) . r^i
-          = (2*pi (tiLambda)_{ij'} n_j') . r^i
-          = (2*pi (tiLambda)_{ij'} delta_{j'l'}) . r^i
-          = 2*pi (tiLambda)_{il'} r^i
-          = 2*pi (iLambda)_{l'i} r^i
-        */
-        double twopibox_l = PI2 * (iH[0] * ri[0] + iH[1] * ri[1] + iH[2] * ri[2]);
-        double twopibox_m = PI2 * (iH[3] * ri[0] + iH[4] * ri[1] + iH[5] * ri[2]);
-        double twopibox_n = PI2 * (iH[6] * ri[0] + iH[7] * ri[1] + iH[8] * ri[2]);
-        // setup cosine / sine arrays
-        coskr_l[0][i] = 1.0;
-        coskr_m[0][i] = 1.0;
-        coskr_n[0][i] = 1.0;
-
-        sinkr_l[0][i] = 0.0;
-        sinkr_m[0][i] = 0.0;
-        sinkr_n[0][i] = 0.0;
-
-        coskr_l[1][i] = cos(twopibox_l);
-        coskr_m[1][i] = cos(twopibox_m);
-        coskr_n[1][i] = cos(twopibox_n);
-
-        sinkr_l[1][i] = sin(twopibox_l);
-        sinkr_m[1][i] = sin(twopibox_m);
-        sinkr_n[1][i] = sin(twopibox_n);
-
-        for (int j = 2; j <= kmax_l; j++) {
-            coskr_l[j][i] = coskr_l[j - 1][i] * coskr_l[1][i] - sinkr_l[j - 1][i] * sinkr_l[1][i];
-            sinkr_l[j][i] = sinkr_l[j - 1][i] * coskr_l[1][i] + coskr_l[j - 1][i] * sinkr_l[1][i];
-        }
+void ewald::compute_field(double*       efield,
+                          double*       force,
+                          double*       efield_grad,
+                          double const* r,
+                          double const* q,
+                          double const* mu,
+                          const bool&   with_charge) {
+    const bool charge = CHARGE;
+    CHARGE            = (charge && with_charge);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < nump * DIM; i++) force[i] = efield[i] = 0.0;
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < nump * DIM * DIM; i++) efield_grad[i] = 0.0;
 
-        for (int j = 2; j <= kmax_m; j++) {
-            coskr_m[j][i] = coskr_m[j - 1][i] * coskr_m[1][i] - sinkr_m[j - 1][i] * sinkr_m[1][i];
-            sinkr_m[j][i] = sinkr_m[j - 1][i] * coskr_m[1][i] + coskr_m[j - 1][i] * sinkr_m[1][i];
-        }
+    double dmy_energy = 0.0;
+    this->compute_r(dmy_energy, force, efield, efield_grad, r, q, mu);
+    this->compute_k(dmy_energy, force, efield, efield_grad, r, q, mu);
+    this->compute_self(dmy_energy, force, efield, efield_grad, r, q, mu);
+    this->compute_surface(dmy_energy, force, efield, efield_grad, r, q, mu);
+    CHARGE = charge;
+}
 
-        for (int j = 2; j <= kmax_n; j++) {
-            coskr_n[j][i] = coskr_n[j - 1][i] * coskr_n[1][i] - sinkr_n[j - 1][i] * sinkr_n[1][i];
-            sinkr_n[j][i] = sinkr_n[j - 1][i] * coskr_n[1][i] + coskr_n[j - 1][i] * sinkr_n[1][i];
-        }
+/*
+  y = M x for a 3x3 block M per particle
+ */
+static void block_prod(const int& num, double* y, const double* M, const double* x) {
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < num; i++) {
+        const double* m  = &M[i * DIM * DIM];
+        const double* xi = &x[i * DIM];
+        double*       yi = &y[i * DIM];
+        yi[0]            = m[0] * xi[0] + m[1] * xi[1] + m[2] * xi[2];
+        yi[1]            = m[3] * xi[0] + m[4] * xi[1] + m[5] * xi[2];
+        yi[2]            = m[6] * xi[0] + m[7] * xi[1] + m[8] * xi[2];
     }
 }
+static double dot_prod(const int& n, const double* x, const double* y) {
+    double sum = 0.0;
+#pragma omp parallel for schedule(static) reduction(+ : sum)
+    for (int i = 0; i < n; i++) sum += x[i] * y[i];
+    return sum;
+}
+
+void ewald::init_polarizable() {
+    assert(DIPOLE);
+    this->free_polarizable();
+    pol_ialpha = alloc_1d_double(nump * DIM * DIM);
+    pol_res    = alloc_1d_double(nump * DIM);
+    pol_z      = alloc_1d_double(nump * DIM);
+    pol_p      = alloc_1d_double(nump * DIM);
+    pol_Ap     = alloc_1d_double(nump * DIM);
+}
+
+void ewald::free_polarizable() {
+    if (pol_res == nullptr) return;
+    free_1d_double(pol_ialpha);
+    free_1d_double(pol_res);
+    free_1d_double(pol_z);
+    free_1d_double(pol_p);
+    free_1d_double(pol_Ap);
+    pol_ialpha = pol_res = pol_z = pol_p = pol_Ap = nullptr;
+}
 
-void ewald::compute_trig_k(const int& ll, const int& mm, const int& nn) {
-    // Compute cos(k.r) and sin(k.r) for all particles for k = (ll, mm, nn)
-    // Note: only ll > 0 half is considered
-    int    l = ABS(ll);
-    int    m = ABS(mm);
-    int    n = ABS(nn);
-    double sign;
-
-    // cos(p l + q m) = cos(p l) cos(q m) - sin(p l) sin(q m)
-    // sin(p l + q m) = sin(p l) cos(q m) + cos(p l) sin(q m)
-    sign = (mm > 0 ? 1.0 : -1.0);
+int ewald::compute_polarizable(double*       E_ewald,
+                               double*       force,
+                               double*       torque,
+                               double*       efield,
+                               double*       efield_grad,
+                               double const* r,
+                               double const* q,
+                               double*       mu,
+                               double const* mu_perm,
+                               double const* polarizability,
+                               const double& tol,
+                               const int&    max_iter) {
+    assert(DIPOLE && pol_res != nullptr);
+    const int n      = nump * DIM;
+    double*   ialpha = pol_ialpha;
+    double*   res    = pol_res;
+    double*   z      = pol_z;
+    double*   p      = pol_p;
+    double*   Ap     = pol_Ap;
+
+    // inverse polarizabilities (cofactors)
 #pragma omp parallel for schedule(static)
-    for (int j = 0; j < nump; j++) {
-        coskr_lm[j] = coskr_l[l][j] * coskr_m[m][j] - sign * sinkr_l[l][j] * sinkr_m[m][j];
-        sinkr_lm[j] = sinkr_l[l][j] * coskr_m[m][j] + sign * coskr_l[l][j] * sinkr_m[m][j];
+    for (int i = 0; i < nump; i++) {
+        const double* a  = &polarizability[i * DIM * DIM];
+        double*       ia = &ialpha[i * DIM * DIM];
+
+        ia[0]            = a[4] * a[8] - a[5] * a[7];
+        ia[1]            = a[2] * a[7] - a[1] * a[8];
+        ia[2]            = a[1] * a[5] - a[2] * a[4];
+        ia[3]            = a[5] * a[6] - a[3] * a[8];
+        ia[4]            = a[0] * a[8] - a[2] * a[6];
+        ia[5]            = a[2] * a[3] - a[0] * a[5];
+        ia[6]            = a[3] * a[7] - a[4] * a[6];
+        ia[7]            = a[1] * a[6] - a[0] * a[7];
+        ia[8]            = a[0] * a[4] - a[1] * a[3];
+        const double det = a[0] * ia[0] + a[1] * ia[3] + a[2] * ia[6];
+        assert(det > 0.0);
+        for (int d = 0; d < DIM * DIM; d++) ia[d] /= det;
     }
 
-    // cos(p l + q m + r n) = cos(p l + q m) cos(r n) - sin(p l + q m) sin(r n)
-    // sin(p l + q m + r n) = sin(p l + q m) cos(r n) + cos(p l + q m) sin(r n)
-    sign = (nn > 0 ? 1.0 : -1.0);
+    // residual at the initial guess from the full field
+    this->compute_field(efield, force, efield_grad, r, q, mu, true);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) p[i] = mu[i] - mu_perm[i];
+    block_prod(nump, Ap, ialpha, p);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) res[i] = efield[i] - Ap[i];
+    block_prod(nump, z, polarizability, res);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) p[i] = z[i];
+
+    double rz        = dot_prod(n, res, z);
+    int    iter      = 0;
+    bool   converged = (dot_prod(n, z, z) <= SQ(tol) * dot_prod(n, mu, mu));
+    while (!converged && iter < max_iter) {
+        // A p = alpha^-1 p - T p, with T p the field of the dipoles p alone
+        this->compute_field(Ap, force, efield_grad, r, q, p, false);
+        block_prod(nump, z, ialpha, p);
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) Ap[i] = z[i] - Ap[i];
+
+        const double a = rz / dot_prod(n, p, Ap);
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            mu[i] += a * p[i];
+            res[i] -= a * Ap[i];
+        }
+        block_prod(nump, z, polarizability, res);
+        iter++;
+        converged = (dot_prod(n, z, z) <= SQ(tol) * dot_prod(n, mu, mu));
+
+        const double rz_new = dot_prod(n, res, z);
+        const double b      = rz_new / rz;
+        rz                  = rz_new;
 #pragma omp parallel for schedule(static)
-    for (int j = 0; j < nump; j++) {
-        coskr[j] = coskr_lm[j] * coskr_n[n][j] - sign * sinkr_lm[j] * sinkr_n[n][j];
-        sinkr[j] = sinkr_lm[j] * coskr_n[n][j] + sign * coskr_lm[j] * sinkr_n[n][j];
+        for (int i = 0; i < n; i++) p[i] = z[i] + b * p[i];
     }
+
+    this->compute(E_ewald, force, torque, efield, efield_grad, r, q, mu, nump);
+
+    // polarization energy
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) p[i] = mu[i] - mu_perm[i];
+    block_prod(nump, z, ialpha, p);
+    E_ewald[0] += 0.5 * dot_prod(n, p, z);
+
+    return (converged ? iter : -1);
 }
 
-inline void ewald::compute_rho_k(double&       rho_re,
-                                 double&       rho_im,
-                                 double const* q,
-                                 double const* mu,
-                                 double const  kk[DIM],
-                                 double const* coskr,
-                                 double const* sinkr) const {
-    rho_re = rho_im = 0.0;
-    double dmy_rho_re, dmy_rho_im;
-    if (CHARGE) {
-        dmy_rho_re = dmy_rho_im = 0.0;
-#pragma omp parallel for schedule(static) reduction(+ : dmy_rho_re, dmy_rho_im)
+void ewald::precompute_trig_k(double const* r) {
+    double* iH = (cell->iLambda)[0];
+    /*
+      Transform UNIT k vectors to cartesian coordinates to compute k.r
+      k.r = k_i . r^i = ( (tiLambda)_{ij'} k_j' ) . r^i
+      = (2*pi (tiLambda)_{ij'} n_j') . r^i
+      = (2*pi (tiLambda)_{ij'} delta_{j'l'}) . r^i
+      = 2*pi (tiLambda)_{il'} r^i
+      = 2*pi (iLambda)_{l'i} r^i
+    */
+    const int kmax = MAX(kmax_l, MAX(kmax_m, kmax_n));
+#pragma omp parallel
+    {
+#pragma omp for simd schedule(static)
+        for (int i = 0; i < nump; i++) {
+            const double* ri         = &r[i * DIM];
+            double        twopibox_l = PI2 * (iH[0] * ri[0] + iH[1] * ri[1] + iH[2] * ri[2]);
+            double        twopibox_m = PI2 * (iH[3] * ri[0] + iH[4] * ri[1] + iH[5] * ri[2]);
+            double        twopibox_n = PI2 * (iH[6] * ri[0] + iH[7] * ri[1] + iH[8] * ri[2]);
+            // setup cosine / sine arrays
+            coskr_l[0][i] = 1.0;
+            coskr_m[0][i] = 1.0;
+            coskr_n[0][i] = 1.0;
+
+            sinkr_l[0][i] = 0.0;
+            sinkr_m[0][i] = 0.0;
+            sinkr_n[0][i] = 0.0;
+
+            coskr_l[1][i] = cos(twopibox_l);
+            coskr_m[1][i] = cos(twopibox_m);
+            coskr_n[1][i] = cos(twopibox_n);
+
+            sinkr_l[1][i] = sin(twopibox_l);
+            sinkr_m[1][i] = sin(twopibox_m);
+            sinkr_n[1][i] = sin(twopibox_n);
+        }
+
+        // static schedules over the same range map particle i to the same thread, so each row only depends on rows
+        // written by the same thread and no barrier is needed between rows
+        for (int j = 2; j <= kmax; j++) {
+            if (j <= kmax_l) {
+                double* c0 = coskr_l[j - 1];
+                double* s0 = sinkr_l[j - 1];
+                double* c1 = coskr_l[1];
+                double* s1 = sinkr_l[1];
+                double* cj = coskr_l[j];
+                double* sj = sinkr_l[j];
+#pragma omp for simd schedule(static) nowait
+                for (int i = 0; i < nump; i++) {
+                    cj[i] = c0[i] * c1[i] - s0[i] * s1[i];
+                    sj[i] = s0[i] * c1[i] + c0[i] * s1[i];
+                }
+            }
+            if (j <= kmax_m) {
+                double* c0 = coskr_m[j - 1];
+                double* s0 = sinkr_m[j - 1];
+                double* c1 = coskr_m[1];
+                double* s1 = sinkr_m[1];
+                double* cj = coskr_m[j];
+                double* sj = sinkr_m[j];
+#pragma omp for simd schedule(static) nowait
+                for (int i = 0; i < nump; i++) {
+                    cj[i] = c0[i] * c1[i] - s0[i] * s1[i];
+                    sj[i] = s0[i] * c1[i] + c0[i] * s1[i];
+                }
+            }
+            if (j <= kmax_n) {
+                double* c0 = coskr_n[j - 1];
+                double* s0 = sinkr_n[j - 1];
+                double* c1 = coskr_n[1];
+                double* s1 = sinkr_n[1];
+                double* cj = coskr_n[j];
+                double* sj = sinkr_n[j];
+#pragma omp for simd schedule(static) nowait
+                for (int i = 0; i < nump; i++) {
+                    cj[i] = c0[i] * c1[i] - s0[i] * s1[i];
+                    sj[i] = s0[i] * c1[i] + c0[i] * s1[i];
+                }
+            }
+        }
+    }
+}
+
+/*
+  cos(k.r) and sin(k.r) for k = (ll, mm, nn), only ll >= 0 half is considered
+  cos(p l + q m) = cos(p l) cos(q m) - sin(p l) sin(q m)
+  sin(p l + q m) = sin(p l) cos(q m) + cos(p l) sin(q m)
+ */
+static inline void trig_k(double&       coskr,
+                          double&       sinkr,
+                          const double& cl,
+                          const double& sl,
+                          const double& cm,
+                          const double& sm,
+                          const double& cn,
+                          const double& sn,
+                          const double& sign_m,
+                          const double& sign_n) {
+    const double cos_lm = cl * cm - sign_m * sl * sm;
+    const double sin_lm = sl * cm + sign_m * cl * sm;
+    coskr               = cos_lm * cn - sign_n * sin_lm * sn;
+    sinkr               = sin_lm * cn + sign_n * cos_lm * sn;
+}
+
+double ewald::compute_rho_k() {
+    const double* qq  = soa_in[0];
+    const double* mux = soa_in[1];
+    const double* muy = soa_in[2];
+    const double* muz = soa_in[3];
+
+    double dmy_energy = 0.0;
+#pragma omp parallel for schedule(static) reduction(+ : dmy_energy)
+    for (int k = 0; k < ewald_domain; k++) {
+        const double* cl     = coskr_l[ABS(ewald_cell[k][0])];
+        const double* sl     = sinkr_l[ABS(ewald_cell[k][0])];
+        const double* cm     = coskr_m[ABS(ewald_cell[k][1])];
+        const double* sm     = sinkr_m[ABS(ewald_cell[k][1])];
+        const double* cn     = coskr_n[ABS(ewald_cell[k][2])];
+        const double* sn     = sinkr_n[ABS(ewald_cell[k][2])];
+        const double  sign_m = (ewald_cell[k][1] > 0 ? 1.0 : -1.0);
+        const double  sign_n = (ewald_cell[k][2] > 0 ? 1.0 : -1.0);
+        const double* kv     = ewald_k[k];
+
+        double rho_re = 0.0;
+        double rho_im = 0.0;
+#pragma omp simd reduction(+ : rho_re, rho_im)
+        for (int i = 0; i < nump; i++) {
+            double coskr, sinkr;
+            trig_k(coskr, sinkr, cl[i], sl[i], cm[i], sm[i], cn[i], sn[i], sign_m, sign_n);
+            const double mu_k = mux[i] * kv[0] + muy[i] * kv[1] + muz[i] * kv[2];
+            rho_re += qq[i] * coskr - mu_k * sinkr;
+            rho_im += qq[i] * sinkr + mu_k * coskr;
+        }
+
+        if (MIRROR) {
+            // images: rho'(k) = -exp(i k.t) rho(Rk), with rho(Rk) = conj(rho(-Rk)) for a mirror normal to x
+            const double sign_m_img  = sign_m * mirror_flip[1];
+            const double sign_n_img  = sign_n * mirror_flip[2];
+            const double kv_img[DIM] = {kv[0] * mirror_flip[0], kv[1] * mirror_flip[1], kv[2] * mirror_flip[2]};
+
+            double img_re = 0.0;
+            double img_im = 0.0;
+#pragma omp simd reduction(+ : img_re, img_im)
+            for (int i = 0; i < nump; i++) {
+                double coskr, sinkr;
+                trig_k(coskr, sinkr, cl[i], sl[i], cm[i], sm[i], cn[i], sn[i], sign_m_img, sign_n_img);
+                const double mu_k = mux[i] * kv_img[0] + muy[i] * kv_img[1] + muz[i] * kv_img[2];
+                img_re += qq[i] * coskr - mu_k * sinkr;
+                img_im += qq[i] * sinkr + mu_k * coskr;
+            }
+            if (mirror_axis == 0) img_im = -img_im;
 
-        for (int j = 0; j < nump; j++) {
-            dmy_rho_re += q[j] * coskr[j];
-            dmy_rho_im += q[j] * sinkr[j];
+            const double kt = 2.0 * mirror_pos * kv[mirror_axis];
+            const double ct = cos(kt);
+            const double st = sin(kt);
+            rho_re -= (ct * img_re - st * img_im);
+            rho_im -= (st * img_re + ct * img_im);
         }
-        rho_re += dmy_rho_re;
-        rho_im += dmy_rho_im;
+        rho_k_re[k] = rho_re;
+        rho_k_im[k] = rho_im;
+        dmy_energy += kdamp[k] * (rho_re * rho_re + rho_im * rho_im);
     }
-    if (DIPOLE) {
-        dmy_rho_re = dmy_rho_im = 0.0;
-#pragma omp parallel for schedule(static) reduction(+ : dmy_rho_re, dmy_rho_im)
-        for (int j = 0; j < nump; j++) {
-            const double* muj  = &mu[j * DIM];
-            double        mu_k = muj[0] * kk[0] + muj[1] * kk[1] + muj[2] * kk[2];
-            dmy_rho_re += (-mu_k * sinkr[j]);
-            dmy_rho_im += (mu_k * coskr[j]);
+    return dmy_energy;
+}
+
+void ewald::compute_k_particles() {
+    const int     block = 256;
+    const double* qq    = soa_in[0];
+    const double* mux   = soa_in[1];
+    const double* muy   = soa_in[2];
+    const double* muz   = soa_in[3];
+
+    double* fx  = soa_out[0];
+    double* fy  = soa_out[1];
+    double* fz  = soa_out[2];
+    double* ex  = soa_out[3];
+    double* ey  = soa_out[4];
+    double* ez  = soa_out[5];
+    double* gxx = soa_out[6];
+    double* gxy = soa_out[7];
+    double* gxz = soa_out[8];
+    double* gyy = soa_out[9];
+    double* gyz = soa_out[10];
+    double* gzz = soa_out[11];
+
+#pragma omp parallel for schedule(static)
+    for (int ib = 0; ib < nump; ib += block) {
+        const int ie = MIN(ib + block, nump);
+        for (int n = 0; n < 12; n++) {
+            double* out = soa_out[n];
+            for (int i = ib; i < ie; i++) out[i] = 0.0;
+        }
+
+        for (int k = 0; k < ewald_domain; k++) {
+            const double* cl     = coskr_l[ABS(ewald_cell[k][0])];
+            const double* sl     = sinkr_l[ABS(ewald_cell[k][0])];
+            const double* cm     = coskr_m[ABS(ewald_cell[k][1])];
+            const double* sm     = sinkr_m[ABS(ewald_cell[k][1])];
+            const double* cn     = coskr_n[ABS(ewald_cell[k][2])];
+            const double* sn     = sinkr_n[ABS(ewald_cell[k][2])];
+            const double  sign_m = (ewald_cell[k][1] > 0 ? 1.0 : -1.0);
+            const double  sign_n = (ewald_cell[k][2] > 0 ? 1.0 : -1.0);
+            const double* kv     = ewald_k[k];
+
+            const double damp   = kdamp[k] * (cell->PI8iVol);
+            const double rho_re = damp * rho_k_re[k];
+            const double rho_im = damp * rho_k_im[k];
+            const double k00    = kv[0] * kv[0];
+            const double k01    = kv[0] * kv[1];
+            const double k02    = kv[0] * kv[2];
+            const double k11    = kv[1] * kv[1];
+            const double k12    = kv[1] * kv[2];
+            const double k22    = kv[2] * kv[2];
+#pragma omp simd
+            for (int i = ib; i < ie; i++) {
+                double coskr, sinkr;
+                trig_k(coskr, sinkr, cl[i], sl[i], cm[i], sm[i], cn[i], sn[i], sign_m, sign_n);
+                const double mu_k        = mux[i] * kv[0] + muy[i] * kv[1] + muz[i] * kv[2];
+                const double qq_re       = -(qq[i] * sinkr + mu_k * coskr);
+                const double qq_im       = (qq[i] * coskr - mu_k * sinkr);
+                const double dmy_force   = -(qq_re * rho_re + qq_im * rho_im);
+                const double dmy_efield  = -(coskr * rho_im - sinkr * rho_re);
+                const double dmy_efield2 = (coskr * rho_re + sinkr * rho_im);
+
+                fx[i] += dmy_force * kv[0];
+                fy[i] += dmy_force * kv[1];
+                fz[i] += dmy_force * kv[2];
+
+                ex[i] += dmy_efield * kv[0];
+                ey[i] += dmy_efield * kv[1];
+                ez[i] += dmy_efield * kv[2];
+
+                gxx[i] += dmy_efield2 * k00;
+                gxy[i] += dmy_efield2 * k01;
+                gxz[i] += dmy_efield2 * k02;
+                gyy[i] += dmy_efield2 * k11;
+                gyz[i] += dmy_efield2 * k12;
+                gzz[i] += dmy_efield2 * k22;
+            }
         }
-        rho_re += dmy_rho_re;
-        rho_im += dmy_rho_im;
     }
 }
+
 void ewald::compute_k(double&       energy,
                       double*       force,
                       double*       efield,
@@ -874,69 +1429,47 @@ void ewald::compute_k(double&       energy,
                       double const* r,
                       double const* q,
                       double const* mu) {
-    double dmy_energy, dmy_force, dmy_efield, dmy_efield_grad, dmy_efield_grad0;
-    dmy_energy = dmy_force = dmy_efield = dmy_efield_grad = 0.0;
+    {  // SoA copy of particle data, zero for missing multipoles
+        double* qq  = soa_in[0];
+        double* mux = soa_in[1];
+        double* muy = soa_in[2];
+        double* muz = soa_in[3];
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < nump; i++) {
+            qq[i]  = (CHARGE ? q[i] : 0.0);
+            mux[i] = (DIPOLE ? mu[i * DIM] : 0.0);
+            muy[i] = (DIPOLE ? mu[i * DIM + 1] : 0.0);
+            muz[i] = (DIPOLE ? mu[i * DIM + 2] : 0.0);
+        }
+    }
 
     this->precompute_trig_k(r);
+    energy += (MIRROR ? 0.5 : 1.0) * (cell->PI4iVol) * this->compute_rho_k();
+    this->compute_k_particles();
 
-    for (int i = 0; i < ewald_domain; i++) {
-        // compute cos(kr) and sin(kr) terms for all particles
-        this->compute_trig_k(ewald_cell[i][0], ewald_cell[i][1], ewald_cell[i][2]);
-
-        // k vector in cartesian (lab) coordinates
-        double& k0 = ewald_k[i][0];
-        double& k1 = ewald_k[i][1];
-        double& k2 = ewald_k[i][2];
-
-        double rho_re, rho_im;
-        this->compute_rho_k(rho_re, rho_im, q, mu, ewald_k[i], coskr, sinkr);
-
-        double kk         = k0 * k0 + k1 * k1 + k2 * k2;
-        double ewald_damp = exp(kk * eta_exp) / kk;
-        dmy_energy += ewald_damp * (rho_re * rho_re + rho_im * rho_im);
-
-        ewald_damp *= (cell->PI8iVol);
-
-#pragma omp parallel for schedule(static) private(dmy_force, dmy_efield, dmy_efield_grad0, dmy_efield_grad)
-
-        for (int j = 0; j < nump; j++) {
-            const int     jj    = j * DIM;
-            const int     jjj   = jj * DIM;
-            const double  qj    = (CHARGE ? q[j] : 0.0);
-            const double* muj   = (DIPOLE ? &mu[jj] : mu_zero);
-            double        mu_k  = (DIPOLE ? muj[0] * k0 + muj[1] * k1 + muj[2] * k2 : 0.0);
-            double        qq_re = -(qj * sinkr[j] + mu_k * coskr[j]);
-            double        qq_im = (qj * coskr[j] - mu_k * sinkr[j]);
-
-            dmy_force  = -ewald_damp * (qq_re * rho_re + qq_im * rho_im);
-            dmy_efield = -ewald_damp * (coskr[j] * rho_im - sinkr[j] * rho_re);
-
-            force[jj] += dmy_force * k0;
-            force[jj + 1] += dmy_force * k1;
-            force[jj + 2] += dmy_force * k2;
-
-            efield[jj] += dmy_efield * k0;
-            efield[jj + 1] += dmy_efield * k1;
-            efield[jj + 2] += dmy_efield * k2;
-
-            dmy_efield_grad0 = ewald_damp * (coskr[j] * rho_re + sinkr[j] * rho_im);
-            dmy_efield_grad  = dmy_efield_grad0 * k0;
-            efield_grad[jjj] += dmy_efield_grad * k0;      // xx
-            efield_grad[jjj + 1] += dmy_efield_grad * k1;  // xy
-            efield_grad[jjj + 2] += dmy_efield_grad * k2;  // xz
-
-            dmy_efield_grad = dmy_efield_grad0 * k1;
-            efield_grad[jjj + 3] += dmy_efield_grad * k0;  // yx
-            efield_grad[jjj + 4] += dmy_efield_grad * k1;  // yy
-            efield_grad[jjj + 5] += dmy_efield_grad * k2;  // yz
-
-            dmy_efield_grad = dmy_efield_grad0 * k2;
-            efield_grad[jjj + 6] += dmy_efield_grad * k0;  // zx
-            efield_grad[jjj + 7] += dmy_efield_grad * k1;  // zy
-            efield_grad[jjj + 8] += dmy_efield_grad * k2;  // zz
-        }
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < nump; i++) {
+        const int ii  = i * DIM;
+        const int iii = ii * DIM;
+
+        force[ii] += soa_out[0][i];
+        force[ii + 1] += soa_out[1][i];
+        force[ii + 2] += soa_out[2][i];
+
+        efield[ii] += soa_out[3][i];
+        efield[ii + 1] += soa_out[4][i];
+        efield[ii + 2] += soa_out[5][i];
+
+        efield_grad[iii] += soa_out[6][i];       // xx
+        efield_grad[iii + 1] += soa_out[7][i];   // xy
+        efield_grad[iii + 2] += soa_out[8][i];   // xz
+        efield_grad[iii + 3] += soa_out[7][i];   // yx
+        efield_grad[iii + 4] += soa_out[9][i];   // yy
+        efield_grad[iii + 5] += soa_out[10][i];  // yz
+        efield_grad[iii + 6] += soa_out[8][i];   // zx
+        efield_grad[iii + 7] += soa_out[10][i];  // zy
+        efield_grad[iii + 8] += soa_out[11][i];  // zz
     }
-    energy += (cell->PI4iVol) * dmy_energy;
 }
 
 void ewald::save_results(const double& E_ewald,
@@ -1054,3 +1587,423 @@ void ewald::compute(double*       E_ewald,
     }
     */
 }
+
+spme::spme(parallelepiped* _cell,
+           const double&   ewald_alpha,
+           const double&   ewald_epsilon,
+           const int       spme_mesh[DIM],
+           const int&      spme_order,
+           const int&      num_particles,
+           const bool&     with_charge,
+           const bool&     with_dipole,
+           const double&   ewald_rcut)
+    : ewald() {
+    this->init_params(_cell, ewald_alpha, ewald_epsilon, num_particles, with_charge, with_dipole, ewald_rcut);
+
+    // field gradients require second derivatives of the splines
+    order = spme_order;
+    assert(order >= 4);
+    for (int d = 0; d < DIM; d++) {
+        mesh[d] = spme_mesh[d];
+        assert(mesh[d] >= order && (mesh[d] & (mesh[d] - 1)) == 0);
+    }
+    mesh_z_ = mesh[2] + 2;
+    mesh_hz = mesh[2] / 2 + 1;
+
+    base_img  = slab_img_id = slab_img_start = slab_img_list = nullptr;
+    theta_img = dtheta_img = ddtheta_img = nullptr;
+
+    this->init_mesh();
+}
+spme::~spme() { this->free_mesh(); }
+
+void spme::set_mirror(const int& axis, const double& pos) {
+    ewald::set_mirror(axis, pos);
+    if (base_img != nullptr) return;
+    base_img       = alloc_1d_int(nump);
+    theta_img      = alloc_1d_double(nump * order);
+    dtheta_img     = alloc_1d_double(nump * order);
+    ddtheta_img    = alloc_1d_double(nump * order);
+    slab_img_id    = alloc_1d_int(nump);
+    slab_img_start = alloc_1d_int(nslab + 1);
+    slab_img_list  = alloc_1d_int(nump);
+}
+
+void spme::info(FILE* stream) const {
+    fprintf(stream, "# \n");
+    fprintf(stream, "### SPME Params       : \n");
+    fprintf(stream, "# mesh (Kx, Ky, Kz)  : %d %d %d\n", mesh[0], mesh[1], mesh[2]);
+    fprintf(stream, "# spline order       : %d\n", order);
+    fprintf(stream, "# spreading slabs    : %d\n", nslab);
+    fprintf(stream, "# rcut (r2max)       : %8g (%8g)\n", rcut, r2max);
+    fprintf(stream, "# real-space cells   : %d %d %d\n", ncell[0], ncell[1], ncell[2]);
+    fprintf(stream, "# eta (eta * L)      : %8g (%8g) \n", eta, eta * rcut * 2);
+    fprintf(stream, "#\n");
+}
+
+void spme::init_mesh() {
+    // lab (cartesian) to mesh coordinates, u^a = K_a (iLambda)_{ab} r^b
+    umap  = alloc_2d_double(DIM, DIM);
+    tumap = alloc_2d_double(DIM, DIM);
+    for (int a = 0; a < DIM; a++) {
+        for (int b = 0; b < DIM; b++) {
+            umap[a][b]  = static_cast<double>(mesh[a]) * (cell->iLambda)[a][b];
+            tumap[b][a] = umap[a][b];
+        }
+    }
+
+    qmesh     = alloc_3d_double(mesh[0], mesh[1], mesh_z_);
+    influence = alloc_1d_double(mesh[0] * mesh[1] * mesh_hz);
+
+    base    = alloc_1d_int(nump * DIM);
+    theta   = alloc_1d_double(nump * DIM * order);
+    dtheta  = alloc_1d_double(nump * DIM * order);
+    ddtheta = alloc_1d_double(nump * DIM * order);
+
+    // particles spread onto x-slabs at least one spline support wide, so that slabs of equal parity never overlap
+    nslab = mesh[0] / order;
+    nslab = (nslab >= 2 ? nslab - nslab % 2 : 1);
+    slab_id    = alloc_1d_int(nump);
+    slab_start = alloc_1d_int(nslab + 1);
+    slab_list  = alloc_1d_int(nump);
+
+    {  // ooura fft work arrays
+        int n, nt;
+        nt        = MAX(mesh[0], mesh[1]);
+        n         = MAX(nt, mesh[2] / 2);
+        fft_ip    = alloc_1d_int(2 + (int)sqrt((double)n + 0.5));
+        fft_t     = alloc_1d_double(8 * nt);
+        fft_w     = alloc_1d_double(n / 2 + mesh[2] / 4);
+        fft_ip[0] = 0;
+    }
+
+    // B-spline moduli |b(m)|^2
+    double*  th   = alloc_1d_double(order);
+    double*  dth  = alloc_1d_double(order);
+    double*  ddth = alloc_1d_double(order);
+    double** bmod = (double**)malloc(sizeof(double*) * DIM);
+    this->compute_bspline(0.0, th, dth, ddth);  // th[j] = M_p(j)
+    for (int d = 0; d < DIM; d++) {
+        const int K = mesh[d];
+        bmod[d]     = alloc_1d_double(K);
+        for (int m = 0; m < K; m++) {
+            double b_re = 0.0;
+            double b_im = 0.0;
+            for (int j = 0; j <= order - 2; j++) {
+                double arg = PI2 * static_cast<double>(m * j) / static_cast<double>(K);
+                b_re += th[j + 1] * cos(arg);
+                b_im += th[j + 1] * sin(arg);
+            }
+            double b2  = b_re * b_re + b_im * b_im;
+            bmod[d][m] = (b2 > 1.0e-14 ? 1.0 / b2 : 0.0);
+        }
+        // odd orders vanish at the nyquist frequency, interpolate from neighbours
+        for (int m = 0; m < K; m++) {
+            if (bmod[d][m] == 0.0) bmod[d][m] = 0.5 * (bmod[d][(m - 1 + K) % K] + bmod[d][(m + 1) % K]);
+        }
+    }
+
+    // influence function exp(-k^2 / 4 eta^2) / k^2, with k = 2 pi (tiLambda) m
+    double* tiH[DIM] = {cell->tiLambda[0], cell->tiLambda[1], cell->tiLambda[2]};
+#pragma omp parallel for schedule(static)
+    for (int k0 = 0; k0 < mesh[0]; k0++) {
+        const double m0 = PI2 * static_cast<double>(k0 <= mesh[0] / 2 ? k0 : k0 - mesh[0]);
+        for (int k1 = 0; k1 < mesh[1]; k1++) {
+            const double m1 = PI2 * static_cast<double>(k1 <= mesh[1] / 2 ? k1 : k1 - mesh[1]);
+            for (int k2 = 0; k2 < mesh_hz; k2++) {
+                const double m2 = PI2 * static_cast<double>(k2);
+                double       kv[DIM];
+                for (int d = 0; d < DIM; d++) kv[d] = tiH[d][0] * m0 + tiH[d][1] * m1 + tiH[d][2] * m2;
+                double kk = SQ(kv[0]) + SQ(kv[1]) + SQ(kv[2]);
+
+                const int im = (k0 * mesh[1] + k1) * mesh_hz + k2;
+                if (k0 == 0 && k1 == 0 && k2 == 0) {
+                    influence[im] = 0.0;
+                } else {
+                    influence[im] = (cell->PI4iVol) * exp(kk * eta_exp) / kk * bmod[0][k0] * bmod[1][k1] * bmod[2][k2];
+                }
+            }
+        }
+    }
+
+    for (int d = 0; d < DIM; d++) free_1d_double(bmod[d]);
+    free(bmod);
+    free_1d_double(th);
+    free_1d_double(dth);
+    free_1d_double(ddth);
+}
+void spme::free_mesh() {
+    free_2d_double(umap);
+    free_2d_double(tumap);
+    free_3d_double(qmesh);
+    free_1d_double(influence);
+
+    free_1d_int(base);
+    free_1d_double(theta);
+    free_1d_double(dtheta);
+    free_1d_double(ddtheta);
+
+    free_1d_int(slab_id);
+    free_1d_int(slab_start);
+    free_1d_int(slab_list);
+
+    if (base_img != nullptr) {
+        free_1d_int(base_img);
+        free_1d_double(theta_img);
+        free_1d_double(dtheta_img);
+        free_1d_double(ddtheta_img);
+        free_1d_int(slab_img_id);
+        free_1d_int(slab_img_start);
+        free_1d_int(slab_img_list);
+    }
+
+    free_1d_int(fft_ip);
+    free_1d_double(fft_t);
+    free_1d_double(fft_w);
+}
+
+void spme::compute_bspline(const double& w, double* th, double* dth, double* ddth) const {
+    // M_2(w + j) = 1 - |w + j - 1|
+    for (int j = 0; j < order; j++) th[j] = 0.0;
+    th[0] = w;
+    th[1] = 1.0 - w;
+
+    // M_k(x) = (x M_{k-1}(x) + (k - x) M_{k-1}(x - 1)) / (k - 1)
+    for (int k = 3; k <= order; k++) {
+        if (k == order - 1) {  // M_p''(x) = M_{p-2}(x) - 2 M_{p-2}(x - 1) + M_{p-2}(x - 2)
+            for (int j = 0; j < order; j++) {
+                ddth[j] = th[j] - (j >= 1 ? 2.0 * th[j - 1] : 0.0) + (j >= 2 ? th[j - 2] : 0.0);
+            }
+        }
+        if (k == order) {  // M_p'(x) = M_{p-1}(x) - M_{p-1}(x - 1)
+            for (int j = 0; j < order; j++) {
+                dth[j] = th[j] - (j >= 1 ? th[j - 1] : 0.0);
+            }
+        }
+        const double ik = 1.0 / static_cast<double>(k - 1);
+        for (int j = k - 1; j >= 0; j--) {
+            const double x = w + static_cast<double>(j);
+            th[j]          = (x * th[j] + (j >= 1 ? (static_cast<double>(k) - x) * th[j - 1] : 0.0)) * ik;
+        }
+    }
+}
+
+void spme::precompute_spline(double const* r) {
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < nump; i++) {
+        const double* ri = &r[i * DIM];
+        for (int a = 0; a < DIM; a++) {
+            const double K = static_cast<double>(mesh[a]);
+            double       u = umap[a][0] * ri[0] + umap[a][1] * ri[1] + umap[a][2] * ri[2];
+            u -= K * floor(u / K);
+            int b = static_cast<int>(u);
+            b     = (b >= mesh[a] ? b - mesh[a] : b);
+
+            const int ia      = (i * DIM + a) * order;
+            base[i * DIM + a] = b;
+            this->compute_bspline(u - static_cast<double>(b), &theta[ia], &dtheta[ia], &ddtheta[ia]);
+        }
+        slab_id[i] = base[i * DIM] * nslab / mesh[0];
+
+        if (MIRROR) {  // image only differs along the mirror axis
+            const int    a = mirror_axis;
+            const double K = static_cast<double>(mesh[a]);
+            double       ri_img[DIM];
+            this->mirror_position(ri, ri_img);
+            double u = umap[a][0] * ri_img[0] + umap[a][1] * ri_img[1] + umap[a][2] * ri_img[2];
+            u -= K * floor(u / K);
+            int b = static_cast<int>(u);
+            b     = (b >= mesh[a] ? b - mesh[a] : b);
+
+            base_img[i] = b;
+            this->compute_bspline(
+                u - static_cast<double>(b), &theta_img[i * order], &dtheta_img[i * order], &ddtheta_img[i * order]);
+            slab_img_id[i] = (a == 0 ? b : base[i * DIM]) * nslab / mesh[0];
+        }
+    }
+
+    bucket_sort(nump, nslab, slab_id, slab_start, slab_list);
+    if (MIRROR) bucket_sort(nump, nslab, slab_img_id, slab_img_start, slab_img_list);
+}
+
+void spme::spread(double const* q, double const* mu) {
+    double* qq = qmesh[0][0];
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < mesh[0] * mesh[1] * mesh_z_; i++) qq[i] = 0.0;
+
+    // spline supports only overlap between neighbouring slabs: do even slabs, then odd slabs (mirror images are
+    // spread in a second sweep with their own slabs)
+    for (int img = 0; img < (MIRROR ? 2 : 1); img++) {
+        const int* s_start = (img == 0 ? slab_start : slab_img_start);
+        const int* s_list  = (img == 0 ? slab_list : slab_img_list);
+        for (int color = 0; color < 2; color++) {
+#pragma omp parallel for schedule(dynamic, 1)
+            for (int s = color; s < nslab; s += 2) {
+                for (int n = s_start[s]; n < s_start[s + 1]; n++) {
+                    const int i  = s_list[n];
+                    double    qi = (CHARGE ? q[i] : 0.0);
+                    double    mui[DIM];
+                    for (int d = 0; d < DIM; d++) mui[d] = (DIPOLE ? mu[i * DIM + d] : 0.0);
+
+                    int           bi[DIM] = {base[i * DIM], base[i * DIM + 1], base[i * DIM + 2]};
+                    const double* th[DIM] = {&theta[(i * DIM) * order],
+                                             &theta[(i * DIM + 1) * order],
+                                             &theta[(i * DIM + 2) * order]};
+                    const double* dh[DIM] = {&dtheta[(i * DIM) * order],
+                                             &dtheta[(i * DIM + 1) * order],
+                                             &dtheta[(i * DIM + 2) * order]};
+                    if (img == 1) {  // q' = -q, mu' = -R mu
+                        qi = -qi;
+                        for (int d = 0; d < DIM; d++) mui[d] = (d == mirror_axis ? mui[d] : -mui[d]);
+                        bi[mirror_axis] = base_img[i];
+                        th[mirror_axis] = &theta_img[i * order];
+                        dh[mirror_axis] = &dtheta_img[i * order];
+                    }
+                    this->spread_particle(qi, mui, bi, th, dh);
+                }
+            }
+        }
+    }
+}
+
+void spme::spread_particle(const double&        qi,
+                           const double*        mui,
+                           const int*           bi,
+                           const double* const* th,
+                           const double* const* dh) {
+    // dipole in mesh coordinates: mu . grad_r = (umap mu)^a d/du^a
+    double mu_u[DIM];
+    for (int a = 0; a < DIM; a++) mu_u[a] = umap[a][0] * mui[0] + umap[a][1] * mui[1] + umap[a][2] * mui[2];
+
+    const double* th0 = th[0];
+    const double* th1 = th[1];
+    const double* th2 = th[2];
+    const double* dh0 = dh[0];
+    const double* dh1 = dh[1];
+    const double* dh2 = dh[2];
+
+    for (int j0 = 0; j0 < order; j0++) {
+        const int g0 = (bi[0] - j0 + mesh[0]) % mesh[0];
+        for (int j1 = 0; j1 < order; j1++) {
+            const int    g1   = (bi[1] - j1 + mesh[1]) % mesh[1];
+            const double w_t  = qi * th0[j0] * th1[j1] + mu_u[0] * dh0[j0] * th1[j1] + mu_u[1] * th0[j0] * dh1[j1];
+            const double w_d  = mu_u[2] * th0[j0] * th1[j1];
+            double*      q_01 = qmesh[g0][g1];
+            for (int j2 = 0; j2 < order; j2++) {
+                const int g2 = (bi[2] - j2 + mesh[2]) % mesh[2];
+                q_01[g2] += w_t * th2[j2] + w_d * dh2[j2];
+            }
+        }
+    }
+}
+
+double spme::solve_k() {
+    rdft3d(mesh[0], mesh[1], mesh[2], 1, qmesh, fft_t, fft_ip, fft_w);
+    rdft3dsort(mesh[0], mesh[1], mesh[2], 1, qmesh);
+
+    // E = 1/2 sum_m G(m) |Q(m)|^2 over full k-space, kz > 0 modes are counted twice
+    // the backward transform returns half the unnormalized sum, hence the factor 2
+    double energy = 0.0;
+#pragma omp parallel for schedule(static) reduction(+ : energy)
+    for (int k0 = 0; k0 < mesh[0]; k0++) {
+        for (int k1 = 0; k1 < mesh[1]; k1++) {
+            double*       qk = qmesh[k0][k1];
+            const double* gk = &influence[(k0 * mesh[1] + k1) * mesh_hz];
+            for (int k2 = 0; k2 < mesh_hz; k2++) {
+                const double wk = (k2 == 0 || k2 == mesh[2] / 2 ? 0.5 : 1.0);
+                energy += wk * gk[k2] * (SQ(qk[2 * k2]) + SQ(qk[2 * k2 + 1]));
+                qk[2 * k2] *= 2.0 * gk[k2];
+                qk[2 * k2 + 1] *= 2.0 * gk[k2];
+            }
+        }
+    }
+
+    rdft3dsort(mesh[0], mesh[1], mesh[2], -1, qmesh);
+    rdft3d(mesh[0], mesh[1], mesh[2], -1, qmesh, fft_t, fft_ip, fft_w);
+    return energy;
+}
+
+void spme::gather(double* force, double* efield, double* efield_grad, double const* q, double const* mu) const {
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < nump; i++) {
+        const int*    bi  = &base[i * DIM];
+        const double* th0 = &theta[(i * DIM) * order];
+        const double* th1 = th0 + order;
+        const double* th2 = th1 + order;
+        const double* dh0 = &dtheta[(i * DIM) * order];
+        const double* dh1 = dh0 + order;
+        const double* dh2 = dh1 + order;
+        const double* dd0 = &ddtheta[(i * DIM) * order];
+        const double* dd1 = dd0 + order;
+        const double* dd2 = dd1 + order;
+
+        // first and second derivatives of the potential in mesh coordinates
+        double g_u[DIM]      = {0.0, 0.0, 0.0};
+        double h_u[DIM][DIM] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+        for (int j0 = 0; j0 < order; j0++) {
+            const int g0 = (bi[0] - j0 + mesh[0]) % mesh[0];
+            for (int j1 = 0; j1 < order; j1++) {
+                const int     g1   = (bi[1] - j1 + mesh[1]) % mesh[1];
+                const double* q_01 = qmesh[g0][g1];
+                double        s, s_d, s_dd;
+                s = s_d = s_dd = 0.0;
+                for (int j2 = 0; j2 < order; j2++) {
+                    const double phi = q_01[(bi[2] - j2 + mesh[2]) % mesh[2]];
+                    s += phi * th2[j2];
+                    s_d += phi * dh2[j2];
+                    s_dd += phi * dd2[j2];
+                }
+                g_u[0] += dh0[j0] * th1[j1] * s;
+                g_u[1] += th0[j0] * dh1[j1] * s;
+                g_u[2] += th0[j0] * th1[j1] * s_d;
+
+                h_u[0][0] += dd0[j0] * th1[j1] * s;
+                h_u[1][1] += th0[j0] * dd1[j1] * s;
+                h_u[2][2] += th0[j0] * th1[j1] * s_dd;
+                h_u[0][1] += dh0[j0] * dh1[j1] * s;
+                h_u[0][2] += dh0[j0] * th1[j1] * s_d;
+                h_u[1][2] += th0[j0] * dh1[j1] * s_d;
+            }
+        }
+        h_u[1][0] = h_u[0][1];
+        h_u[2][0] = h_u[0][2];
+        h_u[2][1] = h_u[1][2];
+
+        // back to lab coordinates: E = -grad phi, grad E = -grad grad phi
+        double E[DIM], gradE[DIM][DIM], hu_map[DIM][DIM];
+        for (int b = 0; b < DIM; b++) {
+            E[b] = -(tumap[b][0] * g_u[0] + tumap[b][1] * g_u[1] + tumap[b][2] * g_u[2]);
+            for (int c = 0; c < DIM; c++) {
+                hu_map[b][c] = h_u[b][0] * umap[0][c] + h_u[b][1] * umap[1][c] + h_u[b][2] * umap[2][c];
+            }
+        }
+        for (int b = 0; b < DIM; b++) {
+            for (int c = 0; c < DIM; c++) {
+                gradE[b][c] = -(tumap[b][0] * hu_map[0][c] + tumap[b][1] * hu_map[1][c] + tumap[b][2] * hu_map[2][c]);
+            }
+        }
+
+        const int     ii  = i * DIM;
+        const int     iii = ii * DIM;
+        const double  qi  = (CHARGE ? q[i] : 0.0);
+        const double* mui = (DIPOLE ? &mu[ii] : mu_zero);
+        for (int c = 0; c < DIM; c++) {
+            force[ii + c] += qi * E[c] + mui[0] * gradE[0][c] + mui[1] * gradE[1][c] + mui[2] * gradE[2][c];
+            efield[ii + c] += E[c];
+            for (int b = 0; b < DIM; b++) efield_grad[iii + b * DIM + c] += gradE[b][c];
+        }
+    }
+}
+
+void spme::compute_k(double&       energy,
+                     double*       force,
+                     double*       efield,
+                     double*       efield_grad,
+                     double const* r,
+                     double const* q,
+                     double const* mu) {
+    this->precompute_spline(r);
+    this->spread(q, mu);
+    energy += (MIRROR ? 0.5 : 1.0) * this->solve_k();
+    this->gather(force, efield, efield_grad, q, mu);
+}
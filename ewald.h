@@ -51,6 +51,7 @@ class parallelepiped {
         lc = l2;
     };
     friend class ewald;
+    friend class spme;
 
    private:
     // geometric parameters
@@ -77,8 +78,8 @@ class ewald {
       \brief ewald constructor
       \param[in] _cell pointer to parallelepiped object.
 
-      \param[in] ewald_alpha screening parameter. Units are 1/L, where L is the smallest perpendicular distance between
-      faces of the parallelepiped (smallest length for renctangular boxes).
+      \param[in] ewald_alpha screening parameter. Units are 1/L, where L is twice the real-space cutoff (by default the
+      smallest perpendicular distance between faces of the parallelepiped, smallest length for renctangular boxes).
 
       \param[in] ewald_epsilon dielectric permittivity at boundary, 1 for vacuum and infinity for tinfoil (if < 0 it is
       set to tinfoil)
@@ -96,6 +97,8 @@ class ewald {
       \param[in] num_particles number of particles or charge centers
       \param[in] with_charge whether to include point charges true/false
       \param[in] with_dipole whether to include point dipoles true/false
+      \param[in] ewald_rcut real-space cutoff, at most half the smallest perpendicular width (if <= 0 it is set to
+      this maximum)
      */
     ewald(parallelepiped* _cell,
           const double&   ewald_alpha,
@@ -104,11 +107,22 @@ class ewald {
           const double&   ewald_conv,
           const int&      num_particles,
           const bool&     with_charge,
-          const bool&     with_dipole);
+          const bool&     with_dipole,
+          const double&   ewald_rcut = -1.0);
     /*!
       \brief ewald destroyer
      */
-    ~ewald();
+    virtual ~ewald();
+
+    /*!
+      \brief Add conducting mirror images of all particles across the plane r[axis] = pos
+      \details The images (q' = -q, mu' = -R mu, r' = R r + 2 pos e_axis, with R the reflection) are never
+      stored: real-space image pairs are found from the cells around the mirrored targets and the image structure
+      factors are obtained from the real ones. Only the real particles receive forces, fields and field gradients,
+      and the reported energy is half that of the periodic system of particles plus images.
+      \warning The cell must be rectangular and aligned with the lab axes
+     */
+    virtual void set_mirror(const int& axis, const double& pos);
 
     /*!
       \brief Add num_elem particles specified in pid to group with given id
@@ -149,6 +163,8 @@ class ewald {
 
     /*!
       \brief Compute real-space contributions
+      \details Pairs are taken from a cell list in the parallelepiped frame, so the cost is linear in the number of
+      particles for a fixed cutoff
      */
     void compute_r(double&       energy,
                    double*       force,
@@ -156,12 +172,12 @@ class ewald {
                    double*       efield_grad,
                    double const* r,
                    double const* q,
-                   double const* mu) const;
+                   double const* mu);
 
     /*!
       \brief Compute k-space contributions
      */
-    void compute_k(double&       energy,
+    virtual void compute_k(double&       energy,
                    double*       force,
                    double*       efield,
                    double*       efield_grad,
@@ -205,12 +221,61 @@ class ewald {
 
     void compute_mu_induced(double* mu, double const* polarizability, double const* efield) const;
 
+    /*!
+      \brief Allocate the work arrays of compute_polarizable
+     */
+    void init_polarizable();
+
+    /*!
+      \brief Compute all particle quantities with self-consistent induced dipoles
+      \details Solves mu = mu_perm + alpha E(mu) for the total dipoles, with E the ewald field at the particles, by
+      conjugate gradients on (alpha^-1 - T) mu = alpha^-1 mu_perm + E_q (T the dipole field operator, E_q the field
+      of the charges), preconditioned with alpha. The iteration starts from the dipoles passed in mu (e.g. those of
+      the previous step) and stops once the preconditioned residual, i.e. the change a direct update mu_perm +
+      alpha E would make, is below tol relative to |mu|. Each iteration costs one field evaluation. Forces,
+      torques and fields are then computed as in compute, and the polarization energy
+      1/2 (mu - mu_perm) alpha^-1 (mu - mu_perm) is added to E_ewald[0].
+      \param[in,out] mu total dipoles (initial guess on input)
+      \param[in] mu_perm permanent dipoles
+      \param[in] polarizability symmetric positive definite 3x3 polarizability of each particle
+      \return number of iterations, -1 if not converged within max_iter
+      \warning init_polarizable must be called once before
+     */
+    int compute_polarizable(double*       E_ewald,
+                            double*       force,
+                            double*       torque,
+                            double*       efield,
+                            double*       efield_grad,
+                            double const* r,
+                            double const* q,
+                            double*       mu,
+                            double const* mu_perm,
+                            double const* polarizability,
+                            const double& tol,
+                            const int&    max_iter);
+
     /*!
       \brief Printout summary of parameters to stream
     */
-    void info(FILE* stream) const;
+    virtual void info(FILE* stream) const;
+
+   protected:
+    /*!
+      \brief Construct without k-space domain (for derived reciprocal-space solvers)
+     */
+    ewald();
+
+    /*!
+      \brief Set real-space screening parameters and particle groups
+     */
+    void init_params(parallelepiped* _cell,
+                     const double&   ewald_alpha,
+                     const double&   ewald_epsilon,
+                     const int&      num_particles,
+                     const bool&     with_charge,
+                     const bool&     with_dipole,
+                     const double&   ewald_rcut);
 
-   private:
     static const double mu_zero[DIM];
 
     // particle data
@@ -236,12 +301,81 @@ class ewald {
     // auxiliary k arrays
     double **coskr_l, **coskr_m, **coskr_n;
     double **sinkr_l, **sinkr_m, **sinkr_n;
-    double * coskr_lm, *sinkr_lm;
-    double * coskr, *sinkr;
+    double * kdamp;                // exp(-k^2 / 4 eta^2) / k^2 for each k vector
+    double * rho_k_re, *rho_k_im;  // structure factors for each k vector
+    double **soa_in;               // SoA particle data: q, mu_x, mu_y, mu_z
+    double **soa_out;              // SoA k-space results: force (3), efield (3), efield_grad (6, symmetric)
 
     // cell data
     parallelepiped* cell;
 
+    // mirror plane (conducting images)
+    bool   MIRROR;
+    int    mirror_axis;
+    double mirror_pos;
+    double mirror_flip[DIM];  // signs of the k indices of +-Rk in the l >= 0 half
+
+    // real-space cell list
+    int   ncell[DIM];  // number of cells along each edge (perpendicular width >= rcut)
+    int   ncell_tot;   // total number of cells
+    int   ncell_nbr;   // number of distinct neighbour cells (including self)
+    int** cell_nbr;    // neighbour cells of each cell
+    int*  cell_id;     // cell of each particle
+    int*  cell_start;  // first entry of each cell in cell_list
+    int*  cell_list;   // particles sorted by cell
+
+    // induced dipole solver work arrays (init_polarizable)
+    double* pol_ialpha;       // inverse polarizability of each particle (3x3)
+    double *pol_res, *pol_z;  // residual E(mu) - alpha^-1 (mu - mu_perm) and alpha res
+    double *pol_p, *pol_Ap;   // search direction and the operator applied to it
+    void    free_polarizable();
+
+    /*!
+      \brief Define real-space cells and their neighbours in the parallelepiped frame
+      \details A pair within the cutoff differs by at most rcut/w_a in fractional coordinate a, so with cells of
+      perpendicular width w_a / ncell[a] >= rcut only adjacent cells need to be searched.
+     */
+    void init_cell_list();
+    void free_cell_list();
+
+    /*!
+      \brief Bin particles into real-space cells
+     */
+    void build_cell_list(double const* r);
+
+    /*!
+      \brief Real-space cell containing position r
+     */
+    int cell_index(double const* r) const;
+
+    /*!
+      \brief Mirror image of position r
+     */
+    inline void mirror_position(double const* r, double* r_img) const {
+        r_img[0]           = r[0];
+        r_img[1]           = r[1];
+        r_img[2]           = r[2];
+        r_img[mirror_axis] = 2.0 * mirror_pos - r[mirror_axis];
+    }
+
+    /*!
+      \brief Screened real-space interaction of the pair i, j at separation rij = r_i - r_j, returns the pair energy
+      \details Force is that on i, fields and field gradients are given at both i and j. Pairs within the same
+      group only remove the corresponding k-space contribution.
+     */
+    double compute_pair_r(const double  rij[DIM],
+                          const double& drij_sq,
+                          const bool&   same_group,
+                          const double& qi,
+                          const double* mui,
+                          const double& qj,
+                          const double* muj,
+                          double        dmy_force[DIM],
+                          double        dmy_efieldi[DIM],
+                          double        dmy_efieldj[DIM],
+                          double        dmy_efieldi_grad[DIM][DIM],
+                          double        dmy_efieldj_grad[DIM][DIM]) const;
+
     /*!
       \brief Defines the k-space domain that will be used in the ewald calculations
       \details Given the ewald convergence parameters, defines the appropriate cutoff
@@ -262,24 +396,32 @@ class ewald {
 
     /*!
       \brief Precompute trigonometric sine/cosine factor
+      \details Tables are stored [k index][particle], so the recurrences vectorise over particles
      */
     void precompute_trig_k(double const* r);
 
     /*!
-      \brief Compute trigonometric factors for given k vector
+      \brief Compute structure factors of all k vectors (each thread owns a set of k vectors), returns k-space energy
+     */
+    double compute_rho_k();
+
+    /*!
+      \brief Accumulate k-space force, field and field gradient (each thread owns a block of particles and loops over
+      all k vectors)
      */
-    void compute_trig_k(const int& ll, const int& mm, const int& nn);
+    void compute_k_particles();
 
     /*!
-      \brief Compute total charge density in k-space
+      \brief Compute only the electric field at the particles (force and efield_grad are used as work arrays)
+      \details Without charges this is the (linear) dipole field operator applied to mu
      */
-    void compute_rho_k(double&       rho_re,
-                       double&       rho_im,
+    void compute_field(double*       efield,
+                       double*       force,
+                       double*       efield_grad,
+                       double const* r,
                        double const* q,
                        double const* mu,
-                       double const  kk[DIM],
-                       double const* coskr,
-                       double const* sinkr) const;
+                       const bool&   with_charge);
 
     /*!
       \brief auxiliary routines to copy sekibun cell
@@ -313,4 +455,129 @@ class ewald {
                            double const* mu,
                            char const*   save_buffer) const;
 };
+
+/*!
+  \brief Smooth particle mesh ewald (SPME)
+  \details Real-space, self and surface contributions are inherited from ewald. The k-space sum is replaced by
+  spreading charges and dipoles onto a mesh with cardinal B-splines of order p, a convolution with the (B-spline
+  corrected) influence function computed with 3d real FFTs, and an interpolation of the mesh potential back to the
+  particles with the same splines. Forces, fields and field gradients are obtained from the first and second
+  derivatives of the splines, so the order should be at least 4. The cost is O(N p^3 + M log M) for M mesh points.
+  \note Mesh sizes must be powers of 2 (Ooura FFT)
+ */
+class spme : public ewald {
+   public:
+    /*!
+      \brief spme constructor
+      \param[in] _cell pointer to parallelepiped object.
+      \param[in] ewald_alpha screening parameter (see ewald)
+      \param[in] ewald_epsilon dielectric permittivity at boundary (see ewald)
+      \param[in] spme_mesh number of mesh points along each cell edge
+      \param[in] spme_order B-spline interpolation order
+      \param[in] num_particles number of particles or charge centers
+      \param[in] with_charge whether to include point charges true/false
+      \param[in] with_dipole whether to include point dipoles true/false
+      \param[in] ewald_rcut real-space cutoff (see ewald)
+     */
+    spme(parallelepiped* _cell,
+         const double&   ewald_alpha,
+         const double&   ewald_epsilon,
+         const int       spme_mesh[DIM],
+         const int&      spme_order,
+         const int&      num_particles,
+         const bool&     with_charge,
+         const bool&     with_dipole,
+         const double&   ewald_rcut = -1.0);
+    ~spme();
+
+    /*!
+      \brief Compute k-space contributions on the mesh
+     */
+    void compute_k(double&       energy,
+                   double*       force,
+                   double*       efield,
+                   double*       efield_grad,
+                   double const* r,
+                   double const* q,
+                   double const* mu);
+
+    void set_mirror(const int& axis, const double& pos);
+
+    void info(FILE* stream) const;
+
+   private:
+    int order;       // spline order
+    int mesh[DIM];   // mesh size
+    int mesh_z_;     // padded z dimension (mesh[2] + 2)
+    int mesh_hz;     // number of independent kz modes (mesh[2] / 2 + 1)
+    double** umap;   // lab to mesh coordinates : u^a = umap[a][b] r^b
+    double** tumap;  // transpose
+
+    // mesh data
+    double*** qmesh;      // charge density / potential on mesh
+    double*   influence;  // B-spline corrected influence function (half complex layout)
+
+    // per particle spline data
+    int*    base;     // largest mesh index within support of spline
+    double* theta;    // spline weights
+    double* dtheta;   // first derivatives
+    double* ddtheta;  // second derivatives
+
+    // spline data of mirror images along the mirror axis (the other axes are shared with the particles)
+    int*    base_img;
+    double* theta_img;
+    double* dtheta_img;
+    double* ddtheta_img;
+
+    // x-slab decomposition for race-free spreading
+    int  nslab;
+    int* slab_id;
+    int* slab_start;
+    int* slab_list;
+    int* slab_img_id;  // same for mirror images
+    int* slab_img_start;
+    int* slab_img_list;
+
+    // ooura fft work arrays
+    int*    fft_ip;
+    double* fft_t;
+    double* fft_w;
+
+    void init_mesh();
+    void free_mesh();
+
+    /*!
+      \brief Compute cardinal B-spline values M_p(w + j), j = 0,...,p-1 and first two derivatives for w in [0,1)
+     */
+    void compute_bspline(const double& w, double* th, double* dth, double* ddth) const;
+
+    /*!
+      \brief Compute spline weights and mesh positions for all particles
+     */
+    void precompute_spline(double const* r);
+
+    /*!
+      \brief Spread charges and dipoles onto mesh
+     */
+    void spread(double const* q, double const* mu);
+
+    /*!
+      \brief Spread a single charge and dipole with mesh positions bi and spline weights th, dh along each axis
+     */
+    void spread_particle(const double&        qi,
+                         const double*        mui,
+                         const int*           bi,
+                         const double* const* th,
+                         const double* const* dh);
+
+    /*!
+      \brief Convolve mesh charge with influence function, return k-space energy
+     */
+    double solve_k();
+
+    /*!
+      \brief Interpolate potential derivatives to particles and compute forces, fields and field gradients
+     */
+    void gather(double* force, double* efield, double* efield_grad, double const* q, double const* mu) const;
+};
 #endif
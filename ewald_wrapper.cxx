@@ -14,6 +14,7 @@ ewald *         ewald_sum;
 
 void free_ewald_sum() {
     ewald_mem.free();
+    delete ewald_sum;
     delete ewald_cell;
 }
 
@@ -23,15 +24,30 @@ void init_ewald_sum(const double &lx, const double &ly, const double &lz, const
     double c[DIM] = {0.0, 0.0, lz};
     ewald_cell    = new parallelepiped(a, b, c);
     ewald_mem.init(num);
-    ewald_sum = new ewald(ewald_cell,
-                          ewald_param.alpha,
-                          ewald_param.epsilon,
-                          ewald_param.delta,
-                          ewald_param.conv,
-                          ewald_mem.num,
-                          ewald_param.charge,
-                          ewald_param.dipole);
+    if (ewald_param.spme) {
+        ewald_sum = new spme(ewald_cell,
+                             ewald_param.alpha,
+                             ewald_param.epsilon,
+                             ewald_param.spme_mesh,
+                             ewald_param.spme_order,
+                             ewald_mem.num,
+                             ewald_param.charge,
+                             ewald_param.dipole,
+                             ewald_param.rcut);
+    } else {
+        ewald_sum = new ewald(ewald_cell,
+                              ewald_param.alpha,
+                              ewald_param.epsilon,
+                              ewald_param.delta,
+                              ewald_param.conv,
+                              ewald_mem.num,
+                              ewald_param.charge,
+                              ewald_param.dipole,
+                              ewald_param.rcut);
+    }
     ewald_sum->define_groups(ewald_mem.group_id);
+    if (ewald_param.m_image) ewald_sum->set_mirror(ewald_param.mirror_axis, ewald_param.mirror_pos);
+    if (ewald_param.polarizable) ewald_sum->init_polarizable();
     for (int i = 0; i < ewald_mem.num; i++) {
         ewald_mem.efield[i][0] = ewald_mem.efield[i][1] = ewald_mem.efield[i][2] = 0.0;
     }
@@ -47,15 +63,40 @@ void compute_ewald_sum() {
     double *dmy_mu = (ewald_param.dipole ? ewald_mem.mu[0] : nullptr);
     // Calculation
     ewald_sum->reset_boundary(ewald_param.epsilon);
-    ewald_sum->compute(ewald_mem.energy,
-                       ewald_mem.force[0],
-                       ewald_mem.torque[0],
-                       ewald_mem.efield[0],
-                       ewald_mem.efield_grad[0][0],
-                       ewald_mem.r[0],
-                       dmy_q,
-                       dmy_mu,
-                       ewald_mem.num);
+    if (ewald_param.polarizable) {
+        // induced dipoles, starting from those of the previous call
+        int iter = ewald_sum->compute_polarizable(ewald_mem.energy,
+                                                  ewald_mem.force[0],
+                                                  ewald_mem.torque[0],
+                                                  ewald_mem.efield[0],
+                                                  ewald_mem.efield_grad[0][0],
+                                                  ewald_mem.r[0],
+                                                  dmy_q,
+                                                  dmy_mu,
+                                                  ewald_mem.mu_perm[0],
+                                                  ewald_mem.polarizability,
+                                                  ewald_param.pol_tol,
+                                                  ewald_param.pol_max_iter);
+        ewald_mem.pol_iter     = (iter < 0 ? ewald_param.pol_max_iter : iter);
+        ewald_mem.pol_iter_max = MAX(ewald_mem.pol_iter_max, ewald_mem.pol_iter);
+        if (iter < 0) {
+            ewald_mem.pol_failures++;
+            fprintf(stderr,
+                    "# Warning : induced dipoles not converged after %d iterations (tol = %8g)\n",
+                    ewald_param.pol_max_iter,
+                    ewald_param.pol_tol);
+        }
+    } else {
+        ewald_sum->compute(ewald_mem.energy,
+                           ewald_mem.force[0],
+                           ewald_mem.torque[0],
+                           ewald_mem.efield[0],
+                           ewald_mem.efield_grad[0][0],
+                           ewald_mem.r[0],
+                           dmy_q,
+                           dmy_mu,
+                           ewald_mem.num);
+    }
 }
 
 void print_ewald_info(FILE *stream) {
@@ -70,7 +111,40 @@ void print_ewald_info(FILE *stream) {
     fprintf(stream, "# alpha = %8g\n", ewald_param.alpha);
     fprintf(stream, "# delta = %8g\n", ewald_param.delta);
     fprintf(stream, "# convergence = %8g\n", ewald_param.conv);
+    if (ewald_param.rcut > 0.0) fprintf(stream, "# rcut = %8g\n", ewald_param.rcut);
+    if (ewald_param.polarizable) {
+        fprintf(stream,
+                "# polarizability = %8g (tol = %8g, max iter = %d)\n",
+                ewald_param.polarizability,
+                ewald_param.pol_tol,
+                ewald_param.pol_max_iter);
+    }
+    if (ewald_param.m_image) {
+        const char axis[DIM] = {'X', 'Y', 'Z'};
+        fprintf(stream, "# mirror images across %c = %8g\n", axis[ewald_param.mirror_axis], ewald_param.mirror_pos);
+    }
+    if (ewald_param.spme) {
+        fprintf(stream,
+                "# SPME mesh = %d x %d x %d, order = %d\n",
+                ewald_param.spme_mesh[0],
+                ewald_param.spme_mesh[1],
+                ewald_param.spme_mesh[2],
+                ewald_param.spme_order);
+    }
     fprintf(stream, "#\n");
     ewald_sum->info(stream);
     fprintf(stream, "#\n");
 }
+
+// iteration counts of the induced dipole solves since the previous call
+void print_ewald_polarization(FILE *stream) {
+    if (!(ewald_param.enabled && ewald_param.polarizable)) return;
+    fprintf(stream,
+            "# Induced dipoles: iterations last = %d, max = %d (limit %d), not converged = %d\n",
+            ewald_mem.pol_iter,
+            ewald_mem.pol_iter_max,
+            ewald_param.pol_max_iter,
+            ewald_mem.pol_failures);
+    ewald_mem.pol_iter_max = 0;
+    ewald_mem.pol_failures = 0;
+}
@@ -20,12 +20,25 @@ typedef struct EwaldParams {
     double delta   = EPSILON_MP;
     double conv    = 0.51;
     double epsilon = -1.0;  // tinfoil if < 0
+    double rcut    = -1.0;  // half the smallest box length if <= 0
     double Pz_factor;
     bool   charge  = false;
     bool   dipole  = false;
     bool   enabled = false;
     bool   m_image = false;
-    void   init(double _alpha, double _delta, double _conv, double _eps, bool _charge, bool _dipole) {
+    // conducting mirror plane r[mirror_axis] = mirror_pos (lower surface of FLAT_WALL)
+    int    mirror_axis = 2;
+    double mirror_pos  = 0.0;
+    // smooth particle mesh ewald (k-space sum on mesh)
+    bool spme           = false;
+    int  spme_mesh[DIM] = {32, 32, 32};
+    int  spme_order     = 6;
+    // self-consistent induced dipoles mu = mu_perm + alpha E (isotropic alpha)
+    bool   polarizable    = false;
+    double polarizability = 0.0;
+    double pol_tol        = 1.0e-6;  // relative change of the dipoles
+    int    pol_max_iter   = 100;
+    void init(double _alpha, double _delta, double _conv, double _eps, bool _charge, bool _dipole) {
         alpha   = _alpha;
         delta   = _delta;
         conv    = _conv;
@@ -34,6 +47,19 @@ typedef struct EwaldParams {
         dipole  = _dipole;
         enabled = _charge || _dipole;
     }
+    void init_spme(int _mesh_x, int _mesh_y, int _mesh_z, int _order) {
+        spme         = true;
+        spme_mesh[0] = _mesh_x;
+        spme_mesh[1] = _mesh_y;
+        spme_mesh[2] = _mesh_z;
+        spme_order   = _order;
+    }
+    void init_polarization(double _alpha, double _tol, int _max_iter) {
+        polarizable    = true;
+        polarizability = _alpha;
+        pol_tol        = _tol;
+        pol_max_iter   = _max_iter;
+    }
 } EwaldParams;
 extern EwaldParams ewald_param;
 
@@ -45,6 +71,13 @@ typedef struct EwaldMem {
     double * q  = nullptr;
     double **mu = nullptr;
 
+    // induced dipoles: permanent dipoles (mu holds the total dipoles of the last step), polarizability tensors
+    double **mu_perm        = nullptr;
+    double * polarizability = nullptr;
+    int      pol_iter       = 0;  // iterations of the last induced dipole solve
+    int      pol_iter_max   = 0;  // most iterations of a solve since the last report
+    int      pol_failures   = 0;  // solves that hit pol_max_iter since the last report
+
     double ** force;
     double ** torque;
     double ** efield;
@@ -58,35 +91,28 @@ typedef struct EwaldMem {
     void init(const int &_num) {
         num      = _num;
         group_id = (int *)alloc_1d_int(num);
-        if (ewald_param.m_image == true) {
-            r  = (double **)alloc_2d_double(num * 2, DIM);
-            mu = (ewald_param.dipole ? (double **)alloc_2d_double(num * 2, DIM) : nullptr);
-        } else {
-            r  = (double **)alloc_2d_double(num, DIM);
-            mu = (ewald_param.dipole ? (double **)alloc_2d_double(num, DIM) : nullptr);
-        }
-        q = (ewald_param.charge ? (double *)alloc_1d_double(num) : nullptr);
-
-        if (ewald_param.m_image == true) {
-            {
-                double *rr = r[0];
-                for (int i = 0; i < num * 2 * DIM; i++) rr[i] = 0.0;
-                if (ewald_param.dipole) {
-                    double *pp = mu[0];
-                    for (int i = 0; i < num * 2 * DIM; i++) pp[i] = 0.0;
-                }
-            }
-        } else {
-            {
-                double *rr = r[0];
-                for (int i = 0; i < num * DIM; i++) rr[i] = 0.0;
-                if (ewald_param.dipole) {
-                    double *pp = mu[0];
-                    for (int i = 0; i < num * DIM; i++) pp[i] = 0.0;
-                }
+        r        = (double **)alloc_2d_double(num, DIM);
+        mu       = (ewald_param.dipole ? (double **)alloc_2d_double(num, DIM) : nullptr);
+        q        = (ewald_param.charge ? (double *)alloc_1d_double(num) : nullptr);
+        {
+            double *rr = r[0];
+            for (int i = 0; i < num * DIM; i++) rr[i] = 0.0;
+            if (ewald_param.dipole) {
+                double *pp = mu[0];
+                for (int i = 0; i < num * DIM; i++) pp[i] = 0.0;
             }
         }
         for (int i = 0; i < num; i++) group_id[i] = -(i + 1);
+        if (ewald_param.polarizable) {
+            mu_perm        = (double **)alloc_2d_double(num, DIM);
+            polarizability = (double *)alloc_1d_double(num * DIM * DIM);
+            for (int i = 0; i < num * DIM; i++) mu_perm[0][i] = 0.0;
+            for (int i = 0; i < num * DIM * DIM; i++) polarizability[i] = 0.0;
+            for (int i = 0; i < num; i++) {
+                double *alpha_i = &polarizability[i * DIM * DIM];
+                alpha_i[0] = alpha_i[4] = alpha_i[8] = ewald_param.polarizability;
+            }
+        }
         if (ewald_param.charge) {
             for (int i = 0; i < num; i++) q[i] = 0.0;
         }
@@ -103,6 +129,10 @@ typedef struct EwaldMem {
 
         free_2d_double(r);
         if (ewald_param.dipole) free_2d_double(mu);
+        if (ewald_param.polarizable) {
+            free_2d_double(mu_perm);
+            free_1d_double(polarizability);
+        }
 
         free_2d_double(force);
         free_2d_double(torque);
@@ -120,5 +150,6 @@ void free_ewald_sum();
 void init_ewald_sum(const double &lx, const double &ly, const double &lz, const int &num);
 void compute_ewald_sum();
 void print_ewald_info(FILE *stream);
+void print_ewald_polarization(FILE *stream);
 
 #endif
@@ -17,6 +17,8 @@ double * shear_rate_field;
 
 double sreff_old;
 
+Stencil_table stencil;
+
 void        Make_psi_all(double *psi_all, double const *psi) {
 #pragma omp parallel for
     for (int i = 0; i < NX; i++) {
@@ -32,38 +34,17 @@ void        Make_psi_all(double *psi_all, double const *psi) {
 
 void NS_solver_slavedEuler_explicit(double **u, double *Pressure, Particle *p, CTime &jikan) {
     if (jikan.ts > 0) {
-        Cpy_v3(adv_o, adv);
+        Swap_v3(adv_o, adv);
         if (PHASE_SEPARATION) {
-            Cpy_v3(stress_o, stress);
-        }
-    }
-
-    U2advection(u, adv);
-    U2laplacian(u, lap);
-
-    if (jikan.ts < 2) {
-        Update_u_adv_euler(u, adv, jikan);
-    } else {
-        Update_u_adv_ab2(u, adv, adv_o, jikan);
-    }
-
-    Update_u_lap_euler(u, lap, jikan);
-
-    if (PHASE_SEPARATION) {
-        Calc_cp(phi, psi_all, cp);
-        Cp2stress(cp, psi_all, stress);
-
-        if (jikan.ts < 2) {
-            Update_u_stress_euler(u, stress, jikan);
-        } else {
-            Update_u_stress_ab2(u, stress, stress_o, jikan);
+            Swap_v3(stress_o, stress);
         }
     }
 
     if (PHASE_SEPARATION) {
-        Set_poisson_rhs_ps(u, adv, lap, stress, rhs, jikan);
+        Calc_cp_stress(phi, psi_all, cp, stress);
+        Update_u_explicit_fused(u, adv, adv_o, stress, stress_o, rhs, jikan);
     } else {
-        Set_poisson_rhs(u, adv, lap, rhs, jikan);
+        Update_u_explicit_fused(u, adv, adv_o, NULL, NULL, rhs, jikan);
     }
 
     Solve_poisson_dft(Pressure, rhs);
@@ -93,10 +74,10 @@ void NS_solver_slavedEuler_implicit(double **u, double *Pressure, Particle *p, C
         Make_phi_s(w_v3[1], w_v3[2], p, DX, NP_domain, Sekibun_cell, Ns, jikan);
         if (SW_WALL != NO_WALL) {
             Calc_cp_wall(w_v3[1], phi_p, phi_wall_prime, w_v3[0], cp);
+            Cp2stress(cp, w_v3[0], stress);
         } else {
-            Calc_cp(w_v3[1], w_v3[0], cp);
+            Calc_cp_stress(w_v3[1], w_v3[0], cp, stress);
         }
-        Cp2stress(cp, w_v3[0], stress);
 
         if (VISCOSITY_CHANGE) {
             Psi2eta(w_v3[0], eta_s);
@@ -136,9 +117,9 @@ void NS_solver_slavedEuler_implicit(double **u, double *Pressure, Particle *p, C
 
 void NS_solver_slavedEuler_Shear_OBL_explicit(double **u, double *Pressure, Particle *p, CTime &jikan) {
     if (jikan.ts > 0) {
-        Cpy_v3(adv_o, adv);
+        Swap_v3(adv_o, adv);
         if (PHASE_SEPARATION) {
-            Cpy_v3(stress_o, stress);
+            Swap_v3(stress_o, stress);
         }
     }
 
@@ -256,22 +237,112 @@ void        Set_poisson_rhs(double **u, double **adv_u, double **lap_u, double *
     Set_poisson_rhs_sub(u, w_v3_3, s, jikan);
 }
 
-void Update_u_pressure(double **u, double *dp, CTime &jikan) {
-    int    im;
-    double dmy = jikan.dt_fluid * IRHO;
-#pragma omp parallel for private(im)
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                im = (i * NY * NZ_) + (j * NZ_) + k;
+void Update_u_explicit_fused(double **u,
+                             double **adv_u,
+                             double **adv_u_old,
+                             double **stress_u,
+                             double **stress_u_old,
+                             double * s,
+                             CTime &  jikan) {
+    const double INV_2DX = 1. / (2. * DX);
+    const double INV_DX2 = 1. / (DX * DX);
+    const double INV_DT  = 1. / jikan.dt_fluid;
+    const double dt      = jikan.dt_fluid;
+    const bool   ab2     = (jikan.ts >= 2);
+    double **    u_star  = w_v3;
+    double **    force   = w_v3_3;
+
+    // sweep 1: adv_u, provisional velocity u_star and explicit force adv - NU lap (+ stress), from u only
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double ux = u[0][im];
+                    double uy = u[1][im];
+                    double uz = u[2][im];
+
+                    for (int d = 0; d < DIM; d++) {
+                        const double *ud = u[d];
+
+                        double dud_dx = (ud[sp.xp] - ud[sp.xm]) * INV_2DX;
+                        double dud_dy = (ud[sp.yp] - ud[sp.ym]) * INV_2DX;
+                        double dud_dz = (ud[sp.zp] - ud[sp.zm]) * INV_2DX;
+
+                        // same evaluation order as U2advection / U2laplacian
+                        double adv_d = ux * dud_dx + uy * dud_dy + uz * dud_dz;
+                        double lap_d = (ud[sp.xp] - 2. * ud[im] + ud[sp.xm]) * INV_DX2 +
+                                       (ud[sp.yp] - 2. * ud[im] + ud[sp.ym]) * INV_DX2 +
+                                       (ud[sp.zp] - 2. * ud[im] + ud[sp.zm]) * INV_DX2;
+
+                        double us = ud[im];
+                        us -= ab2 ? 0.5 * dt * (3. * adv_d - adv_u_old[d][im]) : dt * adv_d;
+                        us += NU * dt * lap_d;
+                        double f = adv_d - NU * lap_d;
+                        if (stress_u != NULL) {
+                            double st = stress_u[d][im];
+                            us -= ab2 ? 0.5 * dt * (3. * st - stress_u_old[d][im]) : dt * st;
+                            f += st;
+                        }
+
+                        adv_u[d][im]  = adv_d;
+                        u_star[d][im] = us;
+                        force[d][im]  = f;
+                    }
+                }
+            }
+        }
+    }
 
-                double dp_dx = calc_gradient_o2_to_o1(dp, im, 0);
-                double dp_dy = calc_gradient_o2_to_o1(dp, im, 1);
-                double dp_dz = calc_gradient_o2_to_o1(dp, im, 2);
+    // sweep 2: Poisson right-hand side from staggered divergences; u_star is committed to u on the way
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double div_u = calc_gradient_o1_to_o2(u_star[0], sp, 0) +
+                                   calc_gradient_o1_to_o2(u_star[1], sp, 1) +
+                                   calc_gradient_o1_to_o2(u_star[2], sp, 2);
+                    double div_f = calc_gradient_o1_to_o2(force[0], sp, 0) + calc_gradient_o1_to_o2(force[1], sp, 1) +
+                                   calc_gradient_o1_to_o2(force[2], sp, 2);
+
+                    s[im]    = (RHO * INV_DT) * div_u - RHO * div_f;
+                    u[0][im] = u_star[0][im];
+                    u[1][im] = u_star[1][im];
+                    u[2][im] = u_star[2][im];
+                }
+            }
+        }
+    }
+}
 
-                u[0][im] -= dmy * dp_dx;
-                u[1][im] -= dmy * dp_dy;
-                u[2][im] -= dmy * dp_dz;
+void Update_u_pressure(double **u, double *dp, CTime &jikan) {
+    double dmy = jikan.dt_fluid * IRHO;
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double dp_dx = calc_gradient_o2_to_o1(dp, sp, 0);
+                    double dp_dy = calc_gradient_o2_to_o1(dp, sp, 1);
+                    double dp_dz = calc_gradient_o2_to_o1(dp, sp, 2);
+
+                    u[0][im] -= dmy * dp_dx;
+                    u[1][im] -= dmy * dp_dy;
+                    u[2][im] -= dmy * dp_dz;
+                }
             }
         }
     }
@@ -279,19 +350,23 @@ void Update_u_pressure(double **u, double *dp, CTime &jikan) {
 
 void Update_u_pressure_OBL(double **u, double *dp, CTime &jikan, const double degree_oblique) {
     double dmy = jikan.dt_fluid * IRHO;
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
-
-                double dp_dx = calc_gradient_o2_to_o1(dp, im, 0);  // co
-                double dp_dy = calc_gradient_o2_to_o1(dp, im, 1);  // co
-                double dp_dz = calc_gradient_o2_to_o1(dp, im, 2);  // co
-
-                u[0][im] -= dmy * (((1. + degree_oblique * degree_oblique) * dp_dx) - (degree_oblique * dp_dy));
-                u[1][im] -= dmy * (-(degree_oblique * dp_dx) + dp_dy);
-                u[2][im] -= dmy * dp_dz;
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double dp_dx = calc_gradient_o2_to_o1(dp, sp, 0);  // co
+                    double dp_dy = calc_gradient_o2_to_o1(dp, sp, 1);  // co
+                    double dp_dz = calc_gradient_o2_to_o1(dp, sp, 2);  // co
+
+                    u[0][im] -= dmy * (((1. + degree_oblique * degree_oblique) * dp_dx) - (degree_oblique * dp_dy));
+                    u[1][im] -= dmy * (-(degree_oblique * dp_dx) + dp_dy);
+                    u[2][im] -= dmy * dp_dz;
+                }
             }
         }
     }
@@ -373,46 +448,32 @@ void Update_p(double *p, double *dp) {
 
 void U2advection(double **u, double **adv_u) {
     const double INV_2DX = 1. / (2. * DX);
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
-
-                // periodic boundary condition
-                int ip1 = adj(1, i, NX);
-                int jp1 = adj(1, j, NY);
-                int kp1 = adj(1, k, NZ);
-
-                int im1 = adj(-1, i, NX);
-                int jm1 = adj(-1, j, NY);
-                int km1 = adj(-1, k, NZ);
-
-                // set adjacent meshes
-                int im_ip1 = ijk2im(ip1, j, k);
-                int im_jp1 = ijk2im(i, jp1, k);
-                int im_kp1 = ijk2im(i, j, kp1);
-
-                int im_im1 = ijk2im(im1, j, k);
-                int im_jm1 = ijk2im(i, jm1, k);
-                int im_km1 = ijk2im(i, j, km1);
-
-                double dux_dx = (u[0][im_ip1] - u[0][im_im1]) * INV_2DX;
-                double dux_dy = (u[0][im_jp1] - u[0][im_jm1]) * INV_2DX;
-                double dux_dz = (u[0][im_kp1] - u[0][im_km1]) * INV_2DX;
-
-                double duy_dx = (u[1][im_ip1] - u[1][im_im1]) * INV_2DX;
-                double duy_dy = (u[1][im_jp1] - u[1][im_jm1]) * INV_2DX;
-                double duy_dz = (u[1][im_kp1] - u[1][im_km1]) * INV_2DX;
-
-                double duz_dx = (u[2][im_ip1] - u[2][im_im1]) * INV_2DX;
-                double duz_dy = (u[2][im_jp1] - u[2][im_jm1]) * INV_2DX;
-                double duz_dz = (u[2][im_kp1] - u[2][im_km1]) * INV_2DX;
-
-                // non-conservation form
-                adv_u[0][im] = u[0][im] * dux_dx + u[1][im] * dux_dy + u[2][im] * dux_dz;
-                adv_u[1][im] = u[0][im] * duy_dx + u[1][im] * duy_dy + u[2][im] * duy_dz;
-                adv_u[2][im] = u[0][im] * duz_dx + u[1][im] * duz_dy + u[2][im] * duz_dz;
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double dux_dx = (u[0][sp.xp] - u[0][sp.xm]) * INV_2DX;
+                    double dux_dy = (u[0][sp.yp] - u[0][sp.ym]) * INV_2DX;
+                    double dux_dz = (u[0][sp.zp] - u[0][sp.zm]) * INV_2DX;
+
+                    double duy_dx = (u[1][sp.xp] - u[1][sp.xm]) * INV_2DX;
+                    double duy_dy = (u[1][sp.yp] - u[1][sp.ym]) * INV_2DX;
+                    double duy_dz = (u[1][sp.zp] - u[1][sp.zm]) * INV_2DX;
+
+                    double duz_dx = (u[2][sp.xp] - u[2][sp.xm]) * INV_2DX;
+                    double duz_dy = (u[2][sp.yp] - u[2][sp.ym]) * INV_2DX;
+                    double duz_dz = (u[2][sp.zp] - u[2][sp.zm]) * INV_2DX;
+
+                    // non-conservation form
+                    adv_u[0][im] = u[0][im] * dux_dx + u[1][im] * dux_dy + u[2][im] * dux_dz;
+                    adv_u[1][im] = u[0][im] * duy_dx + u[1][im] * duy_dy + u[2][im] * duy_dz;
+                    adv_u[2][im] = u[0][im] * duz_dx + u[1][im] * duz_dy + u[2][im] * duz_dz;
+                }
             }
         }
     }
@@ -420,45 +481,31 @@ void U2advection(double **u, double **adv_u) {
 
 void U2laplacian(double **u, double **lap_u) {
     const double INV_DX2 = 1. / (DX * DX);
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
-
-                // periodic boundary condition
-                int ip1 = adj(1, i, NX);
-                int jp1 = adj(1, j, NY);
-                int kp1 = adj(1, k, NZ);
-
-                int im1 = adj(-1, i, NX);
-                int jm1 = adj(-1, j, NY);
-                int km1 = adj(-1, k, NZ);
-
-                // set adjacent meshes
-                int im_ip1 = ijk2im(ip1, j, k);
-                int im_jp1 = ijk2im(i, jp1, k);
-                int im_kp1 = ijk2im(i, j, kp1);
-
-                int im_im1 = ijk2im(im1, j, k);
-                int im_jm1 = ijk2im(i, jm1, k);
-                int im_km1 = ijk2im(i, j, km1);
-
-                double d2ux_dx2 = (u[0][im_ip1] - 2. * u[0][im] + u[0][im_im1]) * INV_DX2;
-                double d2ux_dy2 = (u[0][im_jp1] - 2. * u[0][im] + u[0][im_jm1]) * INV_DX2;
-                double d2ux_dz2 = (u[0][im_kp1] - 2. * u[0][im] + u[0][im_km1]) * INV_DX2;
-
-                double d2uy_dx2 = (u[1][im_ip1] - 2. * u[1][im] + u[1][im_im1]) * INV_DX2;
-                double d2uy_dy2 = (u[1][im_jp1] - 2. * u[1][im] + u[1][im_jm1]) * INV_DX2;
-                double d2uy_dz2 = (u[1][im_kp1] - 2. * u[1][im] + u[1][im_km1]) * INV_DX2;
-
-                double d2uz_dx2 = (u[2][im_ip1] - 2. * u[2][im] + u[2][im_im1]) * INV_DX2;
-                double d2uz_dy2 = (u[2][im_jp1] - 2. * u[2][im] + u[2][im_jm1]) * INV_DX2;
-                double d2uz_dz2 = (u[2][im_kp1] - 2. * u[2][im] + u[2][im_km1]) * INV_DX2;
-
-                lap_u[0][im] = d2ux_dx2 + d2ux_dy2 + d2ux_dz2;
-                lap_u[1][im] = d2uy_dx2 + d2uy_dy2 + d2uy_dz2;
-                lap_u[2][im] = d2uz_dx2 + d2uz_dy2 + d2uz_dz2;
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double d2ux_dx2 = (u[0][sp.xp] - 2. * u[0][im] + u[0][sp.xm]) * INV_DX2;
+                    double d2ux_dy2 = (u[0][sp.yp] - 2. * u[0][im] + u[0][sp.ym]) * INV_DX2;
+                    double d2ux_dz2 = (u[0][sp.zp] - 2. * u[0][im] + u[0][sp.zm]) * INV_DX2;
+
+                    double d2uy_dx2 = (u[1][sp.xp] - 2. * u[1][im] + u[1][sp.xm]) * INV_DX2;
+                    double d2uy_dy2 = (u[1][sp.yp] - 2. * u[1][im] + u[1][sp.ym]) * INV_DX2;
+                    double d2uy_dz2 = (u[1][sp.zp] - 2. * u[1][im] + u[1][sp.zm]) * INV_DX2;
+
+                    double d2uz_dx2 = (u[2][sp.xp] - 2. * u[2][im] + u[2][sp.xm]) * INV_DX2;
+                    double d2uz_dy2 = (u[2][sp.yp] - 2. * u[2][im] + u[2][sp.ym]) * INV_DX2;
+                    double d2uz_dz2 = (u[2][sp.zp] - 2. * u[2][im] + u[2][sp.zm]) * INV_DX2;
+
+                    lap_u[0][im] = d2ux_dx2 + d2ux_dy2 + d2ux_dz2;
+                    lap_u[1][im] = d2uy_dx2 + d2uy_dy2 + d2uy_dz2;
+                    lap_u[2][im] = d2uz_dx2 + d2uz_dy2 + d2uz_dz2;
+                }
             }
         }
     }
@@ -466,57 +513,35 @@ void U2laplacian(double **u, double **lap_u) {
 
 void U2advection_OBL(double **u, double **adv_u, const double degree_oblique) {
     const double INV_2DX = 1. / (2. * DX);
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
-
-                // periodic boundary condition
-                int ip1 = adj(1, i, NX);
-                int jp1 = adj(1, j, NY);
-                int kp1 = adj(1, k, NZ);
-
-                int im1 = adj(-1, i, NX);
-                int jm1 = adj(-1, j, NY);
-                int km1 = adj(-1, k, NZ);
-
-                // set adjacent meshes
-                int im_ip1 = ijk2im(ip1, j, k);
-                int im_jp1 = ijk2im(i, jp1, k);
-                int im_kp1 = ijk2im(i, j, kp1);
-
-                int im_im1 = ijk2im(im1, j, k);
-                int im_jm1 = ijk2im(i, jm1, k);
-                int im_km1 = ijk2im(i, j, km1);
-
-                double dux_dx = (u[0][im_ip1] - u[0][im_im1]) * INV_2DX;
-                double dux_dy = (u[0][im_jp1] - u[0][im_jm1]) * INV_2DX;
-                double dux_dz = (u[0][im_kp1] - u[0][im_km1]) * INV_2DX;
-
-                double duy_dx = (u[1][im_ip1] - u[1][im_im1]) * INV_2DX;
-                double duy_dy = (u[1][im_jp1] - u[1][im_jm1]) * INV_2DX;
-                double duy_dz = (u[1][im_kp1] - u[1][im_km1]) * INV_2DX;
-
-                double duz_dx = (u[2][im_ip1] - u[2][im_im1]) * INV_2DX;
-                double duz_dy = (u[2][im_jp1] - u[2][im_jm1]) * INV_2DX;
-                double duz_dz = (u[2][im_kp1] - u[2][im_km1]) * INV_2DX;
-
-                // non-conservation form
-                adv_u[0][im] = u[0][im] * dux_dx + u[1][im] * dux_dy + u[2][im] * dux_dz;
-                adv_u[1][im] = u[0][im] * duy_dx + u[1][im] * duy_dy + u[2][im] * duy_dz;
-                adv_u[2][im] = u[0][im] * duz_dx + u[1][im] * duz_dy + u[2][im] * duz_dz;
-            }
-        }
-    }
-
-    // advection of oblique frames
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
-                adv_u[0][im] += 2. * Shear_rate_eff * u[1][im];  // contra
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double dux_dx = (u[0][sp.xp] - u[0][sp.xm]) * INV_2DX;
+                    double dux_dy = (u[0][sp.yp] - u[0][sp.ym]) * INV_2DX;
+                    double dux_dz = (u[0][sp.zp] - u[0][sp.zm]) * INV_2DX;
+
+                    double duy_dx = (u[1][sp.xp] - u[1][sp.xm]) * INV_2DX;
+                    double duy_dy = (u[1][sp.yp] - u[1][sp.ym]) * INV_2DX;
+                    double duy_dz = (u[1][sp.zp] - u[1][sp.zm]) * INV_2DX;
+
+                    double duz_dx = (u[2][sp.xp] - u[2][sp.xm]) * INV_2DX;
+                    double duz_dy = (u[2][sp.yp] - u[2][sp.ym]) * INV_2DX;
+                    double duz_dz = (u[2][sp.zp] - u[2][sp.zm]) * INV_2DX;
+
+                    // non-conservation form
+                    adv_u[0][im] = u[0][im] * dux_dx + u[1][im] * dux_dy + u[2][im] * dux_dz;
+                    adv_u[1][im] = u[0][im] * duy_dx + u[1][im] * duy_dy + u[2][im] * duy_dz;
+                    adv_u[2][im] = u[0][im] * duz_dx + u[1][im] * duz_dy + u[2][im] * duz_dz;
+
+                    // advection of oblique frames
+                    adv_u[0][im] += 2. * Shear_rate_eff * u[1][im];  // contra
+                }
             }
         }
     }
@@ -525,65 +550,84 @@ void U2advection_OBL(double **u, double **adv_u, const double degree_oblique) {
 void U2laplacian_OBL(double **u, double **lap_u, const double degree_oblique) {
     const double INV_DX2  = 1. / (DX * DX);
     const double INV_4DX2 = 1. / (4. * DX * DX);
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
-
-                int ip1 = adj(1, i, NX);
-                int jp1 = adj(1, j, NY);
-                int kp1 = adj(1, k, NZ);
-
-                int im1 = adj(-1, i, NX);
-                int jm1 = adj(-1, j, NY);
-                int km1 = adj(-1, k, NZ);
-
-                // set adjacent meshes
-                int im_ip1 = ijk2im(ip1, j, k);
-                int im_jp1 = ijk2im(i, jp1, k);
-                int im_kp1 = ijk2im(i, j, kp1);
-
-                int im_im1 = ijk2im(im1, j, k);
-                int im_jm1 = ijk2im(i, jm1, k);
-                int im_km1 = ijk2im(i, j, km1);
-
-                int im_ip1_jp1 = ijk2im(ip1, jp1, k);
-                int im_ip1_jm1 = ijk2im(ip1, jm1, k);
-                int im_im1_jp1 = ijk2im(im1, jp1, k);
-                int im_im1_jm1 = ijk2im(im1, jm1, k);
-
-                double d2ux_dx2 = (u[0][im_ip1] - 2. * u[0][im] + u[0][im_im1]) * INV_DX2;
-                double d2ux_dy2 = (u[0][im_jp1] - 2. * u[0][im] + u[0][im_jm1]) * INV_DX2;
-                double d2ux_dz2 = (u[0][im_kp1] - 2. * u[0][im] + u[0][im_km1]) * INV_DX2;
-
-                double d2uy_dx2 = (u[1][im_ip1] - 2. * u[1][im] + u[1][im_im1]) * INV_DX2;
-                double d2uy_dy2 = (u[1][im_jp1] - 2. * u[1][im] + u[1][im_jm1]) * INV_DX2;
-                double d2uy_dz2 = (u[1][im_kp1] - 2. * u[1][im] + u[1][im_km1]) * INV_DX2;
-
-                double d2uz_dx2 = (u[2][im_ip1] - 2. * u[2][im] + u[2][im_im1]) * INV_DX2;
-                double d2uz_dy2 = (u[2][im_jp1] - 2. * u[2][im] + u[2][im_jm1]) * INV_DX2;
-                double d2uz_dz2 = (u[2][im_kp1] - 2. * u[2][im] + u[2][im_km1]) * INV_DX2;
-
-                double d2ux_dxdy =
-                    (u[0][im_ip1_jp1] - u[0][im_ip1_jm1] - u[0][im_im1_jp1] + u[0][im_im1_jm1]) * INV_4DX2;
-                double d2uy_dxdy =
-                    (u[1][im_ip1_jp1] - u[1][im_ip1_jm1] - u[1][im_im1_jp1] + u[1][im_im1_jm1]) * INV_4DX2;
-                double d2uz_dxdy =
-                    (u[2][im_ip1_jp1] - u[2][im_ip1_jm1] - u[2][im_im1_jp1] + u[2][im_im1_jm1]) * INV_4DX2;
-
-                lap_u[0][im] = (1. + degree_oblique * degree_oblique) * d2ux_dx2 - (2. * degree_oblique * d2ux_dxdy) +
-                               d2ux_dy2 + d2ux_dz2;
-                lap_u[1][im] = (1. + degree_oblique * degree_oblique) * d2uy_dx2 - (2. * degree_oblique * d2uy_dxdy) +
-                               d2uy_dy2 + d2uy_dz2;
-                lap_u[2][im] = (1. + degree_oblique * degree_oblique) * d2uz_dx2 - (2. * degree_oblique * d2uz_dxdy) +
-                               d2uz_dy2 + d2uz_dz2;
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    int im_ip1_jp1 = sp.xp + sp.yp - im;
+                    int im_ip1_jm1 = sp.xp + sp.ym - im;
+                    int im_im1_jp1 = sp.xm + sp.yp - im;
+                    int im_im1_jm1 = sp.xm + sp.ym - im;
+
+                    double d2ux_dx2 = (u[0][sp.xp] - 2. * u[0][im] + u[0][sp.xm]) * INV_DX2;
+                    double d2ux_dy2 = (u[0][sp.yp] - 2. * u[0][im] + u[0][sp.ym]) * INV_DX2;
+                    double d2ux_dz2 = (u[0][sp.zp] - 2. * u[0][im] + u[0][sp.zm]) * INV_DX2;
+
+                    double d2uy_dx2 = (u[1][sp.xp] - 2. * u[1][im] + u[1][sp.xm]) * INV_DX2;
+                    double d2uy_dy2 = (u[1][sp.yp] - 2. * u[1][im] + u[1][sp.ym]) * INV_DX2;
+                    double d2uy_dz2 = (u[1][sp.zp] - 2. * u[1][im] + u[1][sp.zm]) * INV_DX2;
+
+                    double d2uz_dx2 = (u[2][sp.xp] - 2. * u[2][im] + u[2][sp.xm]) * INV_DX2;
+                    double d2uz_dy2 = (u[2][sp.yp] - 2. * u[2][im] + u[2][sp.ym]) * INV_DX2;
+                    double d2uz_dz2 = (u[2][sp.zp] - 2. * u[2][im] + u[2][sp.zm]) * INV_DX2;
+
+                    double d2ux_dxdy =
+                        (u[0][im_ip1_jp1] - u[0][im_ip1_jm1] - u[0][im_im1_jp1] + u[0][im_im1_jm1]) * INV_4DX2;
+                    double d2uy_dxdy =
+                        (u[1][im_ip1_jp1] - u[1][im_ip1_jm1] - u[1][im_im1_jp1] + u[1][im_im1_jm1]) * INV_4DX2;
+                    double d2uz_dxdy =
+                        (u[2][im_ip1_jp1] - u[2][im_ip1_jm1] - u[2][im_im1_jp1] + u[2][im_im1_jm1]) * INV_4DX2;
+
+                    lap_u[0][im] = (1. + degree_oblique * degree_oblique) * d2ux_dx2 -
+                                   (2. * degree_oblique * d2ux_dxdy) + d2ux_dy2 + d2ux_dz2;
+                    lap_u[1][im] = (1. + degree_oblique * degree_oblique) * d2uy_dx2 -
+                                   (2. * degree_oblique * d2uy_dxdy) + d2uy_dy2 + d2uy_dz2;
+                    lap_u[2][im] = (1. + degree_oblique * degree_oblique) * d2uz_dx2 -
+                                   (2. * degree_oblique * d2uz_dxdy) + d2uz_dy2 + d2uz_dz2;
+                }
             }
         }
     }
 }
 
+void Init_stencil(void) {
+    stencil.xp = alloc_1d_int(NX);
+    stencil.xm = alloc_1d_int(NX);
+    stencil.yp = alloc_1d_int(NY);
+    stencil.ym = alloc_1d_int(NY);
+    stencil.zp = alloc_1d_int(NZ);
+    stencil.zm = alloc_1d_int(NZ);
+    for (int i = 0; i < NX; i++) {
+        stencil.xp[i] = (adj(1, i, NX) - i) * NY * NZ_;
+        stencil.xm[i] = (adj(-1, i, NX) - i) * NY * NZ_;
+    }
+    for (int j = 0; j < NY; j++) {
+        stencil.yp[j] = (adj(1, j, NY) - j) * NZ_;
+        stencil.ym[j] = (adj(-1, j, NY) - j) * NZ_;
+    }
+    for (int k = 0; k < NZ; k++) {
+        stencil.zp[k] = adj(1, k, NZ) - k;
+        stencil.zm[k] = adj(-1, k, NZ) - k;
+    }
+}
+
+void Free_stencil(void) {
+    free_1d_int(stencil.xp);
+    free_1d_int(stencil.xm);
+    free_1d_int(stencil.yp);
+    free_1d_int(stencil.ym);
+    free_1d_int(stencil.zp);
+    free_1d_int(stencil.zm);
+}
+
 void Mem_alloc_fdm(void) {
+    Init_stencil();
+
     adv   = alloc_2d_double(DIM, NX * NY * NZ_);
     adv_o = calloc_2d_double(DIM, NX * NY * NZ_);
     lap   = alloc_2d_double(DIM, NX * NY * NZ_);
@@ -618,6 +662,8 @@ void Mem_alloc_fdm(void) {
 }
 
 void Free_fdm(void) {
+    Free_stencil();
+
     free_2d_double(adv);
     free_2d_double(adv_o);
     free_2d_double(lap);
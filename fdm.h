@@ -92,6 +92,40 @@ inline int ijk2idx(int i, int j, int k) {
     return i * (NY * NZ) + j * NZ + k;
 }
 
+// Stencil engine: periodic neighbour offsets are tabulated once per axis (Init_stencil), so a grid point and its
+// six face neighbours are found with table lookups instead of adj()/im2ijk() per access. Sweeps walk j-tiles of
+// STENCIL_TILE_J rows with i innermost of the tile loops, so the i-1, i, i+1 planes of a tile stay in cache.
+const int STENCIL_TILE_J = 8;
+
+struct Stencil_table {
+    int *xp, *xm;  // im(i +- 1, j, k) - im(i, j, k)
+    int *yp, *ym;  // im(i, j +- 1, k) - im(i, j, k)
+    int *zp, *zm;  // im(i, j, k +- 1) - im(i, j, k)
+};
+extern Stencil_table stencil;
+
+struct Stencil_point {
+    int im;
+    int xp, xm, yp, ym, zp, zm;  // linear indices of the six periodic face neighbours
+};
+
+inline Stencil_point stencil_point(int i, int j, int k) {
+    Stencil_point sp;
+    sp.im = (i * NY * NZ_) + (j * NZ_) + k;
+    sp.xp = sp.im + stencil.xp[i];
+    sp.xm = sp.im + stencil.xm[i];
+    sp.yp = sp.im + stencil.yp[j];
+    sp.ym = sp.im + stencil.ym[j];
+    sp.zp = sp.im + stencil.zp[k];
+    sp.zm = sp.im + stencil.zm[k];
+    return sp;
+}
+
+inline int stencil_tile_end(int jb) { return (jb + STENCIL_TILE_J < NY) ? jb + STENCIL_TILE_J : NY; }
+
+void Init_stencil(void);
+void Free_stencil(void);
+
 inline double calc_gradient_o1_to_o1(const double *field, int im, int dir) {
     const double INV_2DX = 1. / (2. * DX);
     int          i, j, k;
@@ -286,6 +320,90 @@ inline double calc_laplacian_OBL(const double *field, int im, const double degre
     return (1. + degree_oblique * degree_oblique) * x_dir - (2. * degree_oblique * mixed_deriv) + y_dir + z_dir;
 }
 
+// Stencil_point overloads of the operators above; same arithmetic, bit-identical results
+inline double calc_gradient_o1_to_o1(const double *field, const Stencil_point &sp, int dir) {
+    const double INV_2DX = 1. / (2. * DX);
+    switch (dir) {
+        case 0:
+            return (field[sp.xp] - field[sp.xm]) * INV_2DX;
+        case 1:
+            return (field[sp.yp] - field[sp.ym]) * INV_2DX;
+        default:
+            return (field[sp.zp] - field[sp.zm]) * INV_2DX;
+    }
+}
+
+inline double calc_gradient_o1_to_o2(const double *field, const Stencil_point &sp, int dir) {
+    const double INV_4DX = 1. / (4. * DX);
+    const int    im      = sp.im;
+    const int    im_ij   = sp.xp + sp.yp - im;
+    const int    im_ik   = sp.xp + sp.zp - im;
+    const int    im_jk   = sp.yp + sp.zp - im;
+    const int    im_ijk  = im_ij + sp.zp - im;
+    switch (dir) {
+        case 0:
+            return (field[im_ijk] - field[im_jk] + field[im_ij] - field[sp.yp] + field[im_ik] - field[sp.zp] +
+                    field[sp.xp] - field[im]) *
+                   INV_4DX;
+        case 1:
+            return (field[im_ijk] - field[im_ik] + field[im_ij] - field[sp.xp] + field[im_jk] - field[sp.zp] +
+                    field[sp.yp] - field[im]) *
+                   INV_4DX;
+        default:
+            return (field[im_ijk] - field[im_ij] + field[im_ik] - field[sp.xp] + field[im_jk] - field[sp.yp] +
+                    field[sp.zp] - field[im]) *
+                   INV_4DX;
+    }
+}
+
+inline double calc_gradient_o2_to_o1(const double *field, const Stencil_point &sp, int dir) {
+    const double INV_4DX = 1. / (4. * DX);
+    const int    im      = sp.im;
+    const int    im_ij   = sp.xm + sp.ym - im;
+    const int    im_ik   = sp.xm + sp.zm - im;
+    const int    im_jk   = sp.ym + sp.zm - im;
+    const int    im_ijk  = im_ij + sp.zm - im;
+    switch (dir) {
+        case 0:
+            return (field[im] - field[sp.xm] + field[sp.ym] - field[im_ij] + field[sp.zm] - field[im_ik] +
+                    field[im_jk] - field[im_ijk]) *
+                   INV_4DX;
+        case 1:
+            return (field[im] - field[sp.ym] + field[sp.xm] - field[im_ij] + field[sp.zm] - field[im_jk] +
+                    field[im_ik] - field[im_ijk]) *
+                   INV_4DX;
+        default:
+            return (field[im] - field[sp.zm] + field[sp.xm] - field[im_ik] + field[sp.ym] - field[im_jk] +
+                    field[im_ij] - field[im_ijk]) *
+                   INV_4DX;
+    }
+}
+
+inline double calc_laplacian(const double *field, const Stencil_point &sp) {
+    const double INV_DX2 = 1. / (DX * DX);
+
+    double x_dir = (field[sp.xp] - 2. * field[sp.im] + field[sp.xm]);
+    double y_dir = (field[sp.yp] - 2. * field[sp.im] + field[sp.ym]);
+    double z_dir = (field[sp.zp] - 2. * field[sp.im] + field[sp.zm]);
+
+    return (x_dir + y_dir + z_dir) * INV_DX2;
+}
+
+inline double calc_laplacian_OBL(const double *field, const Stencil_point &sp, const double degree_oblique) {
+    const double INV_DX2  = 1. / (DX * DX);
+    const double INV_4DX2 = 1. / (4. * DX * DX);
+
+    double x_dir = (field[sp.xp] - 2. * field[sp.im] + field[sp.xm]) * INV_DX2;
+    double y_dir = (field[sp.yp] - 2. * field[sp.im] + field[sp.ym]) * INV_DX2;
+    double z_dir = (field[sp.zp] - 2. * field[sp.im] + field[sp.zm]) * INV_DX2;
+
+    double mixed_deriv = (field[sp.xp + sp.yp - sp.im] - field[sp.xp + sp.ym - sp.im] -
+                          field[sp.xm + sp.yp - sp.im] + field[sp.xm + sp.ym - sp.im]) *
+                         INV_4DX2;
+
+    return (1. + degree_oblique * degree_oblique) * x_dir - (2. * degree_oblique * mixed_deriv) + y_dir + z_dir;
+}
+
 inline double calc_gradient_norm(double *phi, int im) {
     double dphi_dx = calc_gradient_o1_to_o1(phi, im, 0);
     double dphi_dy = calc_gradient_o1_to_o1(phi, im, 1);
@@ -341,6 +459,12 @@ inline void Cpy_v3(double **dst, double **src) {
         }
     }
 }
+// exchange two vector-field buffers (AB2 history rotation without copying)
+inline void Swap_v3(double **&a, double **&b) {
+    double **tmp = a;
+    a            = b;
+    b            = tmp;
+}
 inline void Cpy_v1(double *dst, double *src) {
     int im;
 #pragma omp parallel for private(im)
@@ -355,21 +479,24 @@ inline void Cpy_v1(double *dst, double *src) {
 }
 inline void Set_poisson_rhs_sub(double **u, double **dmy, double *s, CTime &jikan) {
     const double INV_DT = 1. / jikan.dt_fluid;
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
 
-                double dux_dx = calc_gradient_o1_to_o2(u[0], im, 0);
-                double duy_dy = calc_gradient_o1_to_o2(u[1], im, 1);
-                double duz_dz = calc_gradient_o1_to_o2(u[2], im, 2);
+                    double dux_dx = calc_gradient_o1_to_o2(u[0], sp, 0);
+                    double duy_dy = calc_gradient_o1_to_o2(u[1], sp, 1);
+                    double duz_dz = calc_gradient_o1_to_o2(u[2], sp, 2);
 
-                double drx_dx = calc_gradient_o1_to_o2(dmy[0], im, 0);
-                double dry_dy = calc_gradient_o1_to_o2(dmy[1], im, 1);
-                double drz_dz = calc_gradient_o1_to_o2(dmy[2], im, 2);
+                    double drx_dx = calc_gradient_o1_to_o2(dmy[0], sp, 0);
+                    double dry_dy = calc_gradient_o1_to_o2(dmy[1], sp, 1);
+                    double drz_dz = calc_gradient_o1_to_o2(dmy[2], sp, 2);
 
-                s[im] = (RHO * INV_DT) * (dux_dx + duy_dy + duz_dz) - RHO * (drx_dx + dry_dy + drz_dz);
+                    s[sp.im] = (RHO * INV_DT) * (dux_dx + duy_dy + duz_dz) - RHO * (drx_dx + dry_dy + drz_dz);
+                }
             }
         }
     }
@@ -618,9 +745,6 @@ inline void Reset_A_OBL(double *a, double const *acp, const int &flg) {
     }
 }
 inline void Spline_A_oblique_transform(double *a, const OBL_TRANSFORM &flag) {
-    int    im;
-    double dmy_x;
-    double delta_y;
     double sign;
     if (flag == oblique2cartesian) {
         sign = -1.0;
@@ -630,7 +754,8 @@ inline void Spline_A_oblique_transform(double *a, const OBL_TRANSFORM &flag) {
         exit_job(EXIT_FAILURE);
     }
 
-#pragma omp parallel for private(im, dmy_x, delta_y)
+    // batched over the NZ lines of each y-plane, see Spline_u_oblique_transform
+#pragma omp parallel for
     for (int j = 0; j < NY; j++) {  // original coord
         int np;
 #ifndef _OPENMP
@@ -638,33 +763,65 @@ inline void Spline_A_oblique_transform(double *a, const OBL_TRANSFORM &flag) {
 #else
         np = omp_get_thread_num();
 #endif
-        splineSystem *spl = splineOblique[np];
-        double **     us0 = uspline[np];
-
-        delta_y = (double)(j - NY / 2) * DX;
+        splineBatch *spl     = splineOblique[np];
+        double *     us      = uspline[np];
+        double       delta_y = (double)(j - NY / 2) * DX;
+
+        // setup interpolation grid
+        for (int i = 0; i < NX; i++) {  // original coord
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+            double *  a0  = spl->a + i * NZ;
+#pragma omp simd
+            for (int k = 0; k < NZ; k++) a0[k] = a[im0 + k];
+        }  // i
+
+        // compute interpolated points
+        splineBatchCompute(spl, NZ);
+        for (int i = 0; i < NX; i++) {  // transformed coord
+            const int    im0   = (i * NY * NZ_) + (j * NZ_);
+            const double dmy_x = fmod(i * DX + sign * degree_oblique * delta_y + 4.0 * LX, LX);  // original coord
+
+            splineBatchFx(spl, NZ, dmy_x, us);
+#pragma omp simd
+            for (int k = 0; k < NZ; k++) a[im0 + k] = us[k];
+        }  // i
+    }      // j
+}
 
-        for (int k = 0; k < NZ; k++) {  // original coord
+inline void Spectral_A_oblique_transform(double *a, const OBL_TRANSFORM &flag) {
+    double sign;
+    if (flag == oblique2cartesian) {
+        sign = -1.0;
+    } else if (flag == cartesian2oblique) {
+        sign = 1.0;
+    } else {
+        exit_job(EXIT_FAILURE);
+    }
 
-            // setup interpolation grid
-            for (int i = 0; i < NX; i++) {  // original coord
-                im    = (i * NY * NZ_) + (j * NZ_) + k;
-                dmy_x = fmod(i * DX - sign * degree_oblique * delta_y + 4.0 * LX, LX);  // transformed coord
+    // see Spectral_u_oblique_transform
+#pragma omp parallel for
+    for (int j = 0; j < NY; j++) {  // original coord
+        int np;
+#ifndef _OPENMP
+        np = 0;
+#else
+        np = omp_get_thread_num();
+#endif
+        double *buf     = uspectral[np];
+        double  delta_y = (double)(j - NY / 2) * DX;
 
-                // velocity components in transformed basis defined over
-                // original grid points x0
-                us0[0][i] = a[im];
-            }  // i
+        for (int i = 0; i < NX; i++) {  // original coord
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+            for (int k = 0; k < NZ; k++) buf[k * NX + i] = a[im0 + k];
+        }  // i
 
-            // compute interpolated points
-            splineCompute(spl, us0[0]);
-            for (int i = 0; i < NX; i++) {  // transformed coord
-                im    = (i * NY * NZ_) + (j * NZ_) + k;
-                dmy_x = fmod(i * DX + sign * degree_oblique * delta_y + 4.0 * LX, LX);  // original coord
+        Phase_shift_lines(buf, NZ, sign * degree_oblique * delta_y, buf + NZ * NX);
 
-                a[im] = splineFx(spl, dmy_x);
-            }  // i
-        }      // k
-    }          // j
+        for (int i = 0; i < NX; i++) {  // transformed coord
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+            for (int k = 0; k < NZ; k++) a[im0 + k] = buf[k * NX + i];
+        }  // i
+    }      // j
 }
 
 inline void Transform_obl_a(double *a, const OBL_TRANSFORM &flag) {
@@ -678,6 +835,8 @@ inline void Transform_obl_a(double *a, const OBL_TRANSFORM &flag) {
         }
     } else if (SW_OBL_INT == spline_int) {
         Spline_A_oblique_transform(a, flag);
+    } else if (SW_OBL_INT == spectral_int) {
+        Spectral_A_oblique_transform(a, flag);
     } else {
         exit_job(EXIT_FAILURE);
     }
@@ -789,6 +948,16 @@ void NS_solver_slavedEuler_Shear_OBL_implicit(double **&u, double *Pressure, Par
 
 void Set_poisson_rhs(double **u, double **adv_u, double **lap_u, double *s, CTime &jikan);
 
+// explicit advection/viscous(/stress) update of u and Poisson right-hand side in two fused sweeps;
+// stress_u may be NULL
+void Update_u_explicit_fused(double **u,
+                             double **adv_u,
+                             double **adv_u_old,
+                             double **stress_u,
+                             double **stress_u_old,
+                             double * s,
+                             CTime &  jikan);
+
 void Update_u_pressure(double **u, double *dp, CTime &jikan);
 void Update_u_pressure_OBL(double **u, double *dp, CTime &jikan, const double degree_oblique);
 
@@ -1,5 +1,7 @@
 #include "fdm_matrix_solver.h"
 
+#include "Matrix_Inverse.h"
+
 #ifdef _LIS_SOLVER
 LIS_INT *   ptr_ns, *idx_ns_csr;
 LIS_SCALAR *val_ns_csr;
@@ -15,29 +17,24 @@ LIS_VECTOR  b_ch, x_ch;
 LIS_SOLVER  lis_solver_ch;
 LIS_INT     is_ch, ie_ch;
 #else
-int *         idx_ns_csr;
-int *         ptr_ns;
-double *      val_ns_csr;
 double *      b_ns;
 work_bicgstab wm_ns;
 
 int *         idx_ch_csr;
-int *         ptr_ch;
 double *      val_ch_csr;
 double *      b_ch;
 work_bicgstab wm_ch;
 #endif
 
 void NS_MAC_solver_implicit(double **u, double *pressure, double **u_s, const CTime &jikan, int is_ns, int ie_ns) {
+    const double _2DX = 2. * DX;
+    const int    nval = NX * NY * NZ * DIM;
 #ifdef _LIS_SOLVER
-    LIS_INT iter;
-#endif
+    LIS_INT      iter;
     const double DX2      = DX * DX;
-    const double _2DX     = 2. * DX;
-    const double INV_DX   = 1. / DX;
     const double INV_4DX  = 1. / (4. * DX);
     const double INV_2DX2 = 1. / (2. * DX2);
-    const int    nval     = NX * NY * NZ * DIM;
+
 #pragma omp parallel for
     for (int idx = is_ns; idx < ie_ns; idx++) {
         int i, j, k, d;
@@ -78,6 +75,7 @@ void NS_MAC_solver_implicit(double **u, double *pressure, double **u_s, const CT
         ptr_ns[idx - is_ns + 1] = idx2 + 7;
     }
     ptr_ns[0] = 0;
+#endif
 
     // const vector
 #pragma omp parallel for
@@ -141,7 +139,9 @@ void NS_MAC_solver_implicit(double **u, double *pressure, double **u_s, const CT
     //	printf("%d NS matrix solver iter = %d\n", jikan.ts, iter);
     //}
 #else
-    bicgstab(idx_ns_csr, val_ns_csr, ptr_ns, b_ns, wm_ns, nval);
+    const ns_stencil A = {u_s, NULL, 1. / jikan.dt_fluid, 0., false, NX, NY, NZ, NZ_, DX, -1};
+    Set_initial_guess(u, DIM, wm_ns);
+    bicgstab(A, b_ns, wm_ns, nval);
 #endif
     // set solutions
 #pragma omp parallel for
@@ -164,15 +164,14 @@ void CHNS_MAC_solver_implicit(double **    u,
                               const CTime &jikan,
                               int          is_ns,
                               int          ie_ns) {
+    const double _2DX = 2. * DX;
+    const int    nval = NX * NY * NZ * DIM;
 #ifdef _LIS_SOLVER
-    LIS_INT iter;
-#endif
+    LIS_INT      iter;
     const double DX2      = DX * DX;
-    const double _2DX     = 2. * DX;
-    const double INV_DX   = 1. / DX;
     const double INV_4DX  = 1. / (4. * DX);
     const double INV_2DX2 = 1. / (2. * DX2);
-    const int    nval     = NX * NY * NZ * DIM;
+
 #pragma omp parallel for
     for (int idx = is_ns; idx < ie_ns; idx++) {
         int i, j, k, d;
@@ -213,6 +212,7 @@ void CHNS_MAC_solver_implicit(double **    u,
         ptr_ns[idx - is_ns + 1] = idx2 + 7;
     }
     ptr_ns[0] = 0;
+#endif
 
     // const vector
 #pragma omp parallel for
@@ -236,7 +236,7 @@ void CHNS_MAC_solver_implicit(double **    u,
 
         double pressure_term  = -IRHO * calc_gradient_o2_to_o1(pressure, im, d);
         double viscosity_term = 0.5 * NU * calc_laplacian(u[d], im);
-        double stress_term    = -stress[d][im];
+        double stress_term    = -stress_s[d][im];
         double bs             = u[d][im] / jikan.dt_fluid + adv_term + pressure_term + viscosity_term + stress_term;
 #ifdef _LIS_SOLVER
         lis_vector_set_value(LIS_INS_VALUE, idx, bs, b_ns);
@@ -251,7 +251,9 @@ void CHNS_MAC_solver_implicit(double **    u,
     lis_matrix_assemble(A_ns);
     lis_solve(A_ns, b_ns, x_ns, lis_solver_ns);
 #else
-    bicgstab(idx_ns_csr, val_ns_csr, ptr_ns, b_ns, wm_ns, nval);
+    const ns_stencil A = {u_s, NULL, 1. / jikan.dt_fluid, 0., false, NX, NY, NZ, NZ_, DX, -1};
+    Set_initial_guess(u, DIM, wm_ns);
+    bicgstab(A, b_ns, wm_ns, nval);
 #endif
     // set solutions
 #pragma omp parallel for
@@ -275,18 +277,17 @@ void CHNS_MAC_solver_implicit_viscosity(double **    u,
                                         const CTime &jikan,
                                         int          is_ns,
                                         int          ie_ns) {
+    const double _2DX    = 2. * DX;
+    const double INV_2DX = 1. / _2DX;
+    const double INV_DT  = 1. / jikan.dt_fluid;
+    const int    nval    = NX * NY * NZ * DIM;
 #ifdef _LIS_SOLVER
-    LIS_INT iter;
-#endif
+    LIS_INT      iter;
     const double DX2      = DX * DX;
-    const double _2DX     = 2. * DX;
-    const double INV_DX   = 1. / DX;
-    const double INV_2DX  = 1. / _2DX;
     const double INV_DX2  = 1. / DX2;
     const double INV_4DX  = 1. / (4. * DX);
     const double INV_2DX2 = 1. / (2. * DX2);
-    const double INV_DT   = 1. / jikan.dt_fluid;
-    const int    nval     = NX * NY * NZ * DIM;
+
 #pragma omp parallel for
     for (int idx = is_ns; idx < ie_ns; idx++) {
         int i, j, k, d;
@@ -391,6 +392,7 @@ void CHNS_MAC_solver_implicit_viscosity(double **    u,
         ptr_ns[idx - is_ns + 1] = idx2 + 11;
     }
     ptr_ns[0] = 0;
+#endif
 
     // const vector
 #pragma omp parallel for
@@ -443,7 +445,7 @@ void CHNS_MAC_solver_implicit_viscosity(double **    u,
         }
         vt *= IRHO;
 
-        double stress_term = -stress[d][im];
+        double stress_term = -stress_s[d][im];
         double bs          = u[d][im] * INV_DT + adv_term + pressure_term + viscosity_term + vt + stress_term;
 #ifdef _LIS_SOLVER
         lis_vector_set_value(LIS_INS_VALUE, idx, bs, b_ns);
@@ -458,7 +460,9 @@ void CHNS_MAC_solver_implicit_viscosity(double **    u,
     lis_matrix_assemble(A_ns);
     lis_solve(A_ns, b_ns, x_ns, lis_solver_ns);
 #else
-    bicgstab(idx_ns_csr, val_ns_csr, ptr_ns, b_ns, wm_ns, nval);
+    const ns_stencil A = {u_s, eta_s, INV_DT, 0., false, NX, NY, NZ, NZ_, DX, -1};
+    Set_initial_guess(u, DIM, wm_ns);
+    bicgstab(A, b_ns, wm_ns, nval);
 #endif
     // set solutions
 #pragma omp parallel for
@@ -481,19 +485,19 @@ void NS_MAC_solver_implicit_OBL(double **    u,
                                 const double degree_oblique,
                                 int          is_ns,
                                 int          ie_ns) {
+    const double _2DX = 2. * DX;
+    const int    nval = NX * NY * NZ * DIM;
 #ifdef _LIS_SOLVER
-    LIS_INT iter;
-#endif
+    LIS_INT      iter;
     const double DX2      = DX * DX;
-    const double _2DX     = 2. * DX;
-    const double INV_DX   = 1. / DX;
     const double INV_4DX  = 1. / (4. * DX);
     const double INV_2DX2 = 1. / (2. * DX2);
     const double INV_4DX2 = 1. / (4. * DX2);
-    const int    nval     = NX * NY * NZ * DIM;
+#endif
 
     const double gt = degree_oblique + Shear_rate_eff * jikan.hdt_fluid;
 
+#ifdef _LIS_SOLVER
 #pragma omp parallel for
     for (int idx = is_ns; idx < ie_ns; idx++) {
         int i, j, k, d;
@@ -549,6 +553,7 @@ void NS_MAC_solver_implicit_OBL(double **    u,
         ptr_ns[idx - is_ns + 1] = idx2 + 12;
     }
     ptr_ns[0] = 0;
+#endif
 
     // const vector
 #pragma omp parallel for
@@ -606,7 +611,9 @@ void NS_MAC_solver_implicit_OBL(double **    u,
     lis_matrix_assemble(A_ns);
     lis_solve(A_ns, b_ns, x_ns, lis_solver_ns);
 #else
-    bicgstab(idx_ns_csr, val_ns_csr, ptr_ns, b_ns, wm_ns, nval);
+    const ns_stencil A = {u_s, NULL, 1. / jikan.dt_fluid, gt, true, NX, NY, NZ, NZ_, DX, -1};
+    Set_initial_guess(u, DIM, wm_ns);
+    bicgstab(A, b_ns, wm_ns, nval);
 #endif
     // set solutions
 #pragma omp parallel for
@@ -630,19 +637,19 @@ void CHNS_MAC_solver_implicit_OBL(double **    u,
                                   const double degree_oblique,
                                   int          is_ns,
                                   int          ie_ns) {
+    const double _2DX = 2. * DX;
+    const int    nval = NX * NY * NZ * DIM;
 #ifdef _LIS_SOLVER
-    LIS_INT iter;
-#endif
+    LIS_INT      iter;
     const double DX2      = DX * DX;
-    const double _2DX     = 2. * DX;
-    const double INV_DX   = 1. / DX;
     const double INV_4DX  = 1. / (4. * DX);
     const double INV_2DX2 = 1. / (2. * DX2);
     const double INV_4DX2 = 1. / (4. * DX2);
-    const int    nval     = NX * NY * NZ * DIM;
+#endif
 
     const double gt = degree_oblique + Shear_rate_eff * jikan.hdt_fluid;
 
+#ifdef _LIS_SOLVER
 #pragma omp parallel for
     for (int idx = is_ns; idx < ie_ns; idx++) {
         int i, j, k, d;
@@ -698,6 +705,7 @@ void CHNS_MAC_solver_implicit_OBL(double **    u,
         ptr_ns[idx - is_ns + 1] = idx2 + 12;
     }
     ptr_ns[0] = 0;
+#endif
 
     // const vector
 #pragma omp parallel for
@@ -738,7 +746,7 @@ void CHNS_MAC_solver_implicit_OBL(double **    u,
         pressure_term *= IRHO;
 
         double viscosity_term = 0.5 * NU * calc_laplacian_OBL(u[d], im, gt);
-        double stress_term    = -stress[d][im];
+        double stress_term    = -stress_s[d][im];
         double adv_frame_term = (d == 0) ? -Shear_rate_eff * u[1][im] : 0.;
         double bs =
             u[d][im] / jikan.dt_fluid + adv_term + pressure_term + viscosity_term + adv_frame_term + stress_term;
@@ -756,7 +764,9 @@ void CHNS_MAC_solver_implicit_OBL(double **    u,
     lis_matrix_assemble(A_ns);
     lis_solve(A_ns, b_ns, x_ns, lis_solver_ns);
 #else
-    bicgstab(idx_ns_csr, val_ns_csr, ptr_ns, b_ns, wm_ns, nval);
+    const ns_stencil A = {u_s, NULL, 1. / jikan.dt_fluid, gt, true, NX, NY, NZ, NZ_, DX, -1};
+    Set_initial_guess(u, DIM, wm_ns);
+    bicgstab(A, b_ns, wm_ns, nval);
 #endif
     // set solutions
 #pragma omp parallel for
@@ -781,19 +791,18 @@ void CHNS_MAC_solver_implicit_viscosity_OBL(double **    u,
                                             const double degree_oblique,
                                             int          is_ns,
                                             int          ie_ns) {
+    const double _2DX    = 2. * DX;
+    const double INV_2DX = 1. / _2DX;
+    const double INV_DT  = 1. / jikan.dt_fluid;
+    const int    nval    = NX * NY * NZ * DIM;
 #ifdef _LIS_SOLVER
-    LIS_INT iter;
-#endif
+    LIS_INT      iter;
     const double DX2      = DX * DX;
-    const double _2DX     = 2. * DX;
-    const double INV_DX   = 1. / DX;
-    const double INV_2DX  = 1. / _2DX;
     const double INV_DX2  = 1. / DX2;
     const double INV_4DX  = 1. / (4. * DX);
     const double INV_2DX2 = 1. / (2. * DX2);
     const double INV_4DX2 = 1. / (4. * DX2);
-    const double INV_DT   = 1. / jikan.dt_fluid;
-    const int    nval     = NX * NY * NZ * DIM;
+#endif
 
     const double gt = degree_oblique + Shear_rate_eff * jikan.hdt_fluid;
 
@@ -803,6 +812,7 @@ void CHNS_MAC_solver_implicit_viscosity_OBL(double **    u,
     const double g22 = 1.;
     const double g33 = 1.;
 
+#ifdef _LIS_SOLVER
 #pragma omp parallel for
     for (int idx = is_ns; idx < ie_ns; idx++) {
         int i, j, k, d;
@@ -975,6 +985,7 @@ void CHNS_MAC_solver_implicit_viscosity_OBL(double **    u,
         ptr_ns[idx - is_ns + 1] = idx2 + 20;
     }
     ptr_ns[0] = 0;
+#endif
 
     // const vector
 #pragma omp parallel for
@@ -1050,7 +1061,7 @@ void CHNS_MAC_solver_implicit_viscosity_OBL(double **    u,
         }
         vt *= 0.5 * IRHO;
 
-        double stress_term    = -stress[d][im];
+        double stress_term    = -stress_s[d][im];
         double adv_frame_term = (d == 0) ? -Shear_rate_eff * u[1][im] : 0.;
         double bs = u[d][im] * INV_DT + adv_term + pressure_term + viscosity_term + vt + adv_frame_term + stress_term;
 
@@ -1067,7 +1078,9 @@ void CHNS_MAC_solver_implicit_viscosity_OBL(double **    u,
     lis_matrix_assemble(A_ns);
     lis_solve(A_ns, b_ns, x_ns, lis_solver_ns);
 #else
-    bicgstab(idx_ns_csr, val_ns_csr, ptr_ns, b_ns, wm_ns, nval);
+    const ns_stencil A = {u_s, eta_s, INV_DT, gt, true, NX, NY, NZ, NZ_, DX, -1};
+    Set_initial_guess(u, DIM, wm_ns);
+    bicgstab(A, b_ns, wm_ns, nval);
 #endif
     // set solutions
 #pragma omp parallel for
@@ -1083,6 +1096,59 @@ void CHNS_MAC_solver_implicit_viscosity_OBL(double **    u,
     }
 }
 
+// (di, dj, dk) of each column of the CH rows, in the order the assembly routines fill them
+static const int ch_offset_25[25][DIM] = {
+    {0, 0, 0}, {2, 0, 0}, {-2, 0, 0}, {0, 2, 0}, {0, -2, 0}, {0, 0, 2}, {0, 0, -2}, {0, 1, 1}, {0, 1, -1}, {0, -1, 1},
+    {0, -1, -1}, {1, 0, 1}, {1, 0, -1}, {-1, 0, 1}, {-1, 0, -1}, {1, 1, 0}, {1, -1, 0}, {-1, 1, 0}, {-1, -1, 0},
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+static const int ch_offset_43[43][DIM] = {
+    {0, 0, 0}, {2, 0, 0}, {-2, 0, 0}, {0, 2, 0}, {0, -2, 0}, {0, 0, 2}, {0, 0, -2}, {0, 1, 1}, {0, 1, -1}, {0, -1, 1},
+    {0, -1, -1}, {1, 0, 1}, {1, 0, -1}, {-1, 0, 1}, {-1, 0, -1}, {1, 1, 0}, {1, -1, 0}, {-1, 1, 0}, {-1, -1, 0},
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {1, 1, -1}, {1, -1, 1}, {1, -1, -1},
+    {-1, 1, 1}, {-1, 1, -1}, {-1, -1, 1}, {2, -1, 0}, {-2, 1, 0}, {2, 0, -1}, {-2, 0, 1}, {1, -2, 0}, {-1, 2, 0},
+    {0, 2, -1}, {0, -2, 1}, {-1, 0, 2}, {1, 0, -2}, {0, -1, 2}, {0, 1, -2}};
+static const int ch_offset_45[45][DIM] = {
+    {0, 0, 0}, {2, 0, 0}, {-2, 0, 0}, {0, 2, 0}, {0, -2, 0}, {0, 0, 2}, {0, 0, -2}, {0, 1, 1}, {0, 1, -1}, {0, -1, 1},
+    {0, -1, -1}, {1, 0, 1}, {1, 0, -1}, {-1, 0, 1}, {-1, 0, -1}, {1, 1, 0}, {1, -1, 0}, {-1, 1, 0}, {-1, -1, 0},
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {1, 1, 1}, {1, 1, -1}, {-1, -1, 1},
+    {-1, -1, -1}, {1, 2, 0}, {-1, -2, 0}, {1, -1, 1}, {1, -1, -1}, {-1, 1, 1}, {-1, 1, -1}, {1, -2, 0}, {-1, 2, 0},
+    {2, 1, 0}, {-2, -1, 0}, {2, -1, 0}, {-2, 1, 0}, {2, 2, 0}, {-2, -2, 0}, {2, -2, 0}, {-2, 2, 0}};
+
+// fixed number of entries per CH row: 25 (constant mobility), 43 (psi_dry), 45 (Lees-Edwards)
+static int Ch_row_width(void) {
+    if (SW_EQ == Shear_NS_LE_CH_FDM) {
+        return 45;
+    }
+    return (ps.psi_dry != 0.0) ? 43 : 25;
+}
+
+/*!
+  \brief Column indices of the CH rows is...ie-1, in SELL-C order (CSR when SELL_C == 1)
+  \details The pattern depends on the mesh only, so it is built once; the assembly routines fill val_ch_csr at the
+  same positions every step. Padding rows of the last slice keep column 0 and value 0.
+ */
+static void Set_ch_pattern(int is, int ie) {
+    const int width = Ch_row_width();
+
+    const int(*off)[DIM] = (width == 45) ? ch_offset_45 : ((width == 43) ? ch_offset_43 : ch_offset_25);
+#pragma omp parallel for
+    for (int idx = is; idx < ie; idx++) {
+        int i, j, k;
+        idx2ijk(idx, &i, &j, &k);
+        int idx2 = sell_offset(idx - is, width);
+        for (int q = 0; q < width; q++) {
+            idx_ch_csr[idx2 + SELL_C * q] =
+                ijk2idx(adj(off[q][0], i, NX), adj(off[q][1], j, NY), adj(off[q][2], k, NZ));
+        }
+#ifdef _LIS_SOLVER
+        ptr_ch[idx - is + 1] = idx2 + width;
+#endif
+    }
+#ifdef _LIS_SOLVER
+    ptr_ch[0] = 0;
+#endif
+}
+
 void CH_solver_implicit_euler(double *     psi,
                               double *     psi_all,
                               double *     psi_o,
@@ -1119,8 +1185,8 @@ void CH_solver_implicit_euler(double *     psi,
             int i, j, k;
             idx2ijk(idx, &i, &j, &k);
 
-            int ip1, jp1, kp1, ip2, jp2, kp2;
-            int im1, jm1, km1, im2, jm2, km2;
+            int ip1, jp1, kp1;
+            int im1, jm1, km1;
 
             ip1 = adj(1, i, NX);
             jp1 = adj(1, j, NY);
@@ -1130,21 +1196,12 @@ void CH_solver_implicit_euler(double *     psi,
             jm1 = adj(-1, j, NY);
             km1 = adj(-1, k, NZ);
 
-            ip2 = adj(2, i, NX);
-            jp2 = adj(2, j, NY);
-            kp2 = adj(2, k, NZ);
-
-            im2 = adj(-2, i, NX);
-            jm2 = adj(-2, j, NY);
-            km2 = adj(-2, k, NZ);
-
             int im   = ijk2im(i, j, k);
-            int idx2 = 43 * (idx - is_ch);
+            int idx2 = sell_offset(idx - is_ch, 43);
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 0] = ijk2idx(i, j, k);
-            val_ch_csr[idx2 + 0] =
+            val_ch_csr[idx2] =
                 INV_DT +
                 ak * (1. - phi_wall[im]) *
                     (14. * (coef[0][0][im] + coef[1][1][im] + coef[2][2][im]) +
@@ -1156,48 +1213,42 @@ void CH_solver_implicit_euler(double *     psi,
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 1] = ijk2idx(ip2, j, k);
-            val_ch_csr[idx2 + 1] =
+            val_ch_csr[idx2 + SELL_C * 1] =
                 ak * (1. - phi_wall[im]) * (coef[0][0][im] + coef[1][0][im] + coef[2][0][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][0], im, 0) + calc_gradient_o1_to_o1(coef[1][0], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][0], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im];
 
-            idx_ch_csr[idx2 + 2] = ijk2idx(im2, j, k);
-            val_ch_csr[idx2 + 2] =
+            val_ch_csr[idx2 + SELL_C * 2] =
                 ak * (1. - phi_wall[im]) * (coef[0][0][im] + coef[0][1][im] + coef[0][2][im]) -
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][0], im, 0) + calc_gradient_o1_to_o1(coef[1][0], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][0], im, 2)) +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im];
 
-            idx_ch_csr[idx2 + 3] = ijk2idx(i, jp2, k);
-            val_ch_csr[idx2 + 3] =
+            val_ch_csr[idx2 + SELL_C * 3] =
                 ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[1][1][im] + coef[2][1][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][1], im, 0) + calc_gradient_o1_to_o1(coef[1][1], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][1], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 4] = ijk2idx(i, jm2, k);
-            val_ch_csr[idx2 + 4] =
+            val_ch_csr[idx2 + SELL_C * 4] =
                 ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[1][1][im] + coef[1][2][im]) -
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][1], im, 0) + calc_gradient_o1_to_o1(coef[1][1], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][1], im, 2)) +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 5] = ijk2idx(i, j, kp2);
-            val_ch_csr[idx2 + 5] =
+            val_ch_csr[idx2 + SELL_C * 5] =
                 ak * (1. - phi_wall[im]) * (coef[0][2][im] + coef[1][2][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][2], im, 0) + calc_gradient_o1_to_o1(coef[1][2], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][2], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 6] = ijk2idx(i, j, km2);
-            val_ch_csr[idx2 + 6] =
+            val_ch_csr[idx2 + SELL_C * 6] =
                 ak * (1. - phi_wall[im]) * (coef[2][0][im] + coef[2][1][im] + coef[2][2][im]) -
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][2], im, 0) + calc_gradient_o1_to_o1(coef[1][2], im, 1) +
@@ -1206,8 +1257,7 @@ void CH_solver_implicit_euler(double *     psi,
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 7] = ijk2idx(i, jp1, kp1);
-            val_ch_csr[idx2 + 7] =
+            val_ch_csr[idx2 + SELL_C * 7] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][1][im] + coef[0][2][im] + coef[1][1][im] + coef[1][2][im] + coef[2][1][im] +
                      coef[2][2][im]) +
@@ -1217,8 +1267,7 @@ void CH_solver_implicit_euler(double *     psi,
                      calc_gradient_o1_to_o1(coef[2][1], im, 2) + calc_gradient_o1_to_o1(coef[2][2], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 8] = ijk2idx(i, jp1, km1);
-            val_ch_csr[idx2 + 8] =
+            val_ch_csr[idx2 + SELL_C * 8] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][1][im] + coef[1][1][im] + coef[2][0][im] + 8. * coef[2][1][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -1229,8 +1278,7 @@ void CH_solver_implicit_euler(double *     psi,
                     (phi_p[ijk2im(i, jp1, km1)] + phi_wall_prime[ijk2im(i, jp1, km1)]) * coef[2][1][im] -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im] + ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 9] = ijk2idx(i, jm1, kp1);
-            val_ch_csr[idx2 + 9] =
+            val_ch_csr[idx2 + SELL_C * 9] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][2][im] + coef[1][0][im] + coef[1][1][im] + 8. * coef[1][2][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -1241,8 +1289,7 @@ void CH_solver_implicit_euler(double *     psi,
                     (phi_p[ijk2im(i, jm1, kp1)] + phi_wall_prime[ijk2im(i, jm1, kp1)]) * coef[1][2][im] +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 10] = ijk2idx(i, jm1, km1);
-            val_ch_csr[idx2 + 10] =
+            val_ch_csr[idx2 + SELL_C * 10] =
                 ak * (1. - phi_wall[im]) *
                     (coef[1][0][im] + coef[1][1][im] + coef[1][2][im] + coef[2][0][im] + coef[2][1][im] +
                      coef[2][2][im]) +
@@ -1254,8 +1301,7 @@ void CH_solver_implicit_euler(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 11] = ijk2idx(ip1, j, kp1);
-            val_ch_csr[idx2 + 11] =
+            val_ch_csr[idx2 + SELL_C * 11] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][2][im] + coef[1][0][im] + coef[1][2][im] + coef[2][0][im] +
                      coef[2][2][im]) +
@@ -1265,8 +1311,7 @@ void CH_solver_implicit_euler(double *     psi,
                      calc_gradient_o1_to_o1(coef[2][0], im, 2) + calc_gradient_o1_to_o1(coef[2][2], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 12] = ijk2idx(ip1, j, km1);
-            val_ch_csr[idx2 + 12] =
+            val_ch_csr[idx2 + SELL_C * 12] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[1][0][im] + 8. * coef[2][0][im] + coef[2][1][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -1277,8 +1322,7 @@ void CH_solver_implicit_euler(double *     psi,
                     (phi_p[ijk2im(ip1, j, km1)] + phi_wall_prime[ijk2im(ip1, j, km1)]) * coef[2][0][im] -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] + ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 13] = ijk2idx(im1, j, kp1);
-            val_ch_csr[idx2 + 13] =
+            val_ch_csr[idx2 + SELL_C * 13] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][1][im] + 8. * coef[0][2][im] + coef[1][2][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -1289,8 +1333,7 @@ void CH_solver_implicit_euler(double *     psi,
                     (phi_p[ijk2im(im1, j, kp1)] + phi_wall_prime[ijk2im(im1, j, kp1)]) * coef[0][2][im] +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 14] = ijk2idx(im1, j, km1);
-            val_ch_csr[idx2 + 14] =
+            val_ch_csr[idx2 + SELL_C * 14] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + coef[2][0][im] + coef[2][1][im] +
                      coef[2][2][im]) +
@@ -1301,8 +1344,7 @@ void CH_solver_implicit_euler(double *     psi,
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] + ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
             //-----------------
-            idx_ch_csr[idx2 + 15] = ijk2idx(ip1, jp1, k);
-            val_ch_csr[idx2 + 15] =
+            val_ch_csr[idx2 + SELL_C * 15] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][1][im] + coef[1][0][im] + coef[1][1][im] + coef[2][0][im] +
                      coef[2][1][im]) +
@@ -1312,8 +1354,7 @@ void CH_solver_implicit_euler(double *     psi,
                      calc_gradient_o1_to_o1(coef[2][0], im, 2) + calc_gradient_o1_to_o1(coef[2][1], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 16] = ijk2idx(ip1, jm1, k);
-            val_ch_csr[idx2 + 16] =
+            val_ch_csr[idx2 + SELL_C * 16] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + 8. * coef[1][0][im] + coef[1][1][im] + coef[1][2][im] + coef[2][0][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -1324,8 +1365,7 @@ void CH_solver_implicit_euler(double *     psi,
                     (phi_p[ijk2im(ip1, jm1, k)] + phi_wall_prime[ijk2im(ip1, jm1, k)]) * coef[1][0][im] -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] + ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 17] = ijk2idx(im1, jp1, k);
-            val_ch_csr[idx2 + 17] =
+            val_ch_csr[idx2 + SELL_C * 17] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + 8. * coef[0][1][im] + coef[0][2][im] + coef[1][1][im] + coef[2][1][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -1336,8 +1376,7 @@ void CH_solver_implicit_euler(double *     psi,
                     (phi_p[ijk2im(im1, jp1, k)] + phi_wall_prime[ijk2im(im1, jp1, k)]) * coef[0][1][im] +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 18] = ijk2idx(im1, jm1, k);
-            val_ch_csr[idx2 + 18] =
+            val_ch_csr[idx2 + SELL_C * 18] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + coef[1][0][im] + coef[1][1][im] +
                      coef[1][2][im]) +
@@ -1349,8 +1388,7 @@ void CH_solver_implicit_euler(double *     psi,
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 19] = ijk2idx(ip1, j, k);
-            val_ch_csr[idx2 + 19] =
+            val_ch_csr[idx2 + SELL_C * 19] =
                 u[0][ijk2im(ip1, j, k)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (8. * coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + 8. * coef[1][0][im] + 2. * coef[1][1][im] +
@@ -1369,8 +1407,7 @@ void CH_solver_implicit_euler(double *     psi,
                 2. * ki2DX * ps.d * grad_phi_wall[im] * coef[2][0][im] *
                     (phi_p[ijk2im(ip1, j, k)] + phi_wall_prime[ijk2im(ip1, j, k)]);
 
-            idx_ch_csr[idx2 + 20] = ijk2idx(im1, j, k);
-            val_ch_csr[idx2 + 20] =
+            val_ch_csr[idx2 + SELL_C * 20] =
                 -u[0][ijk2im(im1, j, k)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (8. * coef[0][0][im] + 8. * coef[0][1][im] + 8. * coef[0][2][im] + coef[1][0][im] +
@@ -1391,8 +1428,7 @@ void CH_solver_implicit_euler(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 21] = ijk2idx(i, jp1, k);
-            val_ch_csr[idx2 + 21] =
+            val_ch_csr[idx2 + SELL_C * 21] =
                 u[1][ijk2im(i, jp1, k)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (2. * coef[0][0][im] + 8. * coef[0][1][im] + coef[0][2][im] + coef[1][0][im] + 8. * coef[1][1][im] +
@@ -1411,8 +1447,7 @@ void CH_solver_implicit_euler(double *     psi,
                 2. * ki2DX * ps.d * grad_phi_wall[im] * coef[2][1][im] *
                     (phi_p[ijk2im(i, jp1, k)] + phi_wall_prime[ijk2im(i, jp1, k)]);
 
-            idx_ch_csr[idx2 + 22] = ijk2idx(i, jm1, k);
-            val_ch_csr[idx2 + 22] =
+            val_ch_csr[idx2 + SELL_C * 22] =
                 -u[1][ijk2im(i, jm1, k)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (2. * coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + 8. * coef[1][0][im] + 8. * coef[1][1][im] +
@@ -1433,8 +1468,7 @@ void CH_solver_implicit_euler(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 23] = ijk2idx(i, j, kp1);
-            val_ch_csr[idx2 + 23] =
+            val_ch_csr[idx2 + SELL_C * 23] =
                 u[2][ijk2im(i, j, kp1)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (2. * coef[0][0][im] + coef[0][1][im] + 8. * coef[0][2][im] + coef[1][0][im] + 2. * coef[1][1][im] +
@@ -1453,8 +1487,7 @@ void CH_solver_implicit_euler(double *     psi,
                 2. * ki2DX * ps.d * grad_phi_wall[im] * coef[2][2][im] *
                     (phi_p[ijk2im(i, j, kp1)] + phi_wall_prime[ijk2im(i, j, kp1)]);
 
-            idx_ch_csr[idx2 + 24] = ijk2idx(i, j, km1);
-            val_ch_csr[idx2 + 24] =
+            val_ch_csr[idx2 + SELL_C * 24] =
                 -u[2][ijk2im(i, j, km1)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (2. * coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + coef[1][0][im] + 2. * coef[1][1][im] +
@@ -1475,70 +1508,50 @@ void CH_solver_implicit_euler(double *     psi,
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 25] = ijk2idx(ip1, jp1, km1);
-            val_ch_csr[idx2 + 25] = -ak * (1. - phi_wall[im]) * (coef[2][0][im] + coef[2][1][im]);
+            val_ch_csr[idx2 + SELL_C * 25] = -ak * (1. - phi_wall[im]) * (coef[2][0][im] + coef[2][1][im]);
 
-            idx_ch_csr[idx2 + 26] = ijk2idx(ip1, jm1, kp1);
-            val_ch_csr[idx2 + 26] = -ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[1][2][im]);
+            val_ch_csr[idx2 + SELL_C * 26] = -ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[1][2][im]);
 
-            idx_ch_csr[idx2 + 27] = ijk2idx(ip1, jm1, km1);
-            val_ch_csr[idx2 + 27] = -ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[2][0][im]);
+            val_ch_csr[idx2 + SELL_C * 27] = -ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[2][0][im]);
 
-            idx_ch_csr[idx2 + 28] = ijk2idx(im1, jp1, kp1);
-            val_ch_csr[idx2 + 28] = -ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[0][2][im]);
+            val_ch_csr[idx2 + SELL_C * 28] = -ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[0][2][im]);
 
-            idx_ch_csr[idx2 + 29] = ijk2idx(im1, jp1, km1);
-            val_ch_csr[idx2 + 29] = -ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[2][1][im]);
+            val_ch_csr[idx2 + SELL_C * 29] = -ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[2][1][im]);
 
-            idx_ch_csr[idx2 + 30] = ijk2idx(im1, jm1, kp1);
-            val_ch_csr[idx2 + 30] = -ak * (1. - phi_wall[im]) * (coef[0][2][im] + coef[1][2][im]);
+            val_ch_csr[idx2 + SELL_C * 30] = -ak * (1. - phi_wall[im]) * (coef[0][2][im] + coef[1][2][im]);
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 31] = ijk2idx(ip2, jm1, k);
-            val_ch_csr[idx2 + 31] = -ak * (1. - phi_wall[im]) * coef[1][0][im];
+            val_ch_csr[idx2 + SELL_C * 31] = -ak * (1. - phi_wall[im]) * coef[1][0][im];
 
-            idx_ch_csr[idx2 + 32] = ijk2idx(im2, jp1, k);
-            val_ch_csr[idx2 + 32] = -ak * (1. - phi_wall[im]) * coef[0][1][im];
+            val_ch_csr[idx2 + SELL_C * 32] = -ak * (1. - phi_wall[im]) * coef[0][1][im];
 
-            idx_ch_csr[idx2 + 33] = ijk2idx(ip2, j, km1);
-            val_ch_csr[idx2 + 33] = -ak * (1. - phi_wall[im]) * coef[2][0][im];
+            val_ch_csr[idx2 + SELL_C * 33] = -ak * (1. - phi_wall[im]) * coef[2][0][im];
 
-            idx_ch_csr[idx2 + 34] = ijk2idx(im2, j, kp1);
-            val_ch_csr[idx2 + 34] = -ak * (1. - phi_wall[im]) * coef[0][2][im];
+            val_ch_csr[idx2 + SELL_C * 34] = -ak * (1. - phi_wall[im]) * coef[0][2][im];
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 35] = ijk2idx(ip1, jm2, k);
-            val_ch_csr[idx2 + 35] = -ak * (1. - phi_wall[im]) * coef[1][0][im];
+            val_ch_csr[idx2 + SELL_C * 35] = -ak * (1. - phi_wall[im]) * coef[1][0][im];
 
-            idx_ch_csr[idx2 + 36] = ijk2idx(im1, jp2, k);
-            val_ch_csr[idx2 + 36] = -ak * (1. - phi_wall[im]) * coef[0][1][im];
+            val_ch_csr[idx2 + SELL_C * 36] = -ak * (1. - phi_wall[im]) * coef[0][1][im];
 
-            idx_ch_csr[idx2 + 37] = ijk2idx(i, jp2, km1);
-            val_ch_csr[idx2 + 37] = -ak * (1. - phi_wall[im]) * coef[2][1][im];
+            val_ch_csr[idx2 + SELL_C * 37] = -ak * (1. - phi_wall[im]) * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 38] = ijk2idx(i, jm2, kp1);
-            val_ch_csr[idx2 + 38] = -ak * (1. - phi_wall[im]) * coef[1][2][im];
+            val_ch_csr[idx2 + SELL_C * 38] = -ak * (1. - phi_wall[im]) * coef[1][2][im];
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 39] = ijk2idx(im1, j, kp2);
-            val_ch_csr[idx2 + 39] = -ak * (1. - phi_wall[im]) * coef[0][2][im];
+            val_ch_csr[idx2 + SELL_C * 39] = -ak * (1. - phi_wall[im]) * coef[0][2][im];
 
-            idx_ch_csr[idx2 + 40] = ijk2idx(ip1, j, km2);
-            val_ch_csr[idx2 + 40] = -ak * (1. - phi_wall[im]) * coef[2][0][im];
+            val_ch_csr[idx2 + SELL_C * 40] = -ak * (1. - phi_wall[im]) * coef[2][0][im];
 
-            idx_ch_csr[idx2 + 41] = ijk2idx(i, jm1, kp2);
-            val_ch_csr[idx2 + 41] = -ak * (1. - phi_wall[im]) * coef[1][2][im];
+            val_ch_csr[idx2 + SELL_C * 41] = -ak * (1. - phi_wall[im]) * coef[1][2][im];
 
-            idx_ch_csr[idx2 + 42] = ijk2idx(i, jp1, km2);
-            val_ch_csr[idx2 + 42] = -ak * (1. - phi_wall[im]) * coef[2][1][im];
+            val_ch_csr[idx2 + SELL_C * 42] = -ak * (1. - phi_wall[im]) * coef[2][1][im];
 
             //---------------------------------------
 
-            ptr_ch[idx - is_ch + 1] = idx2 + 43;
         }
-        ptr_ch[0] = 0;
     } else {
 #pragma omp parallel for
         for (int idx = is_ch; idx < ie_ch; idx++) {
@@ -1566,129 +1579,127 @@ void CH_solver_implicit_euler(double *     psi,
 
             int im = ijk2im(i, j, k);
 
-            int idx2 = 25 * (idx - is_ch);
+            int idx2 = sell_offset(idx - is_ch, 25);
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 0] = ijk2idx(i, j, k);
-            val_ch_csr[idx2 + 0] = INV_DT + 42. * ak + 12. * kiDX2 * ps.d * phi[im] -
-                                   _2zk * 10. *
-                                       (phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] + phi[ijk2im(i, jp1, k)] +
-                                        phi[ijk2im(i, jm1, k)] + phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                   _2zk * 102. * phi[im];
+            val_ch_csr[idx2] = INV_DT + 42. * ak + 12. * kiDX2 * ps.d * phi[im] -
+                               _2zk * 10. *
+                                   (phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] + phi[ijk2im(i, jp1, k)] +
+                                    phi[ijk2im(i, jm1, k)] + phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               _2zk * 102. * phi[im];
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 1] = ijk2idx(ip2, j, k);
-            val_ch_csr[idx2 + 1] = ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)]));
+            val_ch_csr[idx2 + SELL_C * 1] =
+                ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)]));
 
-            idx_ch_csr[idx2 + 2] = ijk2idx(im2, j, k);
-            val_ch_csr[idx2 + 2] = ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)]));
+            val_ch_csr[idx2 + SELL_C * 2] =
+                ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)]));
 
-            idx_ch_csr[idx2 + 3] = ijk2idx(i, jp2, k);
-            val_ch_csr[idx2 + 3] = ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]));
+            val_ch_csr[idx2 + SELL_C * 3] =
+                ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]));
 
-            idx_ch_csr[idx2 + 4] = ijk2idx(i, jm2, k);
-            val_ch_csr[idx2 + 4] = ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]));
+            val_ch_csr[idx2 + SELL_C * 4] =
+                ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]));
 
-            idx_ch_csr[idx2 + 5] = ijk2idx(i, j, kp2);
-            val_ch_csr[idx2 + 5] = ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]));
+            val_ch_csr[idx2 + SELL_C * 5] =
+                ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]));
 
-            idx_ch_csr[idx2 + 6] = ijk2idx(i, j, km2);
-            val_ch_csr[idx2 + 6] = ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]));
+            val_ch_csr[idx2 + SELL_C * 6] =
+                ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]));
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 7] = ijk2idx(i, jp1, kp1);
-            val_ch_csr[idx2 + 7] = _2ak + _2zk * (0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)] +
-                                                          phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
-                                                  2. * phi[im] +
-                                                  0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
-                                                          phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
-
-            idx_ch_csr[idx2 + 8] = ijk2idx(i, jp1, km1);
-            val_ch_csr[idx2 + 8] = _2ak + _2zk * (0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)] -
-                                                          phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                                  2. * phi[im] -
-                                                  0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
-                                                          phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
-
-            idx_ch_csr[idx2 + 9] = ijk2idx(i, jm1, kp1);
-            val_ch_csr[idx2 + 9] = _2ak + _2zk * (0.75 * (-phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] +
-                                                          phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
-                                                  2. * phi[im] -
-                                                  0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
-                                                          phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
-
-            idx_ch_csr[idx2 + 10] = ijk2idx(i, jm1, km1);
-            val_ch_csr[idx2 + 10] = _2ak + _2zk * (0.75 * (-phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] -
-                                                           phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
-                                                           phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
+            val_ch_csr[idx2 + SELL_C * 7] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)] +
+                                       phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
+                                       phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 8] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)] -
+                                       phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
+                                       phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 9] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] +
+                                       phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
+                                       phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 10] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] -
+                                       phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
+                                       phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
 
             //-----------------
 
-            idx_ch_csr[idx2 + 11] = ijk2idx(ip1, j, kp1);
-            val_ch_csr[idx2 + 11] = _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] +
-                                                           phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
-                                                           phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
-
-            idx_ch_csr[idx2 + 12] = ijk2idx(ip1, j, km1);
-            val_ch_csr[idx2 + 12] = _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] -
-                                                           phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] -
-                                                   0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
-                                                           phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
-
-            idx_ch_csr[idx2 + 13] = ijk2idx(im1, j, kp1);
-            val_ch_csr[idx2 + 13] = _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] +
-                                                           phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] -
-                                                   0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
-                                                           phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
-
-            idx_ch_csr[idx2 + 14] = ijk2idx(im1, j, km1);
-            val_ch_csr[idx2 + 14] = _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] -
-                                                           phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
-                                                           phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
+            val_ch_csr[idx2 + SELL_C * 11] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] +
+                                       phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
+                                       phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 12] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] -
+                                       phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
+                                       phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 13] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] +
+                                       phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
+                                       phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 14] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] -
+                                       phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
+                                       phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
 
             //-----------------
-            idx_ch_csr[idx2 + 15] = ijk2idx(ip1, jp1, k);
-            val_ch_csr[idx2 + 15] = _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] +
-                                                           phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
-                                                           phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
-
-            idx_ch_csr[idx2 + 16] = ijk2idx(ip1, jm1, k);
-            val_ch_csr[idx2 + 16] = _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] -
-                                                           phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)]) +
-                                                   2. * phi[im] -
-                                                   0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
-                                                           phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
-
-            idx_ch_csr[idx2 + 17] = ijk2idx(im1, jp1, k);
-            val_ch_csr[idx2 + 17] = _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] +
-                                                           phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]) +
-                                                   2. * phi[im] -
-                                                   0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
-                                                           phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
-
-            idx_ch_csr[idx2 + 18] = ijk2idx(im1, jm1, k);
-            val_ch_csr[idx2 + 18] = _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] -
-                                                           phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
-                                                           phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
+            val_ch_csr[idx2 + SELL_C * 15] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] +
+                                       phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
+                                       phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
+
+            val_ch_csr[idx2 + SELL_C * 16] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] -
+                                       phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
+                                       phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
+
+            val_ch_csr[idx2 + SELL_C * 17] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] +
+                                       phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
+                                       phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
+
+            val_ch_csr[idx2 + SELL_C * 18] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] -
+                                       phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
+                                       phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 19] = ijk2idx(ip1, j, k);
-            val_ch_csr[idx2 + 19] =
+            val_ch_csr[idx2 + SELL_C * 19] =
                 u[0][ijk2im(ip1, j, k)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(ip1, j, k)] +
                 _2zk * (0.25 * (phi[ijk2im(ip1, jp1, k)] + phi[ijk2im(ip1, jm1, k)] + phi[ijk2im(ip1, j, kp1)] +
                                 phi[ijk2im(ip1, j, km1)] + phi[ijk2im(ip2, j, k)] - phi[ijk2im(im1, jp1, k)] -
@@ -1697,8 +1708,7 @@ void CH_solver_implicit_euler(double *     psi,
                         3. * phi[ijk2im(ip1, j, k)] + 9. * phi[ijk2im(im1, j, k)] + phi[ijk2im(i, jp1, k)] +
                         phi[ijk2im(i, jm1, k)] + phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)] - 22. * phi[im]);
 
-            idx_ch_csr[idx2 + 20] = ijk2idx(im1, j, k);
-            val_ch_csr[idx2 + 20] =
+            val_ch_csr[idx2 + SELL_C * 20] =
                 -u[0][ijk2im(im1, j, k)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(im1, j, k)] +
                 _2zk * (0.25 * (phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)] + phi[ijk2im(im1, j, kp1)] +
                                 phi[ijk2im(im1, j, km1)] + phi[ijk2im(im2, j, k)] - phi[ijk2im(ip1, jp1, k)] -
@@ -1709,8 +1719,7 @@ void CH_solver_implicit_euler(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 21] = ijk2idx(i, jp1, k);
-            val_ch_csr[idx2 + 21] =
+            val_ch_csr[idx2 + SELL_C * 21] =
                 u[1][ijk2im(i, jp1, k)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(i, jp1, k)] +
                 _2zk * (0.25 * (phi[ijk2im(ip1, jp1, k)] + phi[ijk2im(im1, jp1, k)] + phi[ijk2im(i, jp1, kp1)] +
                                 phi[ijk2im(i, jp1, km1)] + phi[ijk2im(i, jp2, k)] - phi[ijk2im(ip1, jm1, k)] -
@@ -1719,8 +1728,7 @@ void CH_solver_implicit_euler(double *     psi,
                         phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] - 3. * phi[ijk2im(i, jp1, k)] +
                         9. * phi[ijk2im(i, jm1, k)] + phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)] - 22. * phi[im]);
 
-            idx_ch_csr[idx2 + 22] = ijk2idx(i, jm1, k);
-            val_ch_csr[idx2 + 22] =
+            val_ch_csr[idx2 + SELL_C * 22] =
                 -u[1][ijk2im(i, jm1, k)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(i, jm1, k)] +
                 _2zk * (0.25 * (phi[ijk2im(ip1, jm1, k)] + phi[ijk2im(im1, jm1, k)] + phi[ijk2im(i, jm1, kp1)] +
                                 phi[ijk2im(i, jm1, km1)] + phi[ijk2im(i, jm2, k)] - phi[ijk2im(ip1, jp1, k)] -
@@ -1731,8 +1739,7 @@ void CH_solver_implicit_euler(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 23] = ijk2idx(i, j, kp1);
-            val_ch_csr[idx2 + 23] =
+            val_ch_csr[idx2 + SELL_C * 23] =
                 u[2][ijk2im(i, j, kp1)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(i, j, kp1)] +
                 _2zk *
                     (0.25 * (phi[ijk2im(ip1, j, kp1)] + phi[ijk2im(im1, j, kp1)] + phi[ijk2im(i, jp1, kp1)] +
@@ -1742,8 +1749,7 @@ void CH_solver_implicit_euler(double *     psi,
                      phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] + phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] -
                      3. * phi[ijk2im(i, j, kp1)] + 9. * phi[ijk2im(i, j, km1)] - 22. * phi[im]);
 
-            idx_ch_csr[idx2 + 24] = ijk2idx(i, j, km1);
-            val_ch_csr[idx2 + 24] =
+            val_ch_csr[idx2 + SELL_C * 24] =
                 -u[2][ijk2im(i, j, km1)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(i, j, km1)] +
                 _2zk *
                     (0.25 * (phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)] + phi[ijk2im(i, jp1, km1)] +
@@ -1755,9 +1761,7 @@ void CH_solver_implicit_euler(double *     psi,
 
             //-----------------
 
-            ptr_ch[idx - is_ch + 1] = idx2 + 25;
         }
-        ptr_ch[0] = 0;
     }
 
     // const vector
@@ -1774,14 +1778,6 @@ void CH_solver_implicit_euler(double *     psi,
         int jm1 = adj(-1, j, NY);
         int km1 = adj(-1, k, NZ);
 
-        int ip2 = adj(2, i, NX);
-        int jp2 = adj(2, j, NY);
-        int kp2 = adj(2, k, NZ);
-
-        int im2 = adj(-2, i, NX);
-        int jm2 = adj(-2, j, NY);
-        int km2 = adj(-2, k, NZ);
-
         double psi_all_im = psi_all[ijk2im(i, j, k)];
         double bs;
 
@@ -1849,7 +1845,8 @@ void CH_solver_implicit_euler(double *     psi,
     lis_matrix_assemble(A_ch);
     lis_solve(A_ch, b_ch, x_ch, lis_solver_ch);
 #else
-    bicgstab(idx_ch_csr, val_ch_csr, ptr_ch, b_ch, wm_ch, nval);
+    Set_initial_guess(&psi_all, 1, wm_ch);
+    bicgstab(idx_ch_csr, val_ch_csr, Ch_row_width(), b_ch, wm_ch, nval);
 #endif
 
     Cpy_v1(psi_o, psi);
@@ -1908,8 +1905,8 @@ void CH_solver_implicit_bdfab(double *     psi,
             int i, j, k;
             idx2ijk(idx, &i, &j, &k);
 
-            int ip1, jp1, kp1, ip2, jp2, kp2;
-            int im1, jm1, km1, im2, jm2, km2;
+            int ip1, jp1, kp1;
+            int im1, jm1, km1;
 
             ip1 = adj(1, i, NX);
             jp1 = adj(1, j, NY);
@@ -1919,21 +1916,12 @@ void CH_solver_implicit_bdfab(double *     psi,
             jm1 = adj(-1, j, NY);
             km1 = adj(-1, k, NZ);
 
-            ip2 = adj(2, i, NX);
-            jp2 = adj(2, j, NY);
-            kp2 = adj(2, k, NZ);
-
-            im2 = adj(-2, i, NX);
-            jm2 = adj(-2, j, NY);
-            km2 = adj(-2, k, NZ);
-
             int im   = ijk2im(i, j, k);
-            int idx2 = 43 * (idx - is_ch);
+            int idx2 = sell_offset(idx - is_ch, 43);
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 0] = ijk2idx(i, j, k);
-            val_ch_csr[idx2 + 0] =
+            val_ch_csr[idx2] =
                 1.5 * INV_DT +
                 ak * (1. - phi_wall[im]) *
                     (14. * (coef[0][0][im] + coef[1][1][im] + coef[2][2][im]) +
@@ -1945,48 +1933,42 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 1] = ijk2idx(ip2, j, k);
-            val_ch_csr[idx2 + 1] =
+            val_ch_csr[idx2 + SELL_C * 1] =
                 ak * (1. - phi_wall[im]) * (coef[0][0][im] + coef[1][0][im] + coef[2][0][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][0], im, 0) + calc_gradient_o1_to_o1(coef[1][0], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][0], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im];
 
-            idx_ch_csr[idx2 + 2] = ijk2idx(im2, j, k);
-            val_ch_csr[idx2 + 2] =
+            val_ch_csr[idx2 + SELL_C * 2] =
                 ak * (1. - phi_wall[im]) * (coef[0][0][im] + coef[0][1][im] + coef[0][2][im]) -
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][0], im, 0) + calc_gradient_o1_to_o1(coef[1][0], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][0], im, 2)) +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im];
 
-            idx_ch_csr[idx2 + 3] = ijk2idx(i, jp2, k);
-            val_ch_csr[idx2 + 3] =
+            val_ch_csr[idx2 + SELL_C * 3] =
                 ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[1][1][im] + coef[2][1][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][1], im, 0) + calc_gradient_o1_to_o1(coef[1][1], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][1], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 4] = ijk2idx(i, jm2, k);
-            val_ch_csr[idx2 + 4] =
+            val_ch_csr[idx2 + SELL_C * 4] =
                 ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[1][1][im] + coef[1][2][im]) -
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][1], im, 0) + calc_gradient_o1_to_o1(coef[1][1], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][1], im, 2)) +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 5] = ijk2idx(i, j, kp2);
-            val_ch_csr[idx2 + 5] =
+            val_ch_csr[idx2 + SELL_C * 5] =
                 ak * (1. - phi_wall[im]) * (coef[0][2][im] + coef[1][2][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][2], im, 0) + calc_gradient_o1_to_o1(coef[1][2], im, 1) +
                      calc_gradient_o1_to_o1(coef[2][2], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 6] = ijk2idx(i, j, km2);
-            val_ch_csr[idx2 + 6] =
+            val_ch_csr[idx2 + SELL_C * 6] =
                 ak * (1. - phi_wall[im]) * (coef[2][0][im] + coef[2][1][im] + coef[2][2][im]) -
                 ak_2DX3 * (1. - phi_wall[im]) *
                     (calc_gradient_o1_to_o1(coef[0][2], im, 0) + calc_gradient_o1_to_o1(coef[1][2], im, 1) +
@@ -1995,8 +1977,7 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 7] = ijk2idx(i, jp1, kp1);
-            val_ch_csr[idx2 + 7] =
+            val_ch_csr[idx2 + SELL_C * 7] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][1][im] + coef[0][2][im] + coef[1][1][im] + coef[1][2][im] + coef[2][1][im] +
                      coef[2][2][im]) +
@@ -2006,8 +1987,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                      calc_gradient_o1_to_o1(coef[2][1], im, 2) + calc_gradient_o1_to_o1(coef[2][2], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 8] = ijk2idx(i, jp1, km1);
-            val_ch_csr[idx2 + 8] =
+            val_ch_csr[idx2 + SELL_C * 8] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][1][im] + coef[1][1][im] + coef[2][0][im] + 8. * coef[2][1][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -2018,8 +1998,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                     (phi_p[ijk2im(i, jp1, km1)] + phi_wall_prime[ijk2im(i, jp1, km1)]) * coef[2][1][im] -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im] + ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 9] = ijk2idx(i, jm1, kp1);
-            val_ch_csr[idx2 + 9] =
+            val_ch_csr[idx2 + SELL_C * 9] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][2][im] + coef[1][0][im] + coef[1][1][im] + 8. * coef[1][2][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -2030,8 +2009,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                     (phi_p[ijk2im(i, jm1, kp1)] + phi_wall_prime[ijk2im(i, jm1, kp1)]) * coef[1][2][im] +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][1][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 10] = ijk2idx(i, jm1, km1);
-            val_ch_csr[idx2 + 10] =
+            val_ch_csr[idx2 + SELL_C * 10] =
                 ak * (1. - phi_wall[im]) *
                     (coef[1][0][im] + coef[1][1][im] + coef[1][2][im] + coef[2][0][im] + coef[2][1][im] +
                      coef[2][2][im]) +
@@ -2043,8 +2021,7 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 11] = ijk2idx(ip1, j, kp1);
-            val_ch_csr[idx2 + 11] =
+            val_ch_csr[idx2 + SELL_C * 11] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][2][im] + coef[1][0][im] + coef[1][2][im] + coef[2][0][im] +
                      coef[2][2][im]) +
@@ -2054,8 +2031,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                      calc_gradient_o1_to_o1(coef[2][0], im, 2) + calc_gradient_o1_to_o1(coef[2][2], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 12] = ijk2idx(ip1, j, km1);
-            val_ch_csr[idx2 + 12] =
+            val_ch_csr[idx2 + SELL_C * 12] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[1][0][im] + 8. * coef[2][0][im] + coef[2][1][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -2066,8 +2042,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                     (phi_p[ijk2im(ip1, j, km1)] + phi_wall_prime[ijk2im(ip1, j, km1)]) * coef[2][0][im] -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] + ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 13] = ijk2idx(im1, j, kp1);
-            val_ch_csr[idx2 + 13] =
+            val_ch_csr[idx2 + SELL_C * 13] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][1][im] + 8. * coef[0][2][im] + coef[1][2][im] + coef[2][2][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -2078,8 +2053,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                     (phi_p[ijk2im(im1, j, kp1)] + phi_wall_prime[ijk2im(im1, j, kp1)]) * coef[0][2][im] +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
-            idx_ch_csr[idx2 + 14] = ijk2idx(im1, j, km1);
-            val_ch_csr[idx2 + 14] =
+            val_ch_csr[idx2 + SELL_C * 14] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + coef[2][0][im] + coef[2][1][im] +
                      coef[2][2][im]) +
@@ -2090,8 +2064,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] + ak_2DX3 * grad_phi_wall[im] * coef[2][2][im];
 
             //-----------------
-            idx_ch_csr[idx2 + 15] = ijk2idx(ip1, jp1, k);
-            val_ch_csr[idx2 + 15] =
+            val_ch_csr[idx2 + SELL_C * 15] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][1][im] + coef[1][0][im] + coef[1][1][im] + coef[2][0][im] +
                      coef[2][1][im]) +
@@ -2101,8 +2074,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                      calc_gradient_o1_to_o1(coef[2][0], im, 2) + calc_gradient_o1_to_o1(coef[2][1], im, 2)) -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 16] = ijk2idx(ip1, jm1, k);
-            val_ch_csr[idx2 + 16] =
+            val_ch_csr[idx2 + SELL_C * 16] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + 8. * coef[1][0][im] + coef[1][1][im] + coef[1][2][im] + coef[2][0][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -2113,8 +2085,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                     (phi_p[ijk2im(ip1, jm1, k)] + phi_wall_prime[ijk2im(ip1, jm1, k)]) * coef[1][0][im] -
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] + ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 17] = ijk2idx(im1, jp1, k);
-            val_ch_csr[idx2 + 17] =
+            val_ch_csr[idx2 + SELL_C * 17] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + 8. * coef[0][1][im] + coef[0][2][im] + coef[1][1][im] + coef[2][1][im]) +
                 ak_2DX3 * (1. - phi_wall[im]) *
@@ -2125,8 +2096,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                     (phi_p[ijk2im(im1, jp1, k)] + phi_wall_prime[ijk2im(im1, jp1, k)]) * coef[0][1][im] +
                 ak_2DX3 * grad_phi_wall[im] * coef[2][0][im] - ak_2DX3 * grad_phi_wall[im] * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 18] = ijk2idx(im1, jm1, k);
-            val_ch_csr[idx2 + 18] =
+            val_ch_csr[idx2 + SELL_C * 18] =
                 ak * (1. - phi_wall[im]) *
                     (coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + coef[1][0][im] + coef[1][1][im] +
                      coef[1][2][im]) +
@@ -2138,8 +2108,7 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 19] = ijk2idx(ip1, j, k);
-            val_ch_csr[idx2 + 19] =
+            val_ch_csr[idx2 + SELL_C * 19] =
                 u[0][ijk2im(ip1, j, k)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (8. * coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + 8. * coef[1][0][im] + 2. * coef[1][1][im] +
@@ -2158,8 +2127,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                 2. * ki2DX * ps.d * grad_phi_wall[im] * coef[2][0][im] *
                     (phi_p[ijk2im(ip1, j, k)] + phi_wall_prime[ijk2im(ip1, j, k)]);
 
-            idx_ch_csr[idx2 + 20] = ijk2idx(im1, j, k);
-            val_ch_csr[idx2 + 20] =
+            val_ch_csr[idx2 + SELL_C * 20] =
                 -u[0][ijk2im(im1, j, k)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (8. * coef[0][0][im] + 8. * coef[0][1][im] + 8. * coef[0][2][im] + coef[1][0][im] +
@@ -2180,8 +2148,7 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 21] = ijk2idx(i, jp1, k);
-            val_ch_csr[idx2 + 21] =
+            val_ch_csr[idx2 + SELL_C * 21] =
                 u[1][ijk2im(i, jp1, k)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (2. * coef[0][0][im] + 8. * coef[0][1][im] + coef[0][2][im] + coef[1][0][im] + 8. * coef[1][1][im] +
@@ -2200,8 +2167,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                 2. * ki2DX * ps.d * grad_phi_wall[im] * coef[2][1][im] *
                     (phi_p[ijk2im(i, jp1, k)] + phi_wall_prime[ijk2im(i, jp1, k)]);
 
-            idx_ch_csr[idx2 + 22] = ijk2idx(i, jm1, k);
-            val_ch_csr[idx2 + 22] =
+            val_ch_csr[idx2 + SELL_C * 22] =
                 -u[1][ijk2im(i, jm1, k)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (2. * coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + 8. * coef[1][0][im] + 8. * coef[1][1][im] +
@@ -2222,8 +2188,7 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 23] = ijk2idx(i, j, kp1);
-            val_ch_csr[idx2 + 23] =
+            val_ch_csr[idx2 + SELL_C * 23] =
                 u[2][ijk2im(i, j, kp1)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (2. * coef[0][0][im] + coef[0][1][im] + 8. * coef[0][2][im] + coef[1][0][im] + 2. * coef[1][1][im] +
@@ -2242,8 +2207,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                 2. * ki2DX * ps.d * grad_phi_wall[im] * coef[2][2][im] *
                     (phi_p[ijk2im(i, j, kp1)] + phi_wall_prime[ijk2im(i, j, kp1)]);
 
-            idx_ch_csr[idx2 + 24] = ijk2idx(i, j, km1);
-            val_ch_csr[idx2 + 24] =
+            val_ch_csr[idx2 + SELL_C * 24] =
                 -u[2][ijk2im(i, j, km1)] * INV_2DX -
                 ak * (1. - phi_wall[im]) *
                     (2. * coef[0][0][im] + coef[0][1][im] + coef[0][2][im] + coef[1][0][im] + 2. * coef[1][1][im] +
@@ -2264,70 +2228,50 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 25] = ijk2idx(ip1, jp1, km1);
-            val_ch_csr[idx2 + 25] = -ak * (1. - phi_wall[im]) * (coef[2][0][im] + coef[2][1][im]);
+            val_ch_csr[idx2 + SELL_C * 25] = -ak * (1. - phi_wall[im]) * (coef[2][0][im] + coef[2][1][im]);
 
-            idx_ch_csr[idx2 + 26] = ijk2idx(ip1, jm1, kp1);
-            val_ch_csr[idx2 + 26] = -ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[1][2][im]);
+            val_ch_csr[idx2 + SELL_C * 26] = -ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[1][2][im]);
 
-            idx_ch_csr[idx2 + 27] = ijk2idx(ip1, jm1, km1);
-            val_ch_csr[idx2 + 27] = -ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[2][0][im]);
+            val_ch_csr[idx2 + SELL_C * 27] = -ak * (1. - phi_wall[im]) * (coef[1][0][im] + coef[2][0][im]);
 
-            idx_ch_csr[idx2 + 28] = ijk2idx(im1, jp1, kp1);
-            val_ch_csr[idx2 + 28] = -ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[0][2][im]);
+            val_ch_csr[idx2 + SELL_C * 28] = -ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[0][2][im]);
 
-            idx_ch_csr[idx2 + 29] = ijk2idx(im1, jp1, km1);
-            val_ch_csr[idx2 + 29] = -ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[2][1][im]);
+            val_ch_csr[idx2 + SELL_C * 29] = -ak * (1. - phi_wall[im]) * (coef[0][1][im] + coef[2][1][im]);
 
-            idx_ch_csr[idx2 + 30] = ijk2idx(im1, jm1, kp1);
-            val_ch_csr[idx2 + 30] = -ak * (1. - phi_wall[im]) * (coef[0][2][im] + coef[1][2][im]);
+            val_ch_csr[idx2 + SELL_C * 30] = -ak * (1. - phi_wall[im]) * (coef[0][2][im] + coef[1][2][im]);
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 31] = ijk2idx(ip2, jm1, k);
-            val_ch_csr[idx2 + 31] = -ak * (1. - phi_wall[im]) * coef[1][0][im];
+            val_ch_csr[idx2 + SELL_C * 31] = -ak * (1. - phi_wall[im]) * coef[1][0][im];
 
-            idx_ch_csr[idx2 + 32] = ijk2idx(im2, jp1, k);
-            val_ch_csr[idx2 + 32] = -ak * (1. - phi_wall[im]) * coef[0][1][im];
+            val_ch_csr[idx2 + SELL_C * 32] = -ak * (1. - phi_wall[im]) * coef[0][1][im];
 
-            idx_ch_csr[idx2 + 33] = ijk2idx(ip2, j, km1);
-            val_ch_csr[idx2 + 33] = -ak * (1. - phi_wall[im]) * coef[2][0][im];
+            val_ch_csr[idx2 + SELL_C * 33] = -ak * (1. - phi_wall[im]) * coef[2][0][im];
 
-            idx_ch_csr[idx2 + 34] = ijk2idx(im2, j, kp1);
-            val_ch_csr[idx2 + 34] = -ak * (1. - phi_wall[im]) * coef[0][2][im];
+            val_ch_csr[idx2 + SELL_C * 34] = -ak * (1. - phi_wall[im]) * coef[0][2][im];
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 35] = ijk2idx(ip1, jm2, k);
-            val_ch_csr[idx2 + 35] = -ak * (1. - phi_wall[im]) * coef[1][0][im];
+            val_ch_csr[idx2 + SELL_C * 35] = -ak * (1. - phi_wall[im]) * coef[1][0][im];
 
-            idx_ch_csr[idx2 + 36] = ijk2idx(im1, jp2, k);
-            val_ch_csr[idx2 + 36] = -ak * (1. - phi_wall[im]) * coef[0][1][im];
+            val_ch_csr[idx2 + SELL_C * 36] = -ak * (1. - phi_wall[im]) * coef[0][1][im];
 
-            idx_ch_csr[idx2 + 37] = ijk2idx(i, jp2, km1);
-            val_ch_csr[idx2 + 37] = -ak * (1. - phi_wall[im]) * coef[2][1][im];
+            val_ch_csr[idx2 + SELL_C * 37] = -ak * (1. - phi_wall[im]) * coef[2][1][im];
 
-            idx_ch_csr[idx2 + 38] = ijk2idx(i, jm2, kp1);
-            val_ch_csr[idx2 + 38] = -ak * (1. - phi_wall[im]) * coef[1][2][im];
+            val_ch_csr[idx2 + SELL_C * 38] = -ak * (1. - phi_wall[im]) * coef[1][2][im];
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 39] = ijk2idx(im1, j, kp2);
-            val_ch_csr[idx2 + 39] = -ak * (1. - phi_wall[im]) * coef[0][2][im];
+            val_ch_csr[idx2 + SELL_C * 39] = -ak * (1. - phi_wall[im]) * coef[0][2][im];
 
-            idx_ch_csr[idx2 + 40] = ijk2idx(ip1, j, km2);
-            val_ch_csr[idx2 + 40] = -ak * (1. - phi_wall[im]) * coef[2][0][im];
+            val_ch_csr[idx2 + SELL_C * 40] = -ak * (1. - phi_wall[im]) * coef[2][0][im];
 
-            idx_ch_csr[idx2 + 41] = ijk2idx(i, jm1, kp2);
-            val_ch_csr[idx2 + 41] = -ak * (1. - phi_wall[im]) * coef[1][2][im];
+            val_ch_csr[idx2 + SELL_C * 41] = -ak * (1. - phi_wall[im]) * coef[1][2][im];
 
-            idx_ch_csr[idx2 + 42] = ijk2idx(i, jp1, km2);
-            val_ch_csr[idx2 + 42] = -ak * (1. - phi_wall[im]) * coef[2][1][im];
+            val_ch_csr[idx2 + SELL_C * 42] = -ak * (1. - phi_wall[im]) * coef[2][1][im];
 
             //---------------------------------------
 
-            ptr_ch[idx - is_ch + 1] = idx2 + 43;
         }
-        ptr_ch[0] = 0;
     } else {
 #pragma omp parallel for
         for (int idx = is_ch; idx < ie_ch; idx++) {
@@ -2355,129 +2299,127 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             int im = ijk2im(i, j, k);
 
-            int idx2 = 25 * (idx - is_ch);
+            int idx2 = sell_offset(idx - is_ch, 25);
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 0] = ijk2idx(i, j, k);
-            val_ch_csr[idx2 + 0] = 1.5 * INV_DT + 42. * ak + 12. * kiDX2 * ps.d * phi[im] -
-                                   _2zk * 10. *
-                                       (phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] + phi[ijk2im(i, jp1, k)] +
-                                        phi[ijk2im(i, jm1, k)] + phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                   _2zk * 102. * phi[im];
+            val_ch_csr[idx2] = 1.5 * INV_DT + 42. * ak + 12. * kiDX2 * ps.d * phi[im] -
+                               _2zk * 10. *
+                                   (phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] + phi[ijk2im(i, jp1, k)] +
+                                    phi[ijk2im(i, jm1, k)] + phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               _2zk * 102. * phi[im];
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 1] = ijk2idx(ip2, j, k);
-            val_ch_csr[idx2 + 1] = ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)]));
+            val_ch_csr[idx2 + SELL_C * 1] =
+                ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)]));
 
-            idx_ch_csr[idx2 + 2] = ijk2idx(im2, j, k);
-            val_ch_csr[idx2 + 2] = ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)]));
+            val_ch_csr[idx2 + SELL_C * 2] =
+                ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)]));
 
-            idx_ch_csr[idx2 + 3] = ijk2idx(i, jp2, k);
-            val_ch_csr[idx2 + 3] = ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]));
+            val_ch_csr[idx2 + SELL_C * 3] =
+                ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]));
 
-            idx_ch_csr[idx2 + 4] = ijk2idx(i, jm2, k);
-            val_ch_csr[idx2 + 4] = ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]));
+            val_ch_csr[idx2 + SELL_C * 4] =
+                ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]));
 
-            idx_ch_csr[idx2 + 5] = ijk2idx(i, j, kp2);
-            val_ch_csr[idx2 + 5] = ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]));
+            val_ch_csr[idx2 + SELL_C * 5] =
+                ak + _2zk * (phi[im] + 0.75 * (phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]));
 
-            idx_ch_csr[idx2 + 6] = ijk2idx(i, j, km2);
-            val_ch_csr[idx2 + 6] = ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]));
+            val_ch_csr[idx2 + SELL_C * 6] =
+                ak + _2zk * (phi[im] - 0.75 * (phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]));
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 7] = ijk2idx(i, jp1, kp1);
-            val_ch_csr[idx2 + 7] = _2ak + _2zk * (0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)] +
-                                                          phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
-                                                  2. * phi[im] +
-                                                  0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
-                                                          phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
-
-            idx_ch_csr[idx2 + 8] = ijk2idx(i, jp1, km1);
-            val_ch_csr[idx2 + 8] = _2ak + _2zk * (0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)] -
-                                                          phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                                  2. * phi[im] -
-                                                  0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
-                                                          phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
-
-            idx_ch_csr[idx2 + 9] = ijk2idx(i, jm1, kp1);
-            val_ch_csr[idx2 + 9] = _2ak + _2zk * (0.75 * (-phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] +
-                                                          phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
-                                                  2. * phi[im] -
-                                                  0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
-                                                          phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
-
-            idx_ch_csr[idx2 + 10] = ijk2idx(i, jm1, km1);
-            val_ch_csr[idx2 + 10] = _2ak + _2zk * (0.75 * (-phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] -
-                                                           phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
-                                                           phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
+            val_ch_csr[idx2 + SELL_C * 7] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)] +
+                                       phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
+                                       phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 8] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)] -
+                                       phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
+                                       phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 9] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] +
+                                       phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
+                                       phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 10] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] -
+                                       phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(i, jp1, kp1)] - phi[ijk2im(i, jp1, km1)] -
+                                       phi[ijk2im(i, jm1, kp1)] + phi[ijk2im(i, jm1, km1)]));
 
             //-----------------
 
-            idx_ch_csr[idx2 + 11] = ijk2idx(ip1, j, kp1);
-            val_ch_csr[idx2 + 11] = _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] +
-                                                           phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
-                                                           phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
-
-            idx_ch_csr[idx2 + 12] = ijk2idx(ip1, j, km1);
-            val_ch_csr[idx2 + 12] = _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] -
-                                                           phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] -
-                                                   0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
-                                                           phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
-
-            idx_ch_csr[idx2 + 13] = ijk2idx(im1, j, kp1);
-            val_ch_csr[idx2 + 13] = _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] +
-                                                           phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] -
-                                                   0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
-                                                           phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
-
-            idx_ch_csr[idx2 + 14] = ijk2idx(im1, j, km1);
-            val_ch_csr[idx2 + 14] = _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] -
-                                                           phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
-                                                           phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
+            val_ch_csr[idx2 + SELL_C * 11] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] +
+                                       phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
+                                       phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 12] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] -
+                                       phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
+                                       phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 13] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] +
+                                       phi[ijk2im(i, j, kp1)] - phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
+                                       phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
+
+            val_ch_csr[idx2 + SELL_C * 14] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] -
+                                       phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(ip1, j, kp1)] - phi[ijk2im(im1, j, kp1)] -
+                                       phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)]));
 
             //-----------------
-            idx_ch_csr[idx2 + 15] = ijk2idx(ip1, jp1, k);
-            val_ch_csr[idx2 + 15] = _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] +
-                                                           phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
-                                                           phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
-
-            idx_ch_csr[idx2 + 16] = ijk2idx(ip1, jm1, k);
-            val_ch_csr[idx2 + 16] = _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] -
-                                                           phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)]) +
-                                                   2. * phi[im] -
-                                                   0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
-                                                           phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
-
-            idx_ch_csr[idx2 + 17] = ijk2idx(im1, jp1, k);
-            val_ch_csr[idx2 + 17] = _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] +
-                                                           phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]) +
-                                                   2. * phi[im] -
-                                                   0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
-                                                           phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
-
-            idx_ch_csr[idx2 + 18] = ijk2idx(im1, jm1, k);
-            val_ch_csr[idx2 + 18] = _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] -
-                                                           phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)]) +
-                                                   2. * phi[im] +
-                                                   0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
-                                                           phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
+            val_ch_csr[idx2 + SELL_C * 15] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] +
+                                       phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
+                                       phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
+
+            val_ch_csr[idx2 + SELL_C * 16] =
+                _2ak + _2zk * (0.75 * (phi[ijk2im(ip1, j, k)] - phi[ijk2im(im1, j, k)] -
+                                       phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
+                                       phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
+
+            val_ch_csr[idx2 + SELL_C * 17] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] +
+                                       phi[ijk2im(i, jp1, k)] - phi[ijk2im(i, jm1, k)]) +
+                               2. * phi[im] -
+                               0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
+                                       phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
+
+            val_ch_csr[idx2 + SELL_C * 18] =
+                _2ak + _2zk * (0.75 * (-phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] -
+                                       phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)]) +
+                               2. * phi[im] +
+                               0.25 * (phi[ijk2im(ip1, jp1, k)] - phi[ijk2im(ip1, jm1, k)] -
+                                       phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)]));
 
             //---------------------------------------
 
-            idx_ch_csr[idx2 + 19] = ijk2idx(ip1, j, k);
-            val_ch_csr[idx2 + 19] =
+            val_ch_csr[idx2 + SELL_C * 19] =
                 u[0][ijk2im(ip1, j, k)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(ip1, j, k)] +
                 _2zk * (0.25 * (phi[ijk2im(ip1, jp1, k)] + phi[ijk2im(ip1, jm1, k)] + phi[ijk2im(ip1, j, kp1)] +
                                 phi[ijk2im(ip1, j, km1)] + phi[ijk2im(ip2, j, k)] - phi[ijk2im(im1, jp1, k)] -
@@ -2486,8 +2428,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                         3. * phi[ijk2im(ip1, j, k)] + 9. * phi[ijk2im(im1, j, k)] + phi[ijk2im(i, jp1, k)] +
                         phi[ijk2im(i, jm1, k)] + phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)] - 22. * phi[im]);
 
-            idx_ch_csr[idx2 + 20] = ijk2idx(im1, j, k);
-            val_ch_csr[idx2 + 20] =
+            val_ch_csr[idx2 + SELL_C * 20] =
                 -u[0][ijk2im(im1, j, k)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(im1, j, k)] +
                 _2zk * (0.25 * (phi[ijk2im(im1, jp1, k)] + phi[ijk2im(im1, jm1, k)] + phi[ijk2im(im1, j, kp1)] +
                                 phi[ijk2im(im1, j, km1)] + phi[ijk2im(im2, j, k)] - phi[ijk2im(ip1, jp1, k)] -
@@ -2498,8 +2439,7 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 21] = ijk2idx(i, jp1, k);
-            val_ch_csr[idx2 + 21] =
+            val_ch_csr[idx2 + SELL_C * 21] =
                 u[1][ijk2im(i, jp1, k)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(i, jp1, k)] +
                 _2zk * (0.25 * (phi[ijk2im(ip1, jp1, k)] + phi[ijk2im(im1, jp1, k)] + phi[ijk2im(i, jp1, kp1)] +
                                 phi[ijk2im(i, jp1, km1)] + phi[ijk2im(i, jp2, k)] - phi[ijk2im(ip1, jm1, k)] -
@@ -2508,8 +2448,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                         phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] - 3. * phi[ijk2im(i, jp1, k)] +
                         9. * phi[ijk2im(i, jm1, k)] + phi[ijk2im(i, j, kp1)] + phi[ijk2im(i, j, km1)] - 22. * phi[im]);
 
-            idx_ch_csr[idx2 + 22] = ijk2idx(i, jm1, k);
-            val_ch_csr[idx2 + 22] =
+            val_ch_csr[idx2 + SELL_C * 22] =
                 -u[1][ijk2im(i, jm1, k)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(i, jm1, k)] +
                 _2zk * (0.25 * (phi[ijk2im(ip1, jm1, k)] + phi[ijk2im(im1, jm1, k)] + phi[ijk2im(i, jm1, kp1)] +
                                 phi[ijk2im(i, jm1, km1)] + phi[ijk2im(i, jm2, k)] - phi[ijk2im(ip1, jp1, k)] -
@@ -2520,8 +2459,7 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //-----------------
 
-            idx_ch_csr[idx2 + 23] = ijk2idx(i, j, kp1);
-            val_ch_csr[idx2 + 23] =
+            val_ch_csr[idx2 + SELL_C * 23] =
                 u[2][ijk2im(i, j, kp1)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(i, j, kp1)] +
                 _2zk *
                     (0.25 * (phi[ijk2im(ip1, j, kp1)] + phi[ijk2im(im1, j, kp1)] + phi[ijk2im(i, jp1, kp1)] +
@@ -2531,8 +2469,7 @@ void CH_solver_implicit_bdfab(double *     psi,
                      phi[ijk2im(ip1, j, k)] + phi[ijk2im(im1, j, k)] + phi[ijk2im(i, jp1, k)] + phi[ijk2im(i, jm1, k)] -
                      3. * phi[ijk2im(i, j, kp1)] + 9. * phi[ijk2im(i, j, km1)] - 22. * phi[im]);
 
-            idx_ch_csr[idx2 + 24] = ijk2idx(i, j, km1);
-            val_ch_csr[idx2 + 24] =
+            val_ch_csr[idx2 + SELL_C * 24] =
                 -u[2][ijk2im(i, j, km1)] * INV_2DX - 12. * ak - 2. * kiDX2 * ps.d * phi[ijk2im(i, j, km1)] +
                 _2zk *
                     (0.25 * (phi[ijk2im(ip1, j, km1)] + phi[ijk2im(im1, j, km1)] + phi[ijk2im(i, jp1, km1)] +
@@ -2544,9 +2481,7 @@ void CH_solver_implicit_bdfab(double *     psi,
 
             //-----------------
 
-            ptr_ch[idx - is_ch + 1] = idx2 + 25;
         }
-        ptr_ch[0] = 0;
     }
 
 // const vector
@@ -2563,14 +2498,6 @@ void CH_solver_implicit_bdfab(double *     psi,
         int jm1 = adj(-1, j, NY);
         int km1 = adj(-1, k, NZ);
 
-        int ip2 = adj(2, i, NX);
-        int jp2 = adj(2, j, NY);
-        int kp2 = adj(2, k, NZ);
-
-        int im2 = adj(-2, i, NX);
-        int jm2 = adj(-2, j, NY);
-        int km2 = adj(-2, k, NZ);
-
         double psi_all_im   = psi_all[ijk2im(i, j, k)];
         double psi_all_o_im = psi_all_o[ijk2im(i, j, k)];
         double bs;
@@ -2649,7 +2576,8 @@ void CH_solver_implicit_bdfab(double *     psi,
     lis_matrix_assemble(A_ch);
     lis_solve(A_ch, b_ch, x_ch, lis_solver_ch);
 #else
-    bicgstab(idx_ch_csr, val_ch_csr, ptr_ch, b_ch, wm_ch, nval);
+    Set_initial_guess(&psi_all, 1, wm_ch);
+    bicgstab(idx_ch_csr, val_ch_csr, Ch_row_width(), b_ch, wm_ch, nval);
 #endif
 
     Cpy_v1(psi_o, psi);
@@ -2727,7 +2655,7 @@ void CH_solver_implicit_euler_OBL(double *     psi,
 
         int im = ijk2im(i, j, k);
 
-        int idx2 = 45 * (idx - is_ch);
+        int idx2 = sell_offset(idx - is_ch, 45);
 
         double _2zkp = _2zk * phi[im];
         double _4zkp = _2zkp * 2.;
@@ -2836,184 +2764,138 @@ void CH_solver_implicit_euler_OBL(double *     psi,
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 0] = ijk2idx(i, j, k);
-        val_ch_csr[idx2 + 0] = INV_DT + (42. + 29. * gt2 + 6. * gt4) * (ak + _2zkp) +
-                               4. * (3. + gt2) * kiDX2 * ps.d * phi[im] - _2zk * (2. * co11 + 2. * co22 + 2. * co33);
+        val_ch_csr[idx2] = INV_DT + (42. + 29. * gt2 + 6. * gt4) * (ak + _2zkp) +
+                           4. * (3. + gt2) * kiDX2 * ps.d * phi[im] - _2zk * (2. * co11 + 2. * co22 + 2. * co33);
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 1] = ijk2idx(ip2, j, k);
-        val_ch_csr[idx2 + 1] = (ak + _2zkp) * (1. + 1.5 * gt2 + gt4) + _2zk * co111;
+        val_ch_csr[idx2 + SELL_C * 1] = (ak + _2zkp) * (1. + 1.5 * gt2 + gt4) + _2zk * co111;
 
-        idx_ch_csr[idx2 + 2] = ijk2idx(im2, j, k);
-        val_ch_csr[idx2 + 2] = (ak + _2zkp) * (1. + 1.5 * gt2 + gt4) - _2zk * co111;
+        val_ch_csr[idx2 + SELL_C * 2] = (ak + _2zkp) * (1. + 1.5 * gt2 + gt4) - _2zk * co111;
 
-        idx_ch_csr[idx2 + 3] = ijk2idx(i, jp2, k);
-        val_ch_csr[idx2 + 3] = (ak + _2zkp) * (1. - 0.5 * gt2) + _2zk * co222;
+        val_ch_csr[idx2 + SELL_C * 3] = (ak + _2zkp) * (1. - 0.5 * gt2) + _2zk * co222;
 
-        idx_ch_csr[idx2 + 4] = ijk2idx(i, jm2, k);
-        val_ch_csr[idx2 + 4] = (ak + _2zkp) * (1. - 0.5 * gt2) - _2zk * co222;
+        val_ch_csr[idx2 + SELL_C * 4] = (ak + _2zkp) * (1. - 0.5 * gt2) - _2zk * co222;
 
-        idx_ch_csr[idx2 + 5] = ijk2idx(i, j, kp2);
-        val_ch_csr[idx2 + 5] = (ak + _2zkp) + _2zk * co333;
+        val_ch_csr[idx2 + SELL_C * 5] = (ak + _2zkp) + _2zk * co333;
 
-        idx_ch_csr[idx2 + 6] = ijk2idx(i, j, km2);
-        val_ch_csr[idx2 + 6] = (ak + _2zkp) - _2zk * co333;
+        val_ch_csr[idx2 + SELL_C * 6] = (ak + _2zkp) - _2zk * co333;
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 7] = ijk2idx(i, jp1, kp1);
-        val_ch_csr[idx2 + 7] = (_2ak + _4zkp) + _2zk * (co23 + co223 + co233);
+        val_ch_csr[idx2 + SELL_C * 7] = (_2ak + _4zkp) + _2zk * (co23 + co223 + co233);
 
-        idx_ch_csr[idx2 + 8] = ijk2idx(i, jp1, km1);
-        val_ch_csr[idx2 + 8] = (_2ak + _4zkp) + _2zk * (-co23 - co223 + co233);
+        val_ch_csr[idx2 + SELL_C * 8] = (_2ak + _4zkp) + _2zk * (-co23 - co223 + co233);
 
-        idx_ch_csr[idx2 + 9] = ijk2idx(i, jm1, kp1);
-        val_ch_csr[idx2 + 9] = (_2ak + _4zkp) + _2zk * (-co23 + co223 - co233);
+        val_ch_csr[idx2 + SELL_C * 9] = (_2ak + _4zkp) + _2zk * (-co23 + co223 - co233);
 
-        idx_ch_csr[idx2 + 10] = ijk2idx(i, jm1, km1);
-        val_ch_csr[idx2 + 10] = (_2ak + _4zkp) + _2zk * (co23 - co223 - co233);
+        val_ch_csr[idx2 + SELL_C * 10] = (_2ak + _4zkp) + _2zk * (co23 - co223 - co233);
 
         //-----------------
 
-        idx_ch_csr[idx2 + 11] = ijk2idx(ip1, j, kp1);
-        val_ch_csr[idx2 + 11] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (co31 + co113 + co133);
+        val_ch_csr[idx2 + SELL_C * 11] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (co31 + co113 + co133);
 
-        idx_ch_csr[idx2 + 12] = ijk2idx(ip1, j, km1);
-        val_ch_csr[idx2 + 12] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (-co31 - co113 + co133);
+        val_ch_csr[idx2 + SELL_C * 12] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (-co31 - co113 + co133);
 
-        idx_ch_csr[idx2 + 13] = ijk2idx(im1, j, kp1);
-        val_ch_csr[idx2 + 13] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (-co31 + co113 - co133);
+        val_ch_csr[idx2 + SELL_C * 13] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (-co31 + co113 - co133);
 
-        idx_ch_csr[idx2 + 14] = ijk2idx(im1, j, km1);
-        val_ch_csr[idx2 + 14] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (co31 - co113 - co133);
+        val_ch_csr[idx2 + SELL_C * 14] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (co31 - co113 - co133);
 
         //-----------------
-        idx_ch_csr[idx2 + 15] = ijk2idx(ip1, jp1, k);
-        val_ch_csr[idx2 + 15] = (_2ak + _4zkp) * (1. + 3. * gt + gt2 + gt3) +
-                                ps.d * kiDX2 * gt * phi[ijk2im(ip1, jp1, k)] + _2zk * (co12 + co112 + co122);
+        val_ch_csr[idx2 + SELL_C * 15] = (_2ak + _4zkp) * (1. + 3. * gt + gt2 + gt3) +
+                                         ps.d * kiDX2 * gt * phi[ijk2im(ip1, jp1, k)] + _2zk * (co12 + co112 + co122);
 
-        idx_ch_csr[idx2 + 16] = ijk2idx(ip1, jm1, k);
-        val_ch_csr[idx2 + 16] = (_2ak + _4zkp) * (1. - 3. * gt + gt2 - gt3) -
-                                ps.d * kiDX2 * gt * phi[ijk2im(ip1, jm1, k)] + _2zk * (-co12 - co112 + co122);
+        val_ch_csr[idx2 + SELL_C * 16] = (_2ak + _4zkp) * (1. - 3. * gt + gt2 - gt3) -
+                                         ps.d * kiDX2 * gt * phi[ijk2im(ip1, jm1, k)] + _2zk * (-co12 - co112 + co122);
 
-        idx_ch_csr[idx2 + 17] = ijk2idx(im1, jp1, k);
-        val_ch_csr[idx2 + 17] = (_2ak + _4zkp) * (1. - 3. * gt + gt2 - gt3) -
-                                ps.d * kiDX2 * gt * phi[ijk2im(im1, jp1, k)] + _2zk * (-co12 + co112 - co122);
+        val_ch_csr[idx2 + SELL_C * 17] = (_2ak + _4zkp) * (1. - 3. * gt + gt2 - gt3) -
+                                         ps.d * kiDX2 * gt * phi[ijk2im(im1, jp1, k)] + _2zk * (-co12 + co112 - co122);
 
-        idx_ch_csr[idx2 + 18] = ijk2idx(im1, jm1, k);
-        val_ch_csr[idx2 + 18] = (_2ak + _4zkp) * (1. + 3. * gt + gt2 + gt3) +
-                                ps.d * kiDX2 * gt * phi[ijk2im(im1, jm1, k)] + _2zk * (co12 - co112 - co122);
+        val_ch_csr[idx2 + SELL_C * 18] = (_2ak + _4zkp) * (1. + 3. * gt + gt2 + gt3) +
+                                         ps.d * kiDX2 * gt * phi[ijk2im(im1, jm1, k)] + _2zk * (co12 - co112 - co122);
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 19] = ijk2idx(ip1, j, k);
-        val_ch_csr[idx2 + 19] = u[0][ijk2im(ip1, j, k)] * INV_2DX - 4. * (3. + 4. * gt2 + gt4) * (ak + _2zkp) -
-                                (1. + gt2) * 2. * kiDX2 * ps.d * phi[ijk2im(ip1, j, k)] +
-                                _2zk * (co1 + co11 - 2. * co111 - 2. * co122 - 2. * co133);
+        val_ch_csr[idx2 + SELL_C * 19] = u[0][ijk2im(ip1, j, k)] * INV_2DX - 4. * (3. + 4. * gt2 + gt4) * (ak + _2zkp) -
+                                         (1. + gt2) * 2. * kiDX2 * ps.d * phi[ijk2im(ip1, j, k)] +
+                                         _2zk * (co1 + co11 - 2. * co111 - 2. * co122 - 2. * co133);
 
-        idx_ch_csr[idx2 + 20] = ijk2idx(im1, j, k);
-        val_ch_csr[idx2 + 20] = -u[0][ijk2im(im1, j, k)] * INV_2DX - 4. * (3. + 4. * gt2 + gt4) * (ak + _2zkp) -
-                                (1. + gt2) * 2. * kiDX2 * ps.d * phi[ijk2im(im1, j, k)] +
-                                _2zk * (-co1 + co11 + 2. * co111 + 2. * co122 + 2. * co133);
+        val_ch_csr[idx2 + SELL_C * 20] =
+            -u[0][ijk2im(im1, j, k)] * INV_2DX - 4. * (3. + 4. * gt2 + gt4) * (ak + _2zkp) -
+            (1. + gt2) * 2. * kiDX2 * ps.d * phi[ijk2im(im1, j, k)] +
+            _2zk * (-co1 + co11 + 2. * co111 + 2. * co122 + 2. * co133);
 
         //-----------------
 
-        idx_ch_csr[idx2 + 21] = ijk2idx(i, jp1, k);
-        val_ch_csr[idx2 + 21] = u[1][ijk2im(i, jp1, k)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
-                                2. * kiDX2 * ps.d * phi[ijk2im(i, jp1, k)] +
-                                _2zk * (co2 + co22 - 2. * co222 - 2. * co112 - 2. * co233);
+        val_ch_csr[idx2 + SELL_C * 21] = u[1][ijk2im(i, jp1, k)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
+                                         2. * kiDX2 * ps.d * phi[ijk2im(i, jp1, k)] +
+                                         _2zk * (co2 + co22 - 2. * co222 - 2. * co112 - 2. * co233);
 
-        idx_ch_csr[idx2 + 22] = ijk2idx(i, jm1, k);
-        val_ch_csr[idx2 + 22] = -u[1][ijk2im(i, jm1, k)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
-                                2. * kiDX2 * ps.d * phi[ijk2im(i, jm1, k)] +
-                                _2zk * (-co2 + co22 + 2. * co222 + 2. * co112 + 2. * co233);
+        val_ch_csr[idx2 + SELL_C * 22] = -u[1][ijk2im(i, jm1, k)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
+                                         2. * kiDX2 * ps.d * phi[ijk2im(i, jm1, k)] +
+                                         _2zk * (-co2 + co22 + 2. * co222 + 2. * co112 + 2. * co233);
 
         //-----------------
 
-        idx_ch_csr[idx2 + 23] = ijk2idx(i, j, kp1);
-        val_ch_csr[idx2 + 23] = u[2][ijk2im(i, j, kp1)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
-                                2. * kiDX2 * ps.d * phi[ijk2im(i, j, kp1)] +
-                                _2zk * (co3 + co33 - 2. * co333 - 2. * co113 - 2. * co223);
+        val_ch_csr[idx2 + SELL_C * 23] = u[2][ijk2im(i, j, kp1)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
+                                         2. * kiDX2 * ps.d * phi[ijk2im(i, j, kp1)] +
+                                         _2zk * (co3 + co33 - 2. * co333 - 2. * co113 - 2. * co223);
 
-        idx_ch_csr[idx2 + 24] = ijk2idx(i, j, km1);
-        val_ch_csr[idx2 + 24] = -u[2][ijk2im(i, j, km1)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
-                                2. * kiDX2 * ps.d * phi[ijk2im(i, j, km1)] +
-                                _2zk * (-co3 + co33 + 2. * co333 + 2. * co113 + 2. * co223);
+        val_ch_csr[idx2 + SELL_C * 24] = -u[2][ijk2im(i, j, km1)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
+                                         2. * kiDX2 * ps.d * phi[ijk2im(i, j, km1)] +
+                                         _2zk * (-co3 + co33 + 2. * co333 + 2. * co113 + 2. * co223);
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 25] = ijk2idx(ip1, jp1, kp1);
-        val_ch_csr[idx2 + 25] = -(ak + _2zkp) * gt + _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 25] = -(ak + _2zkp) * gt + _2zk * co123;
 
-        idx_ch_csr[idx2 + 26] = ijk2idx(ip1, jp1, km1);
-        val_ch_csr[idx2 + 26] = -(ak + _2zkp) * gt - _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 26] = -(ak + _2zkp) * gt - _2zk * co123;
 
-        idx_ch_csr[idx2 + 27] = ijk2idx(im1, jm1, kp1);
-        val_ch_csr[idx2 + 27] = -(ak + _2zkp) * gt + _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 27] = -(ak + _2zkp) * gt + _2zk * co123;
 
-        idx_ch_csr[idx2 + 28] = ijk2idx(im1, jm1, km1);
-        val_ch_csr[idx2 + 28] = -(ak + _2zkp) * gt - _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 28] = -(ak + _2zkp) * gt - _2zk * co123;
 
-        idx_ch_csr[idx2 + 29] = ijk2idx(ip1, jp2, k);
-        val_ch_csr[idx2 + 29] = -(ak + _2zkp) * gt;
+        val_ch_csr[idx2 + SELL_C * 29] = -(ak + _2zkp) * gt;
 
-        idx_ch_csr[idx2 + 30] = ijk2idx(im1, jm2, k);
-        val_ch_csr[idx2 + 30] = -(ak + _2zkp) * gt;
+        val_ch_csr[idx2 + SELL_C * 30] = -(ak + _2zkp) * gt;
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 31] = ijk2idx(ip1, jm1, kp1);
-        val_ch_csr[idx2 + 31] = (ak + _2zkp) * gt - _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 31] = (ak + _2zkp) * gt - _2zk * co123;
 
-        idx_ch_csr[idx2 + 32] = ijk2idx(ip1, jm1, km1);
-        val_ch_csr[idx2 + 32] = (ak + _2zkp) * gt + _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 32] = (ak + _2zkp) * gt + _2zk * co123;
 
-        idx_ch_csr[idx2 + 33] = ijk2idx(im1, jp1, kp1);
-        val_ch_csr[idx2 + 33] = (ak + _2zkp) * gt - _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 33] = (ak + _2zkp) * gt - _2zk * co123;
 
-        idx_ch_csr[idx2 + 34] = ijk2idx(im1, jp1, km1);
-        val_ch_csr[idx2 + 34] = (ak + _2zkp) * gt + _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 34] = (ak + _2zkp) * gt + _2zk * co123;
 
-        idx_ch_csr[idx2 + 35] = ijk2idx(ip1, jm2, k);
-        val_ch_csr[idx2 + 35] = (ak + _2zkp) * gt;
+        val_ch_csr[idx2 + SELL_C * 35] = (ak + _2zkp) * gt;
 
-        idx_ch_csr[idx2 + 36] = ijk2idx(im1, jp2, k);
-        val_ch_csr[idx2 + 36] = (ak + _2zkp) * gt;
+        val_ch_csr[idx2 + SELL_C * 36] = (ak + _2zkp) * gt;
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 37] = ijk2idx(ip2, jp1, k);
-        val_ch_csr[idx2 + 37] = -(ak + _2zkp) * gt * (1. + gt2);
+        val_ch_csr[idx2 + SELL_C * 37] = -(ak + _2zkp) * gt * (1. + gt2);
 
-        idx_ch_csr[idx2 + 38] = ijk2idx(im2, jm1, k);
-        val_ch_csr[idx2 + 38] = -(ak + _2zkp) * gt * (1. + gt2);
+        val_ch_csr[idx2 + SELL_C * 38] = -(ak + _2zkp) * gt * (1. + gt2);
 
         //-----------------
 
-        idx_ch_csr[idx2 + 39] = ijk2idx(ip2, jm1, k);
-        val_ch_csr[idx2 + 39] = (ak + _2zkp) * gt * (1. + gt2);
+        val_ch_csr[idx2 + SELL_C * 39] = (ak + _2zkp) * gt * (1. + gt2);
 
-        idx_ch_csr[idx2 + 40] = ijk2idx(im2, jp1, k);
-        val_ch_csr[idx2 + 40] = (ak + _2zkp) * gt * (1. + gt2);
+        val_ch_csr[idx2 + SELL_C * 40] = (ak + _2zkp) * gt * (1. + gt2);
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 41] = ijk2idx(ip2, jp2, k);
-        val_ch_csr[idx2 + 41] = (ak + _2zkp) * gt2 * 0.25;
+        val_ch_csr[idx2 + SELL_C * 41] = (ak + _2zkp) * gt2 * 0.25;
 
-        idx_ch_csr[idx2 + 42] = ijk2idx(im2, jm2, k);
-        val_ch_csr[idx2 + 42] = (ak + _2zkp) * gt2 * 0.25;
+        val_ch_csr[idx2 + SELL_C * 42] = (ak + _2zkp) * gt2 * 0.25;
 
-        idx_ch_csr[idx2 + 43] = ijk2idx(ip2, jm2, k);
-        val_ch_csr[idx2 + 43] = (ak + _2zkp) * gt2 * 0.25;
+        val_ch_csr[idx2 + SELL_C * 43] = (ak + _2zkp) * gt2 * 0.25;
 
-        idx_ch_csr[idx2 + 44] = ijk2idx(im2, jp2, k);
-        val_ch_csr[idx2 + 44] = (ak + _2zkp) * gt2 * 0.25;
+        val_ch_csr[idx2 + SELL_C * 44] = (ak + _2zkp) * gt2 * 0.25;
 
-        ptr_ch[idx - is_ch + 1] = idx2 + 45;
     }
-    ptr_ch[0] = 0;
 
     // const vector
 #pragma omp parallel for
@@ -3077,7 +2959,8 @@ void CH_solver_implicit_euler_OBL(double *     psi,
     //	printf("%d CH matrix solver iter = %d\n", jikan.ts, iter);
     //}
 #else
-    bicgstab(idx_ch_csr, val_ch_csr, ptr_ch, b_ch, wm_ch, nval);
+    Set_initial_guess(&psi, 1, wm_ch);
+    bicgstab(idx_ch_csr, val_ch_csr, Ch_row_width(), b_ch, wm_ch, nval);
 #endif
 
     Cpy_v1(psi_o, psi);
@@ -3153,7 +3036,7 @@ void CH_solver_implicit_bdfab_OBL(double *     psi,
 
         int im = ijk2im(i, j, k);
 
-        int idx2 = 45 * (idx - is_ch);
+        int idx2 = sell_offset(idx - is_ch, 45);
 
         double _2zkp = _2zk * phi[im];
         double _4zkp = _2zkp * 2.;
@@ -3262,184 +3145,138 @@ void CH_solver_implicit_bdfab_OBL(double *     psi,
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 0] = ijk2idx(i, j, k);
-        val_ch_csr[idx2 + 0] = 1.5 * INV_DT + (42. + 29. * gt2 + 6. * gt4) * (ak + _2zkp) +
-                               4. * (3. + gt2) * kiDX2 * ps.d * phi[im] - _2zk * (2. * co11 + 2. * co22 + 2. * co33);
+        val_ch_csr[idx2] = 1.5 * INV_DT + (42. + 29. * gt2 + 6. * gt4) * (ak + _2zkp) +
+                           4. * (3. + gt2) * kiDX2 * ps.d * phi[im] - _2zk * (2. * co11 + 2. * co22 + 2. * co33);
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 1] = ijk2idx(ip2, j, k);
-        val_ch_csr[idx2 + 1] = (ak + _2zkp) * (1. + 1.5 * gt2 + gt4) + _2zk * co111;
+        val_ch_csr[idx2 + SELL_C * 1] = (ak + _2zkp) * (1. + 1.5 * gt2 + gt4) + _2zk * co111;
 
-        idx_ch_csr[idx2 + 2] = ijk2idx(im2, j, k);
-        val_ch_csr[idx2 + 2] = (ak + _2zkp) * (1. + 1.5 * gt2 + gt4) - _2zk * co111;
+        val_ch_csr[idx2 + SELL_C * 2] = (ak + _2zkp) * (1. + 1.5 * gt2 + gt4) - _2zk * co111;
 
-        idx_ch_csr[idx2 + 3] = ijk2idx(i, jp2, k);
-        val_ch_csr[idx2 + 3] = (ak + _2zkp) * (1. - 0.5 * gt2) + _2zk * co222;
+        val_ch_csr[idx2 + SELL_C * 3] = (ak + _2zkp) * (1. - 0.5 * gt2) + _2zk * co222;
 
-        idx_ch_csr[idx2 + 4] = ijk2idx(i, jm2, k);
-        val_ch_csr[idx2 + 4] = (ak + _2zkp) * (1. - 0.5 * gt2) - _2zk * co222;
+        val_ch_csr[idx2 + SELL_C * 4] = (ak + _2zkp) * (1. - 0.5 * gt2) - _2zk * co222;
 
-        idx_ch_csr[idx2 + 5] = ijk2idx(i, j, kp2);
-        val_ch_csr[idx2 + 5] = (ak + _2zkp) + _2zk * co333;
+        val_ch_csr[idx2 + SELL_C * 5] = (ak + _2zkp) + _2zk * co333;
 
-        idx_ch_csr[idx2 + 6] = ijk2idx(i, j, km2);
-        val_ch_csr[idx2 + 6] = (ak + _2zkp) - _2zk * co333;
+        val_ch_csr[idx2 + SELL_C * 6] = (ak + _2zkp) - _2zk * co333;
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 7] = ijk2idx(i, jp1, kp1);
-        val_ch_csr[idx2 + 7] = (_2ak + _4zkp) + _2zk * (co23 + co223 + co233);
+        val_ch_csr[idx2 + SELL_C * 7] = (_2ak + _4zkp) + _2zk * (co23 + co223 + co233);
 
-        idx_ch_csr[idx2 + 8] = ijk2idx(i, jp1, km1);
-        val_ch_csr[idx2 + 8] = (_2ak + _4zkp) + _2zk * (-co23 - co223 + co233);
+        val_ch_csr[idx2 + SELL_C * 8] = (_2ak + _4zkp) + _2zk * (-co23 - co223 + co233);
 
-        idx_ch_csr[idx2 + 9] = ijk2idx(i, jm1, kp1);
-        val_ch_csr[idx2 + 9] = (_2ak + _4zkp) + _2zk * (-co23 + co223 - co233);
+        val_ch_csr[idx2 + SELL_C * 9] = (_2ak + _4zkp) + _2zk * (-co23 + co223 - co233);
 
-        idx_ch_csr[idx2 + 10] = ijk2idx(i, jm1, km1);
-        val_ch_csr[idx2 + 10] = (_2ak + _4zkp) + _2zk * (co23 - co223 - co233);
+        val_ch_csr[idx2 + SELL_C * 10] = (_2ak + _4zkp) + _2zk * (co23 - co223 - co233);
 
         //-----------------
 
-        idx_ch_csr[idx2 + 11] = ijk2idx(ip1, j, kp1);
-        val_ch_csr[idx2 + 11] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (co31 + co113 + co133);
+        val_ch_csr[idx2 + SELL_C * 11] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (co31 + co113 + co133);
 
-        idx_ch_csr[idx2 + 12] = ijk2idx(ip1, j, km1);
-        val_ch_csr[idx2 + 12] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (-co31 - co113 + co133);
+        val_ch_csr[idx2 + SELL_C * 12] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (-co31 - co113 + co133);
 
-        idx_ch_csr[idx2 + 13] = ijk2idx(im1, j, kp1);
-        val_ch_csr[idx2 + 13] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (-co31 + co113 - co133);
+        val_ch_csr[idx2 + SELL_C * 13] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (-co31 + co113 - co133);
 
-        idx_ch_csr[idx2 + 14] = ijk2idx(im1, j, km1);
-        val_ch_csr[idx2 + 14] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (co31 - co113 - co133);
+        val_ch_csr[idx2 + SELL_C * 14] = (_2ak + _4zkp) * (1. + gt2) + _2zk * (co31 - co113 - co133);
 
         //-----------------
-        idx_ch_csr[idx2 + 15] = ijk2idx(ip1, jp1, k);
-        val_ch_csr[idx2 + 15] = (_2ak + _4zkp) * (1. + 3. * gt + gt2 + gt3) +
-                                ps.d * kiDX2 * gt * phi[ijk2im(ip1, jp1, k)] + _2zk * (co12 + co112 + co122);
+        val_ch_csr[idx2 + SELL_C * 15] = (_2ak + _4zkp) * (1. + 3. * gt + gt2 + gt3) +
+                                         ps.d * kiDX2 * gt * phi[ijk2im(ip1, jp1, k)] + _2zk * (co12 + co112 + co122);
 
-        idx_ch_csr[idx2 + 16] = ijk2idx(ip1, jm1, k);
-        val_ch_csr[idx2 + 16] = (_2ak + _4zkp) * (1. - 3. * gt + gt2 - gt3) -
-                                ps.d * kiDX2 * gt * phi[ijk2im(ip1, jm1, k)] + _2zk * (-co12 - co112 + co122);
+        val_ch_csr[idx2 + SELL_C * 16] = (_2ak + _4zkp) * (1. - 3. * gt + gt2 - gt3) -
+                                         ps.d * kiDX2 * gt * phi[ijk2im(ip1, jm1, k)] + _2zk * (-co12 - co112 + co122);
 
-        idx_ch_csr[idx2 + 17] = ijk2idx(im1, jp1, k);
-        val_ch_csr[idx2 + 17] = (_2ak + _4zkp) * (1. - 3. * gt + gt2 - gt3) -
-                                ps.d * kiDX2 * gt * phi[ijk2im(im1, jp1, k)] + _2zk * (-co12 + co112 - co122);
+        val_ch_csr[idx2 + SELL_C * 17] = (_2ak + _4zkp) * (1. - 3. * gt + gt2 - gt3) -
+                                         ps.d * kiDX2 * gt * phi[ijk2im(im1, jp1, k)] + _2zk * (-co12 + co112 - co122);
 
-        idx_ch_csr[idx2 + 18] = ijk2idx(im1, jm1, k);
-        val_ch_csr[idx2 + 18] = (_2ak + _4zkp) * (1. + 3. * gt + gt2 + gt3) +
-                                ps.d * kiDX2 * gt * phi[ijk2im(im1, jm1, k)] + _2zk * (co12 - co112 - co122);
+        val_ch_csr[idx2 + SELL_C * 18] = (_2ak + _4zkp) * (1. + 3. * gt + gt2 + gt3) +
+                                         ps.d * kiDX2 * gt * phi[ijk2im(im1, jm1, k)] + _2zk * (co12 - co112 - co122);
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 19] = ijk2idx(ip1, j, k);
-        val_ch_csr[idx2 + 19] = u[0][ijk2im(ip1, j, k)] * INV_2DX - 4. * (3. + 4. * gt2 + gt4) * (ak + _2zkp) -
-                                (1. + gt2) * 2. * kiDX2 * ps.d * phi[ijk2im(ip1, j, k)] +
-                                _2zk * (co1 + co11 - 2. * co111 - 2. * co122 - 2. * co133);
+        val_ch_csr[idx2 + SELL_C * 19] = u[0][ijk2im(ip1, j, k)] * INV_2DX - 4. * (3. + 4. * gt2 + gt4) * (ak + _2zkp) -
+                                         (1. + gt2) * 2. * kiDX2 * ps.d * phi[ijk2im(ip1, j, k)] +
+                                         _2zk * (co1 + co11 - 2. * co111 - 2. * co122 - 2. * co133);
 
-        idx_ch_csr[idx2 + 20] = ijk2idx(im1, j, k);
-        val_ch_csr[idx2 + 20] = -u[0][ijk2im(im1, j, k)] * INV_2DX - 4. * (3. + 4. * gt2 + gt4) * (ak + _2zkp) -
-                                (1. + gt2) * 2. * kiDX2 * ps.d * phi[ijk2im(im1, j, k)] +
-                                _2zk * (-co1 + co11 + 2. * co111 + 2. * co122 + 2. * co133);
+        val_ch_csr[idx2 + SELL_C * 20] =
+            -u[0][ijk2im(im1, j, k)] * INV_2DX - 4. * (3. + 4. * gt2 + gt4) * (ak + _2zkp) -
+            (1. + gt2) * 2. * kiDX2 * ps.d * phi[ijk2im(im1, j, k)] +
+            _2zk * (-co1 + co11 + 2. * co111 + 2. * co122 + 2. * co133);
 
         //-----------------
 
-        idx_ch_csr[idx2 + 21] = ijk2idx(i, jp1, k);
-        val_ch_csr[idx2 + 21] = u[1][ijk2im(i, jp1, k)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
-                                2. * kiDX2 * ps.d * phi[ijk2im(i, jp1, k)] +
-                                _2zk * (co2 + co22 - 2. * co222 - 2. * co112 - 2. * co233);
+        val_ch_csr[idx2 + SELL_C * 21] = u[1][ijk2im(i, jp1, k)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
+                                         2. * kiDX2 * ps.d * phi[ijk2im(i, jp1, k)] +
+                                         _2zk * (co2 + co22 - 2. * co222 - 2. * co112 - 2. * co233);
 
-        idx_ch_csr[idx2 + 22] = ijk2idx(i, jm1, k);
-        val_ch_csr[idx2 + 22] = -u[1][ijk2im(i, jm1, k)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
-                                2. * kiDX2 * ps.d * phi[ijk2im(i, jm1, k)] +
-                                _2zk * (-co2 + co22 + 2. * co222 + 2. * co112 + 2. * co233);
+        val_ch_csr[idx2 + SELL_C * 22] = -u[1][ijk2im(i, jm1, k)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
+                                         2. * kiDX2 * ps.d * phi[ijk2im(i, jm1, k)] +
+                                         _2zk * (-co2 + co22 + 2. * co222 + 2. * co112 + 2. * co233);
 
         //-----------------
 
-        idx_ch_csr[idx2 + 23] = ijk2idx(i, j, kp1);
-        val_ch_csr[idx2 + 23] = u[2][ijk2im(i, j, kp1)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
-                                2. * kiDX2 * ps.d * phi[ijk2im(i, j, kp1)] +
-                                _2zk * (co3 + co33 - 2. * co333 - 2. * co113 - 2. * co223);
+        val_ch_csr[idx2 + SELL_C * 23] = u[2][ijk2im(i, j, kp1)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
+                                         2. * kiDX2 * ps.d * phi[ijk2im(i, j, kp1)] +
+                                         _2zk * (co3 + co33 - 2. * co333 - 2. * co113 - 2. * co223);
 
-        idx_ch_csr[idx2 + 24] = ijk2idx(i, j, km1);
-        val_ch_csr[idx2 + 24] = -u[2][ijk2im(i, j, km1)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
-                                2. * kiDX2 * ps.d * phi[ijk2im(i, j, km1)] +
-                                _2zk * (-co3 + co33 + 2. * co333 + 2. * co113 + 2. * co223);
+        val_ch_csr[idx2 + SELL_C * 24] = -u[2][ijk2im(i, j, km1)] * INV_2DX - 4. * (3. + gt2) * (ak + _2zkp) -
+                                         2. * kiDX2 * ps.d * phi[ijk2im(i, j, km1)] +
+                                         _2zk * (-co3 + co33 + 2. * co333 + 2. * co113 + 2. * co223);
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 25] = ijk2idx(ip1, jp1, kp1);
-        val_ch_csr[idx2 + 25] = -(ak + _2zkp) * gt + _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 25] = -(ak + _2zkp) * gt + _2zk * co123;
 
-        idx_ch_csr[idx2 + 26] = ijk2idx(ip1, jp1, km1);
-        val_ch_csr[idx2 + 26] = -(ak + _2zkp) * gt - _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 26] = -(ak + _2zkp) * gt - _2zk * co123;
 
-        idx_ch_csr[idx2 + 27] = ijk2idx(im1, jm1, kp1);
-        val_ch_csr[idx2 + 27] = -(ak + _2zkp) * gt + _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 27] = -(ak + _2zkp) * gt + _2zk * co123;
 
-        idx_ch_csr[idx2 + 28] = ijk2idx(im1, jm1, km1);
-        val_ch_csr[idx2 + 28] = -(ak + _2zkp) * gt - _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 28] = -(ak + _2zkp) * gt - _2zk * co123;
 
-        idx_ch_csr[idx2 + 29] = ijk2idx(ip1, jp2, k);
-        val_ch_csr[idx2 + 29] = -(ak + _2zkp) * gt;
+        val_ch_csr[idx2 + SELL_C * 29] = -(ak + _2zkp) * gt;
 
-        idx_ch_csr[idx2 + 30] = ijk2idx(im1, jm2, k);
-        val_ch_csr[idx2 + 30] = -(ak + _2zkp) * gt;
+        val_ch_csr[idx2 + SELL_C * 30] = -(ak + _2zkp) * gt;
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 31] = ijk2idx(ip1, jm1, kp1);
-        val_ch_csr[idx2 + 31] = (ak + _2zkp) * gt - _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 31] = (ak + _2zkp) * gt - _2zk * co123;
 
-        idx_ch_csr[idx2 + 32] = ijk2idx(ip1, jm1, km1);
-        val_ch_csr[idx2 + 32] = (ak + _2zkp) * gt + _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 32] = (ak + _2zkp) * gt + _2zk * co123;
 
-        idx_ch_csr[idx2 + 33] = ijk2idx(im1, jp1, kp1);
-        val_ch_csr[idx2 + 33] = (ak + _2zkp) * gt - _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 33] = (ak + _2zkp) * gt - _2zk * co123;
 
-        idx_ch_csr[idx2 + 34] = ijk2idx(im1, jp1, km1);
-        val_ch_csr[idx2 + 34] = (ak + _2zkp) * gt + _2zk * co123;
+        val_ch_csr[idx2 + SELL_C * 34] = (ak + _2zkp) * gt + _2zk * co123;
 
-        idx_ch_csr[idx2 + 35] = ijk2idx(ip1, jm2, k);
-        val_ch_csr[idx2 + 35] = (ak + _2zkp) * gt;
+        val_ch_csr[idx2 + SELL_C * 35] = (ak + _2zkp) * gt;
 
-        idx_ch_csr[idx2 + 36] = ijk2idx(im1, jp2, k);
-        val_ch_csr[idx2 + 36] = (ak + _2zkp) * gt;
+        val_ch_csr[idx2 + SELL_C * 36] = (ak + _2zkp) * gt;
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 37] = ijk2idx(ip2, jp1, k);
-        val_ch_csr[idx2 + 37] = -(ak + _2zkp) * gt * (1. + gt2);
+        val_ch_csr[idx2 + SELL_C * 37] = -(ak + _2zkp) * gt * (1. + gt2);
 
-        idx_ch_csr[idx2 + 38] = ijk2idx(im2, jm1, k);
-        val_ch_csr[idx2 + 38] = -(ak + _2zkp) * gt * (1. + gt2);
+        val_ch_csr[idx2 + SELL_C * 38] = -(ak + _2zkp) * gt * (1. + gt2);
 
         //-----------------
 
-        idx_ch_csr[idx2 + 39] = ijk2idx(ip2, jm1, k);
-        val_ch_csr[idx2 + 39] = (ak + _2zkp) * gt * (1. + gt2);
+        val_ch_csr[idx2 + SELL_C * 39] = (ak + _2zkp) * gt * (1. + gt2);
 
-        idx_ch_csr[idx2 + 40] = ijk2idx(im2, jp1, k);
-        val_ch_csr[idx2 + 40] = (ak + _2zkp) * gt * (1. + gt2);
+        val_ch_csr[idx2 + SELL_C * 40] = (ak + _2zkp) * gt * (1. + gt2);
 
         //---------------------------------------
 
-        idx_ch_csr[idx2 + 41] = ijk2idx(ip2, jp2, k);
-        val_ch_csr[idx2 + 41] = (ak + _2zkp) * gt2 * 0.25;
+        val_ch_csr[idx2 + SELL_C * 41] = (ak + _2zkp) * gt2 * 0.25;
 
-        idx_ch_csr[idx2 + 42] = ijk2idx(im2, jm2, k);
-        val_ch_csr[idx2 + 42] = (ak + _2zkp) * gt2 * 0.25;
+        val_ch_csr[idx2 + SELL_C * 42] = (ak + _2zkp) * gt2 * 0.25;
 
-        idx_ch_csr[idx2 + 43] = ijk2idx(ip2, jm2, k);
-        val_ch_csr[idx2 + 43] = (ak + _2zkp) * gt2 * 0.25;
+        val_ch_csr[idx2 + SELL_C * 43] = (ak + _2zkp) * gt2 * 0.25;
 
-        idx_ch_csr[idx2 + 44] = ijk2idx(im2, jp2, k);
-        val_ch_csr[idx2 + 44] = (ak + _2zkp) * gt2 * 0.25;
+        val_ch_csr[idx2 + SELL_C * 44] = (ak + _2zkp) * gt2 * 0.25;
 
-        ptr_ch[idx - is_ch + 1] = idx2 + 45;
     }
-    ptr_ch[0] = 0;
 
     // const vector
 #pragma omp parallel for
@@ -3509,7 +3346,8 @@ void CH_solver_implicit_bdfab_OBL(double *     psi,
     lis_matrix_assemble(A_ch);
     lis_solve(A_ch, b_ch, x_ch, lis_solver_ch);
 #else
-    bicgstab(idx_ch_csr, val_ch_csr, ptr_ch, b_ch, wm_ch, nval);
+    Set_initial_guess(&psi, 1, wm_ch);
+    bicgstab(idx_ch_csr, val_ch_csr, Ch_row_width(), b_ch, wm_ch, nval);
 #endif
 
     Cpy_v1(psi_o, psi);
@@ -3549,15 +3387,7 @@ void Mem_alloc_lis(void) {
         }
     }
 
-    if (SW_EQ == Navier_Stokes_Cahn_Hilliard_FDM) {
-        if (ps.psi_dry != 0.0) {
-            nnzval_ch = nval_ch * 43;
-        } else {
-            nnzval_ch = nval_ch * 25;
-        }
-    } else if (SW_EQ == Shear_NS_LE_CH_FDM) {
-        nnzval_ch = nval_ch * 45;
-    }
+    nnzval_ch = sell_size(nval_ch, Ch_row_width());
 
     lis_matrix_malloc_csr(NX * NY * NZ * DIM, nnzval_ns, &ptr_ns, &idx_ns_csr, &val_ns_csr);
     lis_matrix_create(LIS_COMM_WORLD, &A_ns);
@@ -3594,32 +3424,237 @@ void Init_lis(int argc, char *argv[]) {
     lis_vector_duplicate(A_ch, &b_ch);
     lis_vector_duplicate(A_ch, &x_ch);
     lis_matrix_get_range(A_ch, &is_ch, &ie_ch);
+    Set_ch_pattern(is_ch, ie_ch);
 }
 #else
+/*!
+  \brief Multigrid hierarchy on the fluid mesh
+  \details Levels halve the mesh while every extent stays even and at least 2. The coarsest level is solved
+  with a dense inverse when it has at most mg_dense_max unknowns, otherwise by extra smoothing.
+ */
+static void Mem_alloc_multigrid(work_bicgstab &wm) {
+    const int mg_dense_max = 192;
+    int       nx = NX, ny = NY, nz = NZ;
+    wm.mg_nlevel = 1;
+    while (nx % 2 == 0 && ny % 2 == 0 && nz % 2 == 0 && nx >= 4 && ny >= 4 && nz >= 4) {
+        nx /= 2;
+        ny /= 2;
+        nz /= 2;
+        wm.mg_nlevel++;
+    }
+    wm.mg = (mg_level *)malloc(sizeof(mg_level) * wm.mg_nlevel);
+
+    nx = NX, ny = NY, nz = NZ;
+    double dx = DX;
+    for (int l = 0; l < wm.mg_nlevel; l++) {
+        mg_level &L = wm.mg[l];
+        L.n         = DIM * nx * ny * nz;  // reset per solve in Setup_mg
+        L.A.nx      = nx;
+        L.A.ny      = ny;
+        L.A.nz      = nz;
+        L.A.nz_     = (l == 0) ? NZ_ : nz;
+        L.A.dx      = dx;
+        L.r         = calloc_1d_double(L.n);
+        L.diag_inv  = calloc_1d_double(L.n);
+        if (l > 0) {
+            L.u_s   = calloc_2d_double(DIM, nx * ny * nz);
+            L.eta_s = calloc_1d_double(nx * ny * nz);
+            L.A.u_s = L.u_s;
+            L.x     = calloc_1d_double(L.n);
+            L.b     = calloc_1d_double(L.n);
+        }
+        nx /= 2;
+        ny /= 2;
+        nz /= 2;
+        dx *= 2.;
+    }
+
+    const int nc = wm.mg[wm.mg_nlevel - 1].n;
+    if (wm.mg_nlevel > 1 && nc <= mg_dense_max) {
+        wm.mg_mat = calloc_2d_double(nc, nc);
+        wm.mg_inv = calloc_2d_double(nc, nc);
+    } else {
+        wm.mg_mat = NULL;
+        wm.mg_inv = NULL;
+    }
+}
+
+static void Free_multigrid(work_bicgstab &wm) {
+    for (int l = 0; l < wm.mg_nlevel; l++) {
+        mg_level &L = wm.mg[l];
+        free_1d_double(L.r);
+        free_1d_double(L.diag_inv);
+        if (l > 0) {
+            free_2d_double(L.u_s);
+            free_1d_double(L.eta_s);
+            free_1d_double(L.x);
+            free_1d_double(L.b);
+        }
+    }
+    free(wm.mg);
+    if (wm.mg_inv != NULL) {
+        free_2d_double(wm.mg_mat);
+        free_2d_double(wm.mg_inv);
+    }
+}
+
+// nnzval = 0: matrix-free operator, no ILU(0) storage
+static void Mem_alloc_precond(work_bicgstab &wm, const PC &precond, int nval, int nnzval) {
+    wm.precond    = precond;
+    wm.ilu_nblock = 0;
+    wm.ilu_ready  = 0;
+    if (precond == no_precond) {
+        return;
+    }
+    wm.ph       = calloc_1d_double(nval);
+    wm.th       = calloc_1d_double(nval);
+    wm.diag_inv = calloc_1d_double(nval);
+    if (precond == chebyshev_precond) {
+        wm.res = calloc_1d_double(nval);
+        wm.dir = calloc_1d_double(nval);
+    }
+    if (precond == multigrid_precond) {
+        Mem_alloc_multigrid(wm);
+    }
+    if (precond == block_ilu0_precond && nnzval > 0) {
+        wm.ilu_nblock = MIN(omp_get_max_threads(), nval);
+        wm.ilu_ptr    = calloc_1d_int(nval + 1);
+        wm.ilu_idx    = calloc_1d_int(nnzval);
+        wm.ilu_diag   = calloc_1d_int(nval);
+        wm.ilu_map    = calloc_1d_int(nnzval);
+        wm.ilu_iw     = calloc_1d_int(nval);
+        wm.ilu_val    = calloc_1d_double(nnzval);
+    }
+}
+
+static void Free_precond(work_bicgstab &wm) {
+    if (wm.precond == no_precond) {
+        return;
+    }
+    free_1d_double(wm.ph);
+    free_1d_double(wm.th);
+    free_1d_double(wm.diag_inv);
+    if (wm.precond == chebyshev_precond) {
+        free_1d_double(wm.res);
+        free_1d_double(wm.dir);
+    }
+    if (wm.precond == multigrid_precond) {
+        Free_multigrid(wm);
+    }
+    if (wm.ilu_nblock > 0) {
+        free_1d_int(wm.ilu_ptr);
+        free_1d_int(wm.ilu_idx);
+        free_1d_int(wm.ilu_diag);
+        free_1d_int(wm.ilu_map);
+        free_1d_int(wm.ilu_iw);
+        free_1d_double(wm.ilu_val);
+    }
+}
+
+static void Mem_alloc_pipelined(work_bicgstab &wm, int pipelined, int nval) {
+    wm.pipelined = pipelined;
+    if (!pipelined) {
+        return;
+    }
+    wm.w  = calloc_1d_double(nval);
+    wm.wh = calloc_1d_double(nval);
+    wm.rh = calloc_1d_double(nval);
+    wm.s  = calloc_1d_double(nval);
+    wm.sh = calloc_1d_double(nval);
+    wm.z  = calloc_1d_double(nval);
+    wm.zh = calloc_1d_double(nval);
+    wm.v  = calloc_1d_double(nval);
+    wm.q  = calloc_1d_double(nval);
+    wm.qh = calloc_1d_double(nval);
+    wm.y  = calloc_1d_double(nval);
+}
+
+static void Free_pipelined(work_bicgstab &wm) {
+    if (!wm.pipelined) {
+        return;
+    }
+    free_1d_double(wm.w);
+    free_1d_double(wm.wh);
+    free_1d_double(wm.rh);
+    free_1d_double(wm.s);
+    free_1d_double(wm.sh);
+    free_1d_double(wm.z);
+    free_1d_double(wm.zh);
+    free_1d_double(wm.v);
+    free_1d_double(wm.q);
+    free_1d_double(wm.qh);
+    free_1d_double(wm.y);
+}
+
+/*!
+  \brief Single-precision copies for the mixed-precision refinement
+  \details nnzval > 0: CSR values; nnzval = 0: the coefficient fields of the matrix-free momentum operator. The
+  inner solve has float versions of the Jacobi and Chebyshev preconditioners only.
+ */
+static void Mem_alloc_mixed(work_bicgstab &wm, int mixed, int nval, int nnzval) {
+    wm.mixed = mixed;
+    if (!mixed) {
+        return;
+    }
+    if (wm.precond == block_ilu0_precond || wm.precond == multigrid_precond) {
+        fprintf(stderr, "mixed-precision refinement supports the none, jacobi and chebyshev preconditioners\n");
+        exit_job(EXIT_FAILURE);
+    }
+    if (nnzval > 0) {
+        wm.f_val   = calloc_1d_float(nnzval);
+        wm.f_u_s   = NULL;
+        wm.f_eta_s = NULL;
+    } else {
+        wm.f_val   = NULL;
+        wm.f_u_s   = calloc_2d_float(DIM, NX * NY * NZ_);
+        wm.f_eta_s = calloc_1d_float(NX * NY * NZ_);
+    }
+    wm.f_diag_inv = calloc_1d_float(nval);
+    wm.f_x        = calloc_1d_float(nval);
+    wm.f_r        = calloc_1d_float(nval);
+    wm.f_r0s      = calloc_1d_float(nval);
+    wm.f_p        = calloc_1d_float(nval);
+    wm.f_t        = calloc_1d_float(nval);
+    wm.f_Ap       = calloc_1d_float(nval);
+    wm.f_At       = calloc_1d_float(nval);
+    wm.f_ph       = calloc_1d_float(nval);
+    wm.f_th       = calloc_1d_float(nval);
+    wm.f_Ax       = calloc_1d_float(nval);
+    wm.f_res      = calloc_1d_float(nval);
+    wm.f_dir      = calloc_1d_float(nval);
+}
+
+static void Free_mixed(work_bicgstab &wm) {
+    if (!wm.mixed) {
+        return;
+    }
+    if (wm.f_val != NULL) {
+        free_1d_float(wm.f_val);
+    } else {
+        free_2d_float(wm.f_u_s);
+        free_1d_float(wm.f_eta_s);
+    }
+    free_1d_float(wm.f_diag_inv);
+    free_1d_float(wm.f_x);
+    free_1d_float(wm.f_r);
+    free_1d_float(wm.f_r0s);
+    free_1d_float(wm.f_p);
+    free_1d_float(wm.f_t);
+    free_1d_float(wm.f_Ap);
+    free_1d_float(wm.f_At);
+    free_1d_float(wm.f_ph);
+    free_1d_float(wm.f_th);
+    free_1d_float(wm.f_Ax);
+    free_1d_float(wm.f_res);
+    free_1d_float(wm.f_dir);
+}
+
 void Mem_alloc_matrix_solver(void) {
     if (SW_NSST == implicit_scheme) {
+        // the momentum operator is applied matrix-free (Calc_Ax_ns): no CSR arrays for NS
         int nval_ns = NX * NY * NZ * DIM;
-        int nnzval;
-        if (SW_EQ == Navier_Stokes_FDM) {
-            nnzval = nval_ns * 7;
-        } else if (SW_EQ == Navier_Stokes_Cahn_Hilliard_FDM) {
-            if (VISCOSITY_CHANGE) {
-                nnzval = nval_ns * 11;
-            } else {
-                nnzval = nval_ns * 7;
-            }
-        } else if (SW_EQ == Shear_Navier_Stokes_Lees_Edwards_FDM || SW_EQ == Shear_NS_LE_CH_FDM) {
-            if (VISCOSITY_CHANGE) {
-                nnzval = nval_ns * 20;
-            } else {
-                nnzval = nval_ns * 12;
-            }
-        }
 
-        idx_ns_csr = calloc_1d_int(nnzval);
-        val_ns_csr = calloc_1d_double(nnzval);
-        ptr_ns     = calloc_1d_int(nval_ns + 1);
-        b_ns       = calloc_1d_double(nval_ns);
+        b_ns = calloc_1d_double(nval_ns);
 
         wm_ns.p   = calloc_1d_double(nval_ns);
         wm_ns.r   = calloc_1d_double(nval_ns);
@@ -3629,24 +3664,22 @@ void Mem_alloc_matrix_solver(void) {
         wm_ns.r0s = calloc_1d_double(nval_ns);
         wm_ns.x   = calloc_1d_double(nval_ns);
         wm_ns.Ax  = calloc_1d_double(nval_ns);
+        Mem_alloc_precond(wm_ns, precond_ns, nval_ns, 0);
+        Mem_alloc_pipelined(wm_ns, pipelined_ns, nval_ns);
+        Mem_alloc_mixed(wm_ns, mixed_ns, nval_ns, 0);
+        wm_ns.guess  = guess_ns;
+        wm_ns.nsolve = 0;
+        if (guess_ns == extrapolated_guess) {
+            wm_ns.x_o = calloc_1d_double(nval_ns);
+        }
     }
 
     if (SW_CHST == implicit_scheme) {
         int nval_ch = NX * NY * NZ;
-        int nnzval;
-        if (SW_EQ == Navier_Stokes_Cahn_Hilliard_FDM) {
-            if (ps.psi_dry != 0.0) {
-                nnzval = nval_ch * 43;
-            } else {
-                nnzval = nval_ch * 25;
-            }
-        } else if (SW_EQ == Shear_NS_LE_CH_FDM) {
-            nnzval = nval_ch * 45;
-        }
+        int nnzval  = sell_size(nval_ch, Ch_row_width());
 
         idx_ch_csr = calloc_1d_int(nnzval);
         val_ch_csr = calloc_1d_double(nnzval);
-        ptr_ch     = calloc_1d_int(nval_ch + 1);
         b_ch       = calloc_1d_double(nval_ch);
 
         wm_ch.p   = calloc_1d_double(nval_ch);
@@ -3657,14 +3690,20 @@ void Mem_alloc_matrix_solver(void) {
         wm_ch.r0s = calloc_1d_double(nval_ch);
         wm_ch.x   = calloc_1d_double(nval_ch);
         wm_ch.Ax  = calloc_1d_double(nval_ch);
+        Mem_alloc_precond(wm_ch, precond_ch, nval_ch, nnzval);
+        Mem_alloc_pipelined(wm_ch, pipelined_ch, nval_ch);
+        Mem_alloc_mixed(wm_ch, mixed_ch, nval_ch, nnzval);
+        wm_ch.guess  = guess_ch;
+        wm_ch.nsolve = 0;
+        if (guess_ch == extrapolated_guess) {
+            wm_ch.x_o = calloc_1d_double(nval_ch);
+        }
+        Set_ch_pattern(0, nval_ch);
     }
 }
 
 void Free_matrix_solver(void) {
     if (SW_NSST == implicit_scheme) {
-        free_1d_int(idx_ns_csr);
-        free_1d_double(val_ns_csr);
-        free_1d_int(ptr_ns);
         free_1d_double(b_ns);
 
         free_1d_double(wm_ns.p);
@@ -3675,11 +3714,16 @@ void Free_matrix_solver(void) {
         free_1d_double(wm_ns.r0s);
         free_1d_double(wm_ns.x);
         free_1d_double(wm_ns.Ax);
+        Free_precond(wm_ns);
+        Free_pipelined(wm_ns);
+        Free_mixed(wm_ns);
+        if (wm_ns.guess == extrapolated_guess) {
+            free_1d_double(wm_ns.x_o);
+        }
     }
     if (SW_CHST == implicit_scheme) {
         free_1d_int(idx_ch_csr);
         free_1d_double(val_ch_csr);
-        free_1d_int(ptr_ch);
         free_1d_double(b_ch);
 
         free_1d_double(wm_ch.p);
@@ -3690,100 +3734,1493 @@ void Free_matrix_solver(void) {
         free_1d_double(wm_ch.r0s);
         free_1d_double(wm_ch.x);
         free_1d_double(wm_ch.Ax);
+        Free_precond(wm_ch);
+        Free_pipelined(wm_ch);
+        Free_mixed(wm_ch);
+        if (wm_ch.guess == extrapolated_guess) {
+            free_1d_double(wm_ch.x_o);
+        }
     }
 }
 
-void bicgstab(int *idx, double *val, int *row_ptr, double *b, work_bicgstab &wm, int nval) {
-    double alpha, beta, zeta, r0sr, r0sr_o, r0sAp, tAt, AtAt;
-    double err, rr, bb;
+static inline int stencil_idx(const ns_stencil &A, int i, int j, int k) { return (i * A.ny + j) * A.nz + k; }
+static inline int stencil_im(const ns_stencil &A, int i, int j, int k) { return (i * A.ny + j) * A.nz_ + k; }
+static inline int stencil_ncomp(const ns_stencil &A) { return (A.comp < 0) ? DIM : 1; }
+
+// one velocity component at uniform viscosity (comp >= 0): the coefficients other than u_s are constants
+template <typename T>
+static void Calc_Ax_ns_scalar_planes(const T *x, const ns_stencil &A, const T *const *u_s, T *ans, int i0, int i1) {
+    const double INV_4DX  = 1. / (4. * A.dx);
+    const double INV_DX2  = 1. / (A.dx * A.dx);
+    const double INV_2DX2 = 1. / (2. * A.dx * A.dx);
+    const double INV_4DX2 = 1. / (4. * A.dx * A.dx);
+    const double gt       = A.gt;
+    const double diag     = A.inv_dt + (3. + gt * gt) * NU * INV_DX2;
+    const double lx       = NU * (1. + gt * gt) * INV_2DX2;
+    const double lyz      = NU * INV_2DX2;
+    const double lxy      = (A.oblique) ? gt * NU * INV_4DX2 : 0.;
+
+    for (int i = i0; i < i1; i++) {
+        int ip1 = adj(1, i, A.nx);
+        int im1 = adj(-1, i, A.nx);
+        for (int j = 0; j < A.ny; j++) {
+            int           jp1 = adj(1, j, A.ny);
+            int           jm1 = adj(-1, j, A.ny);
+            const T *     xc  = x + stencil_idx(A, i, j, 0);
+            const T *     xxp = x + stencil_idx(A, ip1, j, 0);
+            const T *     xxm = x + stencil_idx(A, im1, j, 0);
+            const T *     xyp = x + stencil_idx(A, i, jp1, 0);
+            const T *     xym = x + stencil_idx(A, i, jm1, 0);
+            const T *     xpp = x + stencil_idx(A, ip1, jp1, 0);
+            const T *     xpm = x + stencil_idx(A, ip1, jm1, 0);
+            const T *     xmp = x + stencil_idx(A, im1, jp1, 0);
+            const T *     xmm = x + stencil_idx(A, im1, jm1, 0);
+            const T *     ux  = u_s[0] + stencil_im(A, i, j, 0);
+            const T *     uy  = u_s[1] + stencil_im(A, i, j, 0);
+            const T *     uz  = u_s[2] + stencil_im(A, i, j, 0);
+            T *           out = ans + stencil_idx(A, i, j, 0);
+            for (int k = 0; k < A.nz; k++) {
+                int    kp1 = adj(1, k, A.nz);
+                int    km1 = adj(-1, k, A.nz);
+                double ax  = ux[k] * INV_4DX;
+                double ay  = uy[k] * INV_4DX;
+                double az  = uz[k] * INV_4DX;
+
+                double sum = diag * xc[k] + ax * (xxp[k] - xxm[k]) - lx * (xxp[k] + xxm[k]) + ay * (xyp[k] - xym[k]) -
+                             lyz * (xyp[k] + xym[k]) + az * (xc[kp1] - xc[km1]) - lyz * (xc[kp1] + xc[km1]);
+                out[k] = sum + lxy * (xpp[k] - xpm[k] - xmp[k] + xmm[k]);
+            }
+        }
+    }
+}
 
-    int ITER = 0;
+/*!
+  \brief Rows of the x-planes i0 <= i < i1; no threading here (see Calc_Ax_ns and Apply_A_local)
+  \details Only the coupled operator is computed here; a single component (A.comp >= 0) goes to
+  Calc_Ax_ns_scalar_planes. T is the storage type of x, ans and the coefficient fields u_s / eta_s (those of A, or
+  their float copies for the mixed-precision inner solve); the arithmetic is done in double.
+ */
+template <typename T>
+static void Calc_Ax_ns_planes(const T *x, const ns_stencil &A, const T *const *u_s, const T *eta_s, T *ans, int i0,
+                              int i1) {
+    if (A.comp >= 0) {
+        Calc_Ax_ns_scalar_planes(x, A, u_s, ans, i0, i1);
+        return;
+    }
+    const double INV_2DX  = 1. / (2. * A.dx);
+    const double INV_DX2  = 1. / (A.dx * A.dx);
+    const double INV_4DX  = 1. / (4. * A.dx);
+    const double INV_2DX2 = 1. / (2. * A.dx * A.dx);
+    const double INV_4DX2 = 1. / (4. * A.dx * A.dx);
+    const double GRAD_ETA = IRHO * INV_2DX * INV_2DX;  // central difference of eta, times IRHO / (2 DX)
+    const int    nxyz     = A.nx * A.ny * A.nz;
+
+    const double gt  = A.gt;
+    const double g11 = 1. + gt * gt;
+    const double g12 = -gt;
+    const double g21 = -gt;
+    const double g22 = 1.;
+    const double g33 = 1.;
+
+    for (int i = i0; i < i1; i++) {
+        int ip1 = adj(1, i, A.nx);
+        int im1 = adj(-1, i, A.nx);
+        for (int j = 0; j < A.ny; j++) {
+            int jp1 = adj(1, j, A.ny);
+            int jm1 = adj(-1, j, A.ny);
+            for (int k = 0; k < A.nz; k++) {
+                int kp1 = adj(1, k, A.nz);
+                int km1 = adj(-1, k, A.nz);
+                int im  = stencil_im(A, i, j, k);
+
+                // neighbours in the (unpadded) solution vector
+                int c  = stencil_idx(A, i, j, k);
+                int xp = stencil_idx(A, ip1, j, k);
+                int xm = stencil_idx(A, im1, j, k);
+                int yp = stencil_idx(A, i, jp1, k);
+                int ym = stencil_idx(A, i, jm1, k);
+                int zp = stencil_idx(A, i, j, kp1);
+                int zm = stencil_idx(A, i, j, km1);
+                int pp = stencil_idx(A, ip1, jp1, k);
+                int pm = stencil_idx(A, ip1, jm1, k);
+                int mp = stencil_idx(A, im1, jp1, k);
+                int mm = stencil_idx(A, im1, jm1, k);
+
+                double nu   = (eta_s == NULL) ? NU : eta_s[im] * IRHO;
+                double diag = A.inv_dt + (3. + gt * gt) * nu * INV_DX2;
+                double ax   = u_s[0][im] * INV_4DX;
+                double ay   = u_s[1][im] * INV_4DX;
+                double az   = u_s[2][im] * INV_4DX;
+                double lx   = nu * g11 * INV_2DX2;
+                double lyz  = nu * INV_2DX2;
+                double lxy  = gt * nu * INV_4DX2;
+
+                double nu_base_x = 0.;
+                double nu_base_y = 0.;
+                double nu_base_z = 0.;
+                if (eta_s != NULL) {
+                    const T *eta = eta_s;
+                    nu_base_x    = (eta[stencil_im(A, ip1, j, k)] - eta[stencil_im(A, im1, j, k)]) * GRAD_ETA;
+                    nu_base_y    = (eta[stencil_im(A, i, jp1, k)] - eta[stencil_im(A, i, jm1, k)]) * GRAD_ETA;
+                    nu_base_z    = (eta[stencil_im(A, i, j, kp1)] - eta[stencil_im(A, i, j, km1)]) * GRAD_ETA;
+                }
+                double h_nu_x = 0.5 * nu_base_x;
+                double h_nu_y = 0.5 * nu_base_y;
+                double h_nu_z = 0.5 * nu_base_z;
+
+                const T *x0 = x;
+                const T *x1 = x + nxyz;
+                const T *x2 = x + 2 * nxyz;
+                for (int d = 0; d < DIM; d++) {
+                    const T *xd = x + d * nxyz;
+
+                    double sum = diag * xd[c] + ax * (xd[xp] - xd[xm]) - lx * (xd[xp] + xd[xm]) +
+                                 ay * (xd[yp] - xd[ym]) - lyz * (xd[yp] + xd[ym]) + az * (xd[zp] - xd[zm]) -
+                                 lyz * (xd[zp] + xd[zm]);
+                    if (A.oblique) {
+                        sum += lxy * (xd[pp] - xd[pm] - xd[mp] + xd[mm]);
+                        if (d == 0) {
+                            sum += Shear_rate_eff * x1[c];
+                        }
+                    }
+
+                    // viscosity gradient terms, with contravariant metric for the oblique grid
+                    if (eta_s != NULL) {
+                        double nu_x, nu_y, nu_z;
+                        switch (d) {
+                            case 0:
+                                nu_x = g11 * nu_base_x + 0.5 * g21 * nu_base_y;
+                                nu_y = g12 * nu_base_x + 0.5 * g22 * nu_base_y;
+                                nu_z = g33 * h_nu_z;
+                                sum -= g11 * h_nu_y * (x1[xp] - x1[xm]) + g12 * h_nu_y * (x1[yp] - x1[ym]) +
+                                       g11 * h_nu_z * (x2[xp] - x2[xm]) + g12 * h_nu_z * (x2[yp] - x2[ym]);
+                                break;
+                            case 1:
+                                nu_x = 0.5 * g11 * nu_base_x + g21 * nu_base_y;
+                                nu_y = 0.5 * g12 * nu_base_x + g22 * nu_base_y;
+                                nu_z = g33 * h_nu_z;
+                                sum -= g21 * h_nu_x * (x0[xp] - x0[xm]) + g22 * h_nu_x * (x0[yp] - x0[ym]) +
+                                       g21 * h_nu_z * (x2[xp] - x2[xm]) + g22 * h_nu_z * (x2[yp] - x2[ym]);
+                                break;
+                            default:
+                                nu_x = 0.5 * g11 * nu_base_x + 0.5 * g21 * nu_base_y;
+                                nu_y = 0.5 * g12 * nu_base_x + 0.5 * g22 * nu_base_y;
+                                nu_z = g33 * nu_base_z;
+                                sum -= g33 * h_nu_x * (x0[zp] - x0[zm]) + g33 * h_nu_y * (x1[zp] - x1[zm]);
+                                break;
+                        }
+                        sum -= nu_x * (xd[xp] - xd[xm]) + nu_y * (xd[yp] - xd[ym]) + nu_z * (xd[zp] - xd[zm]);
+                    }
+                    ans[d * nxyz + c] = sum;
+                }
+            }
+        }
+    }
+}
+
+/*!
+  \brief Slices s0...s1-1 of ans = A x for A in SELL-C storage (see SELL_C)
+  \details The partial sums of the SELL_C rows of a slice are independent SIMD lanes; the padding rows of the last
+  slice are computed but not stored. Sums are accumulated in double for both precisions.
+ */
+template <typename T>
+static void Calc_Ax_sell(const T *x, const int *idx, const T *val, int width, T *ans, int nrow, int s0, int s1) {
+    for (int s = s0; s < s1; s++) {
+        const int base = s * width * SELL_C;
+        double    sum[SELL_C];
+        for (int r = 0; r < SELL_C; r++) {
+            sum[r] = 0.;
+        }
+        for (int q = 0; q < width; q++) {
+            const int *col = idx + base + q * SELL_C;
+            const T *  v   = val + base + q * SELL_C;
+#pragma omp simd
+            for (int r = 0; r < SELL_C; r++) {
+                sum[r] += v[r] * x[col[r]];
+            }
+        }
+        const int nr = MIN(SELL_C, nrow - s * SELL_C);
+        for (int r = 0; r < nr; r++) {
+            ans[s * SELL_C + r] = sum[r];
+        }
+    }
+}
+
+void Calc_Ax(double *x, int *idx, double *val, int width, double *ans, int nrow) {
+    const int nslice = (nrow + SELL_C - 1) / SELL_C;
 #pragma omp parallel for
-    for (int i = 0; i < nval; i++) {
-        wm.p[i]   = 0.;
-        wm.r[i]   = 0.;
-        wm.t[i]   = 0.;
-        wm.Ap[i]  = 0.;
-        wm.At[i]  = 0.;
-        wm.r0s[i] = 0.;
-        wm.x[i]   = 0.;
-        wm.Ax[i]  = 0.;
+    for (int s = 0; s < nslice; s++) {
+        Calc_Ax_sell(x, idx, val, width, ans, nrow, s, s + 1);
     }
-    bb    = 0.;
-    alpha = 0.;
-    beta  = 0.;
-    r0sr  = 0.;
-    zeta  = 0.;
+}
 
-#pragma omp parallel for reduction(+ : r0sr, bb)
-    for (int i = 0; i < nval; i++) {
-        wm.r[i] = b[i] - wm.Ax[i];
-        bb += b[i] * b[i];
-        wm.r0s[i] = wm.r[i];
-        r0sr += wm.r[i] * wm.r0s[i];
+void Calc_Ax_ns(double *x, const ns_stencil &A, double *ans) {
+#pragma omp parallel for
+    for (int i = 0; i < A.nx; i++) {
+        Calc_Ax_ns_planes(x, A, A.u_s, A.eta_s, ans, i, i + 1);
     }
-    bb = sqrt(bb);
-    if (bb > 0.) {
-        do {
+}
+
+void Calc_diag_ns(const ns_stencil &A, double *diag) {
+    const double INV_DX2 = 1. / (A.dx * A.dx);
+    const int    nxyz    = A.nx * A.ny * A.nz;
+    const int    ncomp   = stencil_ncomp(A);
+    const double gt      = A.gt;
 #pragma omp parallel for
-            for (int i = 0; i < nval; i++) {
-                wm.p[i] = wm.r[i] + beta * (wm.p[i] - zeta * wm.Ap[i]);
-            }
-            Calc_Ax(wm.p, idx, val, row_ptr, wm.Ap, nval);
-            r0sAp = 0.;
-#pragma omp parallel for reduction(+ : r0sAp)
-            for (int i = 0; i < nval; i++) {
-                r0sAp += wm.r0s[i] * wm.Ap[i];
+    for (int i = 0; i < A.nx; i++) {
+        for (int j = 0; j < A.ny; j++) {
+            for (int k = 0; k < A.nz; k++) {
+                int    im = stencil_im(A, i, j, k);
+                int    c  = stencil_idx(A, i, j, k);
+                double nu = (A.eta_s == NULL) ? NU : A.eta_s[im] * IRHO;
+                for (int d = 0; d < ncomp; d++) {
+                    diag[d * nxyz + c] = A.inv_dt + (3. + gt * gt) * nu * INV_DX2;
+                }
             }
-            alpha = r0sr / r0sAp;
+        }
+    }
+}
 
+/*!
+  \brief Initial guess of the next solve, written to wm.x in ijkd2idx order
+  \details current_guess copies the field (ncomp components on the padded grid). extrapolated_guess uses
+  2 x^n - x^(n-1) from the last two solutions, falling back to the field until one solve is done.
+ */
+void Set_initial_guess(double **field, int ncomp, work_bicgstab &wm) {
+    const int nxyz = NX * NY * NZ;
+    if (wm.guess == zero_guess) {
+        return;
+    }
+    if (wm.guess == extrapolated_guess && wm.nsolve > 0) {
+        const double c = (wm.nsolve > 1) ? 1. : 0.;
 #pragma omp parallel for
-            for (int i = 0; i < nval; i++) {
-                wm.t[i] = wm.r[i] - alpha * wm.Ap[i];
+        for (int idx = 0; idx < ncomp * nxyz; idx++) {
+            double x_last = wm.x[idx];
+            wm.x[idx]     = x_last + c * (x_last - wm.x_o[idx]);
+            wm.x_o[idx]   = x_last;
+        }
+        return;
+    }
+#pragma omp parallel for
+    for (int i = 0; i < NX; i++) {
+        for (int j = 0; j < NY; j++) {
+            for (int k = 0; k < NZ; k++) {
+                int im = ijk2im(i, j, k);
+                for (int d = 0; d < ncomp; d++) {
+                    wm.x[d * nxyz + ijk2idx(i, j, k)] = field[d][im];
+                }
             }
+        }
+    }
+}
 
-            Calc_Ax(wm.t, idx, val, row_ptr, wm.At, nval);
-            tAt  = 0.;
-            AtAt = 0.;
-#pragma omp parallel for reduction(+ : tAt, AtAt)
-            for (int i = 0; i < nval; i++) {
-                tAt += wm.t[i] * wm.At[i];
-                AtAt += wm.At[i] * wm.At[i];
-            }
-            zeta = tAt / AtAt;
+// linear operator of the built-in solver: matrix-free when stencil is given, otherwise the SELL-C arrays
+struct linear_op {
+    int *             idx;
+    double *          val;
+    int               width;  // entries per row
+    const ns_stencil *stencil;
+    int               nval;
+};
+
+static void Apply_A(const linear_op &A, double *x, double *ans) {
+    if (A.stencil != NULL) {
+        Calc_Ax_ns(x, *A.stencil, ans);
+    } else {
+        Calc_Ax(x, A.idx, A.val, A.width, ans, A.nval);
+    }
+}
 
-            r0sr_o = r0sr;
-            r0sr   = 0.;
-            rr     = 0.;
-#pragma omp parallel for reduction(+ : r0sr, rr)
-            for (int i = 0; i < nval; i++) {
-                wm.x[i] += alpha * wm.p[i] + zeta * wm.t[i];
-                wm.r[i] = wm.t[i] - zeta * wm.At[i];
-                r0sr += wm.r0s[i] * wm.r[i];
-                rr += wm.r[i] * wm.r[i];
-            }
-            err  = log10(rr) / 2. - log10(bb);
-            beta = r0sr / (zeta * r0sAp);
-            ITER++;
-        } while (err > wm.eps && ITER < wm.maxiter);
+// rows owned by one thread in Apply_A_local: one slab of x-planes per component for the stencil, whole SELL-C slices
+struct row_range {
+    int nseg;
+    int begin[DIM];
+    int end[DIM];
+};
+
+/*!
+  \brief This thread's static share of ans = A x, called inside an omp parallel region
+  \details No barrier: the caller may update its own rows (and reduce over them) right after, so an operator
+  pass, the vector updates and the dot products share one parallel region. x must be complete on entry.
+ */
+static void Apply_A_local(const linear_op &A, const double *x, double *ans, row_range &rows) {
+    const int nthread = omp_get_num_threads();
+    const int tid     = omp_get_thread_num();
+    if (A.stencil != NULL) {
+        const ns_stencil &S    = *A.stencil;
+        const int         nyz  = S.ny * S.nz;
+        const int         nxyz = S.nx * nyz;
+        const int         i0   = S.nx * tid / nthread;
+        const int         i1   = S.nx * (tid + 1) / nthread;
+        Calc_Ax_ns_planes(x, S, S.u_s, S.eta_s, ans, i0, i1);
+        rows.nseg = stencil_ncomp(S);
+        for (int d = 0; d < rows.nseg; d++) {
+            rows.begin[d] = d * nxyz + i0 * nyz;
+            rows.end[d]   = d * nxyz + i1 * nyz;
+        }
+    } else {
+        const int nslice = (A.nval + SELL_C - 1) / SELL_C;
+        const int s0     = nslice * tid / nthread;
+        const int s1     = nslice * (tid + 1) / nthread;
+        Calc_Ax_sell(x, A.idx, A.val, A.width, ans, A.nval, s0, s1);
+        rows.nseg     = 1;
+        rows.begin[0] = MIN(s0 * SELL_C, A.nval);
+        rows.end[0]   = MIN(s1 * SELL_C, A.nval);
     }
+}
 
-    if (ITER == wm.maxiter) {
-        fprintf(stderr, "Error: BiCGSTAB method is not converged \n");
-        exit_job(EXIT_FAILURE);
+static void Set_diag_inv(const linear_op &A, double *diag_inv) {
+    if (A.stencil != NULL) {
+        Calc_diag_ns(*A.stencil, diag_inv);
+#pragma omp parallel for
+        for (int i = 0; i < A.nval; i++) {
+            diag_inv[i] = 1. / diag_inv[i];
+        }
     } else {
-        // fprintf(stderr, "ITER: %d \n", ITER);
+#pragma omp parallel for
+        for (int i = 0; i < A.nval; i++) {
+            const int row  = sell_offset(i, A.width);
+            double    diag = 0.;
+            for (int q = 0; q < A.width; q++) {
+                if (A.idx[row + SELL_C * q] == i) {
+                    diag += A.val[row + SELL_C * q];
+                }
+            }
+            diag_inv[i] = (diag != 0.) ? 1. / diag : 1.;
+        }
     }
 }
-void Init_ns(void) {
-    wm_ns.eps     = eps_ns;
-    wm_ns.maxiter = maxiter_ns;
-    fprintf(stderr, "# NS iter setting: %f %d\n", wm_ns.eps, wm_ns.maxiter);
+
+/*!
+  \brief Sorted, duplicate-free CSR copy of the matrix pattern restricted to the diagonal blocks
+  \details The rows are assembled in stencil order (and may repeat a column on small grids).
+  The pattern does not change between steps, so this is done once.
+ */
+static void Set_ilu0_pattern(const linear_op &A, work_bicgstab &wm) {
+    int nnz        = 0;
+    wm.ilu_ptr[0] = 0;
+    for (int blk = 0; blk < wm.ilu_nblock; blk++) {
+        const int rs = (int)((long)A.nval * blk / wm.ilu_nblock);
+        const int re = (int)((long)A.nval * (blk + 1) / wm.ilu_nblock);
+        for (int i = rs; i < re; i++) {
+            const int row       = sell_offset(i, A.width);
+            const int row_start = nnz;
+            for (int e = 0; e < A.width; e++) {
+                int col = A.idx[row + SELL_C * e];
+                if (col < rs || col >= re) {
+                    continue;
+                }
+                int pos = row_start;
+                while (pos < nnz && wm.ilu_idx[pos] < col) {
+                    pos++;
+                }
+                if (pos == nnz || wm.ilu_idx[pos] != col) {
+                    for (int q = nnz; q > pos; q--) {
+                        wm.ilu_idx[q] = wm.ilu_idx[q - 1];
+                    }
+                    wm.ilu_idx[pos] = col;
+                    nnz++;
+                }
+            }
+            wm.ilu_ptr[i + 1] = nnz;
+
+            wm.ilu_diag[i] = -1;
+            for (int q = row_start; q < nnz; q++) {
+                if (wm.ilu_idx[q] == i) {
+                    wm.ilu_diag[i] = q;
+                }
+            }
+            if (wm.ilu_diag[i] < 0) {
+                fprintf(stderr, "Error: ILU(0) preconditioner requires a diagonal entry in every row\n");
+                exit_job(EXIT_FAILURE);
+            }
+
+            for (int e = 0; e < A.width; e++) {
+                int ii         = row + SELL_C * e;
+                int col        = A.idx[ii];
+                wm.ilu_map[ii] = -1;
+                if (col >= rs && col < re) {
+                    for (int q = row_start; q < nnz; q++) {
+                        if (wm.ilu_idx[q] == col) {
+                            wm.ilu_map[ii] = q;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (int i = 0; i < A.nval; i++) {
+        wm.ilu_iw[i] = -1;
+    }
+    wm.ilu_ready = 1;
 }
-void Init_ch(void) {
-    wm_ch.eps     = eps_ch;
-    wm_ch.maxiter = maxiter_ch;
-    fprintf(stderr, "# CH iter setting: %f %d\n", wm_ch.eps, wm_ch.maxiter);
+
+static void Set_ilu0_factor(const linear_op &A, work_bicgstab &wm) {
+#pragma omp parallel for
+    for (int i = 0; i < A.nval; i++) {
+        for (int q = wm.ilu_ptr[i]; q < wm.ilu_ptr[i + 1]; q++) {
+            wm.ilu_val[q] = 0.;
+        }
+        for (int e = 0; e < A.width; e++) {
+            int ii = sell_offset(i, A.width) + SELL_C * e;
+            if (wm.ilu_map[ii] >= 0) {
+                wm.ilu_val[wm.ilu_map[ii]] += A.val[ii];
+            }
+        }
+    }
+
+    // IKJ variant; blocks touch disjoint columns, so ilu_iw is shared between threads
+#pragma omp parallel for
+    for (int blk = 0; blk < wm.ilu_nblock; blk++) {
+        const int rs = (int)((long)A.nval * blk / wm.ilu_nblock);
+        const int re = (int)((long)A.nval * (blk + 1) / wm.ilu_nblock);
+        for (int i = rs; i < re; i++) {
+            for (int q = wm.ilu_ptr[i]; q < wm.ilu_ptr[i + 1]; q++) {
+                wm.ilu_iw[wm.ilu_idx[q]] = q;
+            }
+            for (int q = wm.ilu_ptr[i]; q < wm.ilu_diag[i]; q++) {
+                int kk = wm.ilu_idx[q];
+                wm.ilu_val[q] /= wm.ilu_val[wm.ilu_diag[kk]];
+                for (int qq = wm.ilu_diag[kk] + 1; qq < wm.ilu_ptr[kk + 1]; qq++) {
+                    int pos = wm.ilu_iw[wm.ilu_idx[qq]];
+                    if (pos >= 0) {
+                        wm.ilu_val[pos] -= wm.ilu_val[q] * wm.ilu_val[qq];
+                    }
+                }
+            }
+            for (int q = wm.ilu_ptr[i]; q < wm.ilu_ptr[i + 1]; q++) {
+                wm.ilu_iw[wm.ilu_idx[q]] = -1;
+            }
+            if (wm.ilu_val[wm.ilu_diag[i]] == 0.) {
+                fprintf(stderr, "Error: zero pivot in ILU(0) preconditioner\n");
+                exit_job(EXIT_FAILURE);
+            }
+        }
+    }
+}
+
+static void Solve_ilu0(const work_bicgstab &wm, int nval, double *r, double *z) {
+#pragma omp parallel for
+    for (int blk = 0; blk < wm.ilu_nblock; blk++) {
+        const int rs = (int)((long)nval * blk / wm.ilu_nblock);
+        const int re = (int)((long)nval * (blk + 1) / wm.ilu_nblock);
+        for (int i = rs; i < re; i++) {
+            double sum = r[i];
+            for (int q = wm.ilu_ptr[i]; q < wm.ilu_diag[i]; q++) {
+                sum -= wm.ilu_val[q] * z[wm.ilu_idx[q]];
+            }
+            z[i] = sum;
+        }
+        for (int i = re - 1; i >= rs; i--) {
+            double sum = z[i];
+            for (int q = wm.ilu_diag[i] + 1; q < wm.ilu_ptr[i + 1]; q++) {
+                sum -= wm.ilu_val[q] * z[wm.ilu_idx[q]];
+            }
+            z[i] = sum / wm.ilu_val[wm.ilu_diag[i]];
+        }
+    }
+}
+
+// DIM x DIM velocity blocks of the momentum operator: diagonal plus the oblique frame coupling u_x <- u_y
+static void Solve_node_block(const linear_op &A, const work_bicgstab &wm, double *r, double *z) {
+    const int    nxyz  = NX * NY * NZ;
+    const double shear = (A.stencil->oblique) ? Shear_rate_eff : 0.;
+    if (A.stencil->comp >= 0) {
+#pragma omp parallel for
+        for (int c = 0; c < nxyz; c++) {
+            z[c] = r[c] * wm.diag_inv[c];
+        }
+        return;
+    }
+#pragma omp parallel for
+    for (int c = 0; c < nxyz; c++) {
+        z[nxyz + c]     = r[nxyz + c] * wm.diag_inv[nxyz + c];
+        z[2 * nxyz + c] = r[2 * nxyz + c] * wm.diag_inv[2 * nxyz + c];
+        z[c]            = (r[c] - shear * z[nxyz + c]) * wm.diag_inv[c];
+    }
+}
+
+/*!
+  \brief Bounds of the spectrum of D^-1 A for the Chebyshev preconditioner
+  \details A few power iterations estimate the largest eigenvalue. The Gershgorin discs of D^-1 A
+  are centred at 1, so the lower bound is mirrored about 1 (and kept away from 0).
+ */
+static void Set_chebyshev_bounds(const linear_op &A, work_bicgstab &wm) {
+    const int n_power = 10;
+
+#pragma omp parallel for
+    for (int i = 0; i < A.nval; i++) {
+        wm.dir[i] = (double)((i * 7919) % 1009) / 1009. - 0.5;
+    }
+    double lambda = 1.;
+    for (int it = 0; it < n_power; it++) {
+        Apply_A(A, wm.dir, wm.Ax);
+        double vv = 0.;
+        double ww = 0.;
+#pragma omp parallel for reduction(+ : vv, ww)
+        for (int i = 0; i < A.nval; i++) {
+            wm.res[i] = wm.diag_inv[i] * wm.Ax[i];
+            vv += wm.dir[i] * wm.dir[i];
+            ww += wm.res[i] * wm.res[i];
+        }
+        lambda               = sqrt(ww / vv);
+        const double inv_nrm = 1. / sqrt(ww);
+#pragma omp parallel for
+        for (int i = 0; i < A.nval; i++) {
+            wm.dir[i] = wm.res[i] * inv_nrm;
+        }
+    }
+    wm.lmax = MAX(1.1 * lambda, 1.1);
+    wm.lmin = MAX(2. - wm.lmax, wm.lmax / 30.);
+}
+
+// fixed-degree Chebyshev iteration on D^-1 A z = D^-1 r from z = 0 (a fixed polynomial in A)
+static void Solve_chebyshev(const linear_op &A, work_bicgstab &wm, double *r, double *z) {
+    const double theta = 0.5 * (wm.lmax + wm.lmin);
+    const double delta = 0.5 * (wm.lmax - wm.lmin);
+    const double sigma = theta / delta;
+    double       rho   = 1. / sigma;
+
+#pragma omp parallel for
+    for (int i = 0; i < A.nval; i++) {
+        wm.res[i] = wm.diag_inv[i] * r[i];
+        wm.dir[i] = wm.res[i] / theta;
+        z[i]      = wm.dir[i];
+    }
+    for (int m = 1; m < wm.degree; m++) {
+        Apply_A(A, z, wm.Ax);
+        const double rho_new = 1. / (2. * sigma - rho);
+#pragma omp parallel for
+        for (int i = 0; i < A.nval; i++) {
+            wm.res[i] = wm.diag_inv[i] * (r[i] - wm.Ax[i]);
+            wm.dir[i] = rho_new * rho * wm.dir[i] + 2. * rho_new / delta * wm.res[i];
+            z[i] += wm.dir[i];
+        }
+        rho = rho_new;
+    }
+}
+
+// 2x2x2 average of a cell field (stride nz_ on both levels) onto the next coarser level
+static void Restrict_mg_field(const ns_stencil &fine, const double *f, const ns_stencil &coarse, double *c) {
+#pragma omp parallel for
+    for (int i = 0; i < coarse.nx; i++) {
+        for (int j = 0; j < coarse.ny; j++) {
+            for (int k = 0; k < coarse.nz; k++) {
+                double sum = 0.;
+                for (int a = 0; a < 8; a++) {
+                    sum += f[stencil_im(fine, 2 * i + (a >> 2), 2 * j + ((a >> 1) & 1), 2 * k + (a & 1))];
+                }
+                c[stencil_im(coarse, i, j, k)] = 0.125 * sum;
+            }
+        }
+    }
+}
+
+// full weighting, the adjoint of Prolong_mg_add divided by 8: weights (1,3,3,1)/4 per direction
+static void Restrict_mg(const mg_level &fine, mg_level &coarse) {
+    const int    nf     = fine.A.nx * fine.A.ny * fine.A.nz;
+    const int    nc     = coarse.A.nx * coarse.A.ny * coarse.A.nz;
+    const int    ncomp  = stencil_ncomp(fine.A);
+    const double w[4]   = {0.25, 0.75, 0.75, 0.25};
+    const double factor = 1. / 8.;
+#pragma omp parallel for
+    for (int i = 0; i < coarse.A.nx; i++) {
+        for (int j = 0; j < coarse.A.ny; j++) {
+            for (int k = 0; k < coarse.A.nz; k++) {
+                for (int d = 0; d < ncomp; d++) {
+                    double sum = 0.;
+                    for (int a = 0; a < 4; a++) {
+                        int fi = adj(2 * i - 1 + a, 0, fine.A.nx);
+                        for (int b = 0; b < 4; b++) {
+                            int    fj  = adj(2 * j - 1 + b, 0, fine.A.ny);
+                            double wab = w[a] * w[b];
+                            for (int c = 0; c < 4; c++) {
+                                int fk = adj(2 * k - 1 + c, 0, fine.A.nz);
+                                sum += wab * w[c] * fine.r[d * nf + stencil_idx(fine.A, fi, fj, fk)];
+                            }
+                        }
+                    }
+                    coarse.b[d * nc + stencil_idx(coarse.A, i, j, k)] = factor * sum;
+                }
+            }
+        }
+    }
+}
+
+// trilinear (cell-centred) interpolation of the coarse correction, added to the fine iterate
+static void Prolong_mg_add(const mg_level &coarse, mg_level &fine) {
+    const int nf    = fine.A.nx * fine.A.ny * fine.A.nz;
+    const int nc    = coarse.A.nx * coarse.A.ny * coarse.A.nz;
+    const int ncomp = stencil_ncomp(fine.A);
+#pragma omp parallel for
+    for (int i = 0; i < fine.A.nx; i++) {
+        int ci[2] = {i / 2, adj((i % 2 == 0) ? -1 : 1, i / 2, coarse.A.nx)};
+        for (int j = 0; j < fine.A.ny; j++) {
+            int cj[2] = {j / 2, adj((j % 2 == 0) ? -1 : 1, j / 2, coarse.A.ny)};
+            for (int k = 0; k < fine.A.nz; k++) {
+                int          ck[2] = {k / 2, adj((k % 2 == 0) ? -1 : 1, k / 2, coarse.A.nz)};
+                const double w[2]  = {0.75, 0.25};
+                for (int d = 0; d < ncomp; d++) {
+                    double sum = 0.;
+                    for (int a = 0; a < 2; a++) {
+                        for (int b = 0; b < 2; b++) {
+                            for (int c = 0; c < 2; c++) {
+                                int cc = stencil_idx(coarse.A, ci[a], cj[b], ck[c]);
+                                sum += w[a] * w[b] * w[c] * coarse.x[d * nc + cc];
+                            }
+                        }
+                    }
+                    fine.x[d * nf + stencil_idx(fine.A, i, j, k)] += sum;
+                }
+            }
+        }
+    }
+}
+
+// weighted Jacobi; from x = 0 when zero_init
+static void Smooth_mg(mg_level &L, int sweeps, bool zero_init) {
+    const double omega = 0.8;
+    for (int s = 0; s < sweeps; s++) {
+        if (s == 0 && zero_init) {
+#pragma omp parallel for
+            for (int i = 0; i < L.n; i++) {
+                L.x[i] = omega * L.diag_inv[i] * L.b[i];
+            }
+        } else {
+            Calc_Ax_ns(L.x, L.A, L.r);
+#pragma omp parallel for
+            for (int i = 0; i < L.n; i++) {
+                L.x[i] += omega * L.diag_inv[i] * (L.b[i] - L.r[i]);
+            }
+        }
+    }
+}
+
+// V-cycle for L.x ~ A^-1 L.b from a zero initial iterate (a fixed linear operator, so usable as a preconditioner)
+static void Vcycle_mg(work_bicgstab &wm, int level) {
+    mg_level &L = wm.mg[level];
+    if (level == wm.mg_nlevel - 1) {
+        if (wm.mg_inv != NULL) {
+#pragma omp parallel for
+            for (int i = 0; i < L.n; i++) {
+                double sum = 0.;
+                for (int j = 0; j < L.n; j++) {
+                    sum += wm.mg_inv[i][j] * L.b[j];
+                }
+                L.x[i] = sum;
+            }
+        } else {
+            Smooth_mg(L, 10 * wm.mg_sweeps, true);
+        }
+        return;
+    }
+    mg_level &C = wm.mg[level + 1];
+
+    Smooth_mg(L, wm.mg_sweeps, true);
+    Calc_Ax_ns(L.x, L.A, L.r);
+#pragma omp parallel for
+    for (int i = 0; i < L.n; i++) {
+        L.r[i] = L.b[i] - L.r[i];
+    }
+    Restrict_mg(L, C);
+    Vcycle_mg(wm, level + 1);
+    Prolong_mg_add(C, L);
+    Smooth_mg(L, wm.mg_sweeps, false);
+}
+
+// coarse operators for the current u_s / eta_s, and the dense inverse on the coarsest level
+static void Setup_mg(const ns_stencil &A, work_bicgstab &wm) {
+    wm.mg[0].A = A;
+    for (int l = 1; l < wm.mg_nlevel; l++) {
+        const ns_stencil &F = wm.mg[l - 1].A;
+        ns_stencil &      C = wm.mg[l].A;
+        C.inv_dt            = F.inv_dt;
+        C.gt                = F.gt;
+        C.oblique           = F.oblique;
+        C.comp              = F.comp;
+        for (int d = 0; d < DIM; d++) {
+            Restrict_mg_field(F, F.u_s[d], C, C.u_s[d]);
+        }
+        if (F.eta_s != NULL) {
+            Restrict_mg_field(F, F.eta_s, C, wm.mg[l].eta_s);
+            C.eta_s = wm.mg[l].eta_s;
+        } else {
+            C.eta_s = NULL;
+        }
+    }
+    for (int l = 0; l < wm.mg_nlevel; l++) {
+        mg_level &L = wm.mg[l];
+        L.n         = stencil_ncomp(L.A) * L.A.nx * L.A.ny * L.A.nz;
+        Calc_diag_ns(L.A, L.diag_inv);
+#pragma omp parallel for
+        for (int i = 0; i < L.n; i++) {
+            L.diag_inv[i] = 1. / L.diag_inv[i];
+        }
+    }
+
+    if (wm.mg_inv != NULL) {
+        mg_level &L = wm.mg[wm.mg_nlevel - 1];
+        for (int j = 0; j < L.n; j++) {
+            for (int i = 0; i < L.n; i++) {
+                L.x[i] = (i == j) ? 1. : 0.;
+            }
+            Calc_Ax_ns(L.x, L.A, L.r);
+            for (int i = 0; i < L.n; i++) {
+                wm.mg_mat[i][j] = L.r[i];
+            }
+        }
+        Matrix_Inverse(wm.mg_mat, wm.mg_inv, L.n);
+    }
+}
+
+// V-cycle iteration on the unpreconditioned residual, with the BiCGSTAB stopping criterion
+static void Solve_multigrid(const linear_op &A, double *b, work_bicgstab &wm) {
+    const int nval = A.nval;
+    double    err, rr, bb;
+
+    if (wm.guess == zero_guess) {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            wm.x[i] = 0.;
+        }
+    }
+    bb = 0.;
+#pragma omp parallel for reduction(+ : bb)
+    for (int i = 0; i < nval; i++) {
+        bb += b[i] * b[i];
+    }
+    bb = sqrt(bb);
+
+    int ITER = 0;
+    if (bb > 0.) {
+        Setup_mg(*A.stencil, wm);
+        wm.mg[0].b = wm.r;
+        wm.mg[0].x = wm.ph;
+        do {
+            Apply_A(A, wm.x, wm.Ax);
+            rr = 0.;
+#pragma omp parallel for reduction(+ : rr)
+            for (int i = 0; i < nval; i++) {
+                wm.r[i] = b[i] - wm.Ax[i];
+                rr += wm.r[i] * wm.r[i];
+            }
+            err = (rr > 0.) ? log10(rr) / 2. - log10(bb) : -DBL_MAX;
+            if (err <= wm.eps) {
+                break;
+            }
+            Vcycle_mg(wm, 0);
+#pragma omp parallel for
+            for (int i = 0; i < nval; i++) {
+                wm.x[i] += wm.ph[i];
+            }
+            ITER++;
+        } while (ITER < wm.maxiter);
+    } else {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            wm.x[i] = 0.;
+        }
+    }
+    wm.iter = ITER;
+    wm.nsolve++;
+
+    if (ITER == wm.maxiter) {
+        fprintf(stderr, "Error: multigrid method is not converged \n");
+        exit_job(EXIT_FAILURE);
+    }
+}
+
+static void Setup_precond(const linear_op &A, work_bicgstab &wm) {
+    switch (wm.precond) {
+        case jacobi_precond:
+            Set_diag_inv(A, wm.diag_inv);
+            break;
+        case block_ilu0_precond:
+            if (A.stencil != NULL) {
+                Set_diag_inv(A, wm.diag_inv);
+            } else {
+                if (!wm.ilu_ready) {
+                    Set_ilu0_pattern(A, wm);
+                }
+                Set_ilu0_factor(A, wm);
+            }
+            break;
+        case chebyshev_precond:
+            Set_diag_inv(A, wm.diag_inv);
+            Set_chebyshev_bounds(A, wm);
+            break;
+        case multigrid_precond:
+            Setup_mg(*A.stencil, wm);
+            break;
+        default:
+            break;
+    }
+}
+
+// z = M^-1 r
+static void Apply_precond(const linear_op &A, work_bicgstab &wm, double *r, double *z) {
+    switch (wm.precond) {
+        case jacobi_precond:
+#pragma omp parallel for
+            for (int i = 0; i < A.nval; i++) {
+                z[i] = wm.diag_inv[i] * r[i];
+            }
+            break;
+        case block_ilu0_precond:
+            if (A.stencil != NULL) {
+                Solve_node_block(A, wm, r, z);
+            } else {
+                Solve_ilu0(wm, A.nval, r, z);
+            }
+            break;
+        case chebyshev_precond:
+            Solve_chebyshev(A, wm, r, z);
+            break;
+        case multigrid_precond:
+            wm.mg[0].b = r;
+            wm.mg[0].x = z;
+            Vcycle_mg(wm, 0);
+            break;
+        default:
+            break;
+    }
+}
+
+/*!
+  \brief Pipelined BiCGSTAB (Cools & Vanroose), right-preconditioned
+  \details Every iteration is two operator passes, t = A M^-1 w and v = A M^-1 z; all vector updates and dot
+  products are fused into them (Apply_A_local), so each pass is one parallel region ending in one reduction.
+  Jacobi (and no preconditioner) is applied inside the passes as well; other preconditioners add their own
+  passes on z and w. The recursive residual drifts from b - A x, so convergence is confirmed on the true
+  residual and the recurrences are restarted from x if it is not met.
+ */
+static void Solve_pipelined(const linear_op &A, double *b, work_bicgstab &wm) {
+    const int     nval        = A.nval;
+    const bool    elementwise = (wm.precond == no_precond || wm.precond == jacobi_precond);
+    const double *dinv        = (wm.precond == jacobi_precond) ? wm.diag_inv : NULL;
+
+    double *x = wm.x, *r = wm.r, *rh = wm.rh, *w = wm.w, *wh = wm.wh, *t = wm.t, *p = wm.p;
+    double *s = wm.s, *sh = wm.sh, *z = wm.z, *zh = wm.zh, *v = wm.v, *q = wm.q, *qh = wm.qh, *y = wm.y;
+    double *r0s = wm.r0s;
+
+    double alpha, beta, omega, r0sr, r0sw, r0ss, r0sz, qy, yy, rr, bb, err;
+
+    if (wm.guess == zero_guess) {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            x[i] = 0.;
+        }
+    }
+    bb = 0.;
+#pragma omp parallel for reduction(+ : bb)
+    for (int i = 0; i < nval; i++) {
+        bb += b[i] * b[i];
+    }
+    bb = sqrt(bb);
+
+    int  ITER      = 0;
+    bool converged = (bb == 0.);
+    bool setup     = false;
+    if (converged) {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            x[i] = 0.;
+        }
+    }
+    while (!converged && ITER < wm.maxiter) {
+        // (re)start from the true residual
+        Apply_A(A, x, wm.Ax);
+        rr = 0.;
+#pragma omp parallel for reduction(+ : rr)
+        for (int i = 0; i < nval; i++) {
+            r[i] = b[i] - wm.Ax[i];
+            rr += r[i] * r[i];
+        }
+        if (rr == 0. || log10(rr) / 2. - log10(bb) <= wm.eps) {
+            converged = true;
+            break;
+        }
+        if (!setup) {
+            Setup_precond(A, wm);
+            setup = true;
+        }
+        if (wm.precond == no_precond) {
+#pragma omp parallel for
+            for (int i = 0; i < nval; i++) {
+                rh[i] = r[i];
+            }
+        } else {
+            Apply_precond(A, wm, r, rh);
+        }
+        Apply_A(A, rh, w);
+        if (wm.precond == no_precond) {
+#pragma omp parallel for
+            for (int i = 0; i < nval; i++) {
+                wh[i] = w[i];
+            }
+        } else {
+            Apply_precond(A, wm, w, wh);
+        }
+        r0sw = 0.;
+#pragma omp parallel for reduction(+ : r0sw)
+        for (int i = 0; i < nval; i++) {
+            r0s[i] = r[i];
+            r0sw += r[i] * w[i];
+        }
+        r0sr  = rr;
+        alpha = r0sr / r0sw;
+        beta  = 0.;
+        omega = 0.;
+
+        do {
+            // pass 1: t = A M^-1 w; p, s, z and the half-step q, y; omega
+            qy = 0.;
+            yy = 0.;
+#pragma omp parallel reduction(+ : qy, yy)
+            {
+                row_range rows;
+                Apply_A_local(A, wh, t, rows);
+                for (int n = 0; n < rows.nseg; n++) {
+                    for (int i = rows.begin[n]; i < rows.end[n]; i++) {
+                        p[i]  = rh[i] + beta * (p[i] - omega * sh[i]);
+                        s[i]  = w[i] + beta * (s[i] - omega * z[i]);
+                        sh[i] = wh[i] + beta * (sh[i] - omega * zh[i]);
+                        z[i]  = t[i] + beta * (z[i] - omega * v[i]);
+                        q[i]  = r[i] - alpha * s[i];
+                        qh[i] = rh[i] - alpha * sh[i];
+                        y[i]  = w[i] - alpha * z[i];
+                        if (elementwise) {
+                            zh[i] = (dinv != NULL) ? dinv[i] * z[i] : z[i];
+                        }
+                        qy += q[i] * y[i];
+                        yy += y[i] * y[i];
+                    }
+                }
+            }
+            if (!elementwise) {
+                Apply_precond(A, wm, z, zh);
+            }
+            omega = (yy > 0.) ? qy / yy : 0.;
+
+            // pass 2: v = A M^-1 z; x, r, w; alpha and beta of the next iteration
+            double r0sr_n = 0.;
+            r0sw          = 0.;
+            r0ss          = 0.;
+            r0sz          = 0.;
+            rr            = 0.;
+#pragma omp parallel reduction(+ : r0sr_n, r0sw, r0ss, r0sz, rr)
+            {
+                row_range rows;
+                Apply_A_local(A, zh, v, rows);
+                for (int n = 0; n < rows.nseg; n++) {
+                    for (int i = rows.begin[n]; i < rows.end[n]; i++) {
+                        x[i] += alpha * p[i] + omega * qh[i];
+                        r[i]  = q[i] - omega * y[i];
+                        rh[i] = qh[i] - omega * (wh[i] - alpha * zh[i]);
+                        w[i]  = y[i] - omega * (t[i] - alpha * v[i]);
+                        if (elementwise) {
+                            wh[i] = (dinv != NULL) ? dinv[i] * w[i] : w[i];
+                        }
+                        r0sr_n += r0s[i] * r[i];
+                        r0sw += r0s[i] * w[i];
+                        r0ss += r0s[i] * s[i];
+                        r0sz += r0s[i] * z[i];
+                        rr += r[i] * r[i];
+                    }
+                }
+            }
+            if (!elementwise) {
+                Apply_precond(A, wm, w, wh);
+            }
+            ITER++;
+
+            err   = (rr > 0.) ? log10(rr) / 2. - log10(bb) : -DBL_MAX;
+            beta  = (alpha / omega) * (r0sr_n / r0sr);
+            alpha = r0sr_n / (r0sw + beta * r0ss - beta * omega * r0sz);
+            r0sr  = r0sr_n;
+        } while (err > wm.eps && ITER < wm.maxiter && omega != 0.);
+    }
+    wm.iter = ITER;
+    wm.nsolve++;
+
+    if (!converged) {
+        fprintf(stderr, "Error: pipelined BiCGSTAB method is not converged \n");
+        exit_job(EXIT_FAILURE);
+    }
+}
+
+// A x on the float copy of the operator (Setup_mixed), accumulated in double
+static void Apply_A_f(const linear_op &A, const work_bicgstab &wm, const float *x, float *ans) {
+    if (A.stencil != NULL) {
+        const ns_stencil &S     = *A.stencil;
+        const float *     eta_s = (S.eta_s != NULL) ? wm.f_eta_s : NULL;
+#pragma omp parallel for
+        for (int i = 0; i < S.nx; i++) {
+            Calc_Ax_ns_planes(x, S, wm.f_u_s, eta_s, ans, i, i + 1);
+        }
+    } else {
+        const int nslice = (A.nval + SELL_C - 1) / SELL_C;
+#pragma omp parallel for
+        for (int s = 0; s < nslice; s++) {
+            Calc_Ax_sell(x, A.idx, wm.f_val, A.width, ans, A.nval, s, s + 1);
+        }
+    }
+}
+
+// float copies of the operator and of the (double) preconditioner setup
+static void Setup_mixed(const linear_op &A, work_bicgstab &wm) {
+    if (A.stencil != NULL) {
+        const ns_stencil &S = *A.stencil;
+        const int         n = S.nx * S.ny * S.nz_;
+        for (int d = 0; d < DIM; d++) {
+#pragma omp parallel for
+            for (int i = 0; i < n; i++) {
+                wm.f_u_s[d][i] = S.u_s[d][i];
+            }
+        }
+        if (S.eta_s != NULL) {
+#pragma omp parallel for
+            for (int i = 0; i < n; i++) {
+                wm.f_eta_s[i] = S.eta_s[i];
+            }
+        }
+    } else {
+        const int nnz = sell_size(A.nval, A.width);
+#pragma omp parallel for
+        for (int ii = 0; ii < nnz; ii++) {
+            wm.f_val[ii] = A.val[ii];
+        }
+    }
+    Setup_precond(A, wm);
+    if (wm.precond != no_precond) {
+#pragma omp parallel for
+        for (int i = 0; i < A.nval; i++) {
+            wm.f_diag_inv[i] = wm.diag_inv[i];
+        }
+    }
+}
+
+// Jacobi or Chebyshev (see Solve_chebyshev) on float vectors
+static void Apply_precond_f(const linear_op &A, work_bicgstab &wm, const float *r, float *z) {
+    const int nval = A.nval;
+    if (wm.precond == jacobi_precond) {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            z[i] = wm.f_diag_inv[i] * r[i];
+        }
+        return;
+    }
+    const double theta = 0.5 * (wm.lmax + wm.lmin);
+    const double delta = 0.5 * (wm.lmax - wm.lmin);
+    const double sigma = theta / delta;
+    double       rho   = 1. / sigma;
+
+#pragma omp parallel for
+    for (int i = 0; i < nval; i++) {
+        wm.f_res[i] = wm.f_diag_inv[i] * r[i];
+        wm.f_dir[i] = wm.f_res[i] / theta;
+        z[i]        = wm.f_dir[i];
+    }
+    for (int m = 1; m < wm.degree; m++) {
+        Apply_A_f(A, wm, z, wm.f_Ax);
+        const double rho_new = 1. / (2. * sigma - rho);
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            wm.f_res[i] = wm.f_diag_inv[i] * (r[i] - wm.f_Ax[i]);
+            wm.f_dir[i] = rho_new * rho * wm.f_dir[i] + 2. * rho_new / delta * wm.f_res[i];
+            z[i] += wm.f_dir[i];
+        }
+        rho = rho_new;
+    }
+}
+
+/*!
+  \brief Float BiCGSTAB for A e = f_r from e = 0, until |r| <= 10^eps |f_r| or maxiter
+  \details Same right-preconditioned iteration as bicgstab_solve; vectors are float, dot products double.
+  Returns the number of iterations; the correction is left in f_x.
+ */
+static int Solve_inner_f(const linear_op &A, work_bicgstab &wm, double eps, int maxiter) {
+    const int nval = A.nval;
+    float *   x = wm.f_x, *r = wm.f_r, *r0s = wm.f_r0s, *p = wm.f_p, *t = wm.f_t, *Ap = wm.f_Ap, *At = wm.f_At;
+    float *   ph = (wm.precond == no_precond) ? p : wm.f_ph;
+    float *   th = (wm.precond == no_precond) ? t : wm.f_th;
+
+    double alpha = 0., beta = 0., zeta = 0., r0sr = 0., r0sAp, tAt, AtAt, rr0 = 0., rr;
+#pragma omp parallel for reduction(+ : r0sr)
+    for (int i = 0; i < nval; i++) {
+        x[i]   = 0.f;
+        r0s[i] = r[i];
+        r0sr += (double)r[i] * r[i];
+    }
+    rr0 = r0sr;
+
+    int ITER = 0;
+    do {
+        if (ITER == 0) {
+#pragma omp parallel for
+            for (int i = 0; i < nval; i++) {
+                p[i] = r[i];
+            }
+        } else {
+            const float beta_f = beta, zeta_f = zeta;
+#pragma omp parallel for
+            for (int i = 0; i < nval; i++) {
+                p[i] = r[i] + beta_f * (p[i] - zeta_f * Ap[i]);
+            }
+        }
+        if (wm.precond != no_precond) {
+            Apply_precond_f(A, wm, p, ph);
+        }
+        Apply_A_f(A, wm, ph, Ap);
+        r0sAp = 0.;
+#pragma omp parallel for reduction(+ : r0sAp)
+        for (int i = 0; i < nval; i++) {
+            r0sAp += (double)r0s[i] * Ap[i];
+        }
+        alpha               = r0sr / r0sAp;
+        const float alpha_f = alpha;
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            t[i] = r[i] - alpha_f * Ap[i];
+        }
+        if (wm.precond != no_precond) {
+            Apply_precond_f(A, wm, t, th);
+        }
+        Apply_A_f(A, wm, th, At);
+        tAt  = 0.;
+        AtAt = 0.;
+#pragma omp parallel for reduction(+ : tAt, AtAt)
+        for (int i = 0; i < nval; i++) {
+            tAt += (double)t[i] * At[i];
+            AtAt += (double)At[i] * At[i];
+        }
+        zeta               = (AtAt > 0.) ? tAt / AtAt : 0.;
+        const float zeta_f = zeta;
+
+        const double r0sr_o = r0sr;
+        r0sr                = 0.;
+        rr                  = 0.;
+#pragma omp parallel for reduction(+ : r0sr, rr)
+        for (int i = 0; i < nval; i++) {
+            x[i] += alpha_f * ph[i] + zeta_f * th[i];
+            r[i] = t[i] - zeta_f * At[i];
+            r0sr += (double)r0s[i] * r[i];
+            rr += (double)r[i] * r[i];
+        }
+        beta = (r0sr / r0sr_o) * (alpha / zeta);
+        ITER++;
+    } while (rr > 0. && zeta != 0. && log10(rr / rr0) / 2. > eps && ITER < maxiter);
+    return ITER;
+}
+
+/*!
+  \brief Mixed-precision iterative refinement
+  \details The residual b - A x and the update x += e are double; the correction e comes from a float BiCGSTAB
+  on float copies of the operator, reducing the residual by 10^inner_eps (or what is left to reach eps) per
+  refinement. The stopping criterion is the double-precision one of bicgstab_solve; iter counts inner iterations.
+ */
+static void Solve_mixed(const linear_op &A, double *b, work_bicgstab &wm) {
+    const double inner_eps = -4.;
+    const int    nval      = A.nval;
+    double       rr, bb, err;
+
+    if (wm.guess == zero_guess) {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            wm.x[i] = 0.;
+        }
+    }
+    bb = 0.;
+#pragma omp parallel for reduction(+ : bb)
+    for (int i = 0; i < nval; i++) {
+        bb += b[i] * b[i];
+    }
+    bb = sqrt(bb);
+
+    int  ITER      = 0;
+    bool converged = (bb == 0.);
+    bool setup     = false;
+    if (converged) {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            wm.x[i] = 0.;
+        }
+    }
+    while (!converged && ITER < wm.maxiter) {
+        Apply_A(A, wm.x, wm.Ax);
+        rr = 0.;
+#pragma omp parallel for reduction(+ : rr)
+        for (int i = 0; i < nval; i++) {
+            double r  = b[i] - wm.Ax[i];
+            wm.f_r[i] = r;
+            rr += r * r;
+        }
+        err = (rr > 0.) ? log10(rr) / 2. - log10(bb) : -DBL_MAX;
+        if (err <= wm.eps) {
+            converged = true;
+            break;
+        }
+        if (!setup) {
+            Setup_mixed(A, wm);
+            setup = true;
+        }
+        ITER += Solve_inner_f(A, wm, MAX(inner_eps, wm.eps - err), wm.maxiter - ITER);
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            wm.x[i] += wm.f_x[i];
+        }
+    }
+    wm.iter = ITER;
+    wm.nsolve++;
+
+    if (!converged) {
+        fprintf(stderr, "Error: mixed-precision refinement is not converged \n");
+        exit_job(EXIT_FAILURE);
+    }
+}
+
+// right-preconditioned: r is the residual of the original system, so the stopping criterion is unchanged
+static void bicgstab_solve(const linear_op &A, double *b, work_bicgstab &wm) {
+    if (wm.precond == multigrid_precond && wm.mg_standalone) {
+        Solve_multigrid(A, b, wm);
+        return;
+    }
+    if (wm.mixed) {
+        Solve_mixed(A, b, wm);
+        return;
+    }
+    if (wm.pipelined) {
+        Solve_pipelined(A, b, wm);
+        return;
+    }
+    const int nval = A.nval;
+    double *  ph   = (wm.precond == no_precond) ? wm.p : wm.ph;
+    double *  th   = (wm.precond == no_precond) ? wm.t : wm.th;
+
+    double alpha, beta, zeta, r0sr, r0sr_o, r0sAp, tAt, AtAt;
+    double err, rr, bb;
+
+    // x holds the initial guess unless zero_guess; the other work vectors are written before they are read
+    const bool warm = (wm.guess != zero_guess);
+    int        ITER = 0;
+    if (warm) {
+        Apply_A(A, wm.x, wm.Ax);
+    } else {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            wm.x[i] = 0.;
+        }
+    }
+    bb    = 0.;
+    alpha = 0.;
+    beta  = 0.;
+    r0sr  = 0.;
+    zeta  = 0.;
+
+#pragma omp parallel for reduction(+ : r0sr, bb)
+    for (int i = 0; i < nval; i++) {
+        wm.r[i] = (warm) ? b[i] - wm.Ax[i] : b[i];
+        bb += b[i] * b[i];
+        wm.r0s[i] = wm.r[i];
+        r0sr += wm.r[i] * wm.r0s[i];
+    }
+    bb = sqrt(bb);
+    if (bb == 0.) {
+#pragma omp parallel for
+        for (int i = 0; i < nval; i++) {
+            wm.x[i] = 0.;
+        }
+    }
+    const bool converged = warm && (r0sr == 0. || log10(r0sr) / 2. - log10(bb) <= wm.eps);
+    if (bb > 0. && !converged) {
+        Setup_precond(A, wm);
+        do {
+            if (ITER == 0) {
+#pragma omp parallel for
+                for (int i = 0; i < nval; i++) {
+                    wm.p[i] = wm.r[i];
+                }
+            } else {
+#pragma omp parallel for
+                for (int i = 0; i < nval; i++) {
+                    wm.p[i] = wm.r[i] + beta * (wm.p[i] - zeta * wm.Ap[i]);
+                }
+            }
+            if (wm.precond != no_precond) {
+                Apply_precond(A, wm, wm.p, ph);
+            }
+            Apply_A(A, ph, wm.Ap);
+            r0sAp = 0.;
+#pragma omp parallel for reduction(+ : r0sAp)
+            for (int i = 0; i < nval; i++) {
+                r0sAp += wm.r0s[i] * wm.Ap[i];
+            }
+            alpha = r0sr / r0sAp;
+
+#pragma omp parallel for
+            for (int i = 0; i < nval; i++) {
+                wm.t[i] = wm.r[i] - alpha * wm.Ap[i];
+            }
+
+            if (wm.precond != no_precond) {
+                Apply_precond(A, wm, wm.t, th);
+            }
+            Apply_A(A, th, wm.At);
+            tAt  = 0.;
+            AtAt = 0.;
+#pragma omp parallel for reduction(+ : tAt, AtAt)
+            for (int i = 0; i < nval; i++) {
+                tAt += wm.t[i] * wm.At[i];
+                AtAt += wm.At[i] * wm.At[i];
+            }
+            zeta = tAt / AtAt;
+
+            r0sr_o = r0sr;
+            r0sr   = 0.;
+            rr     = 0.;
+#pragma omp parallel for reduction(+ : r0sr, rr)
+            for (int i = 0; i < nval; i++) {
+                wm.x[i] += alpha * ph[i] + zeta * th[i];
+                wm.r[i] = wm.t[i] - zeta * wm.At[i];
+                r0sr += wm.r0s[i] * wm.r[i];
+                rr += wm.r[i] * wm.r[i];
+            }
+            err  = log10(rr) / 2. - log10(bb);
+            beta = r0sr / (zeta * r0sAp);
+            ITER++;
+        } while (err > wm.eps && ITER < wm.maxiter);
+    }
+    wm.iter = ITER;
+    wm.nsolve++;
+
+    if (ITER == wm.maxiter) {
+        fprintf(stderr, "Error: BiCGSTAB method is not converged \n");
+        exit_job(EXIT_FAILURE);
+    } else {
+        // fprintf(stderr, "ITER: %d \n", ITER);
+    }
+}
+
+void bicgstab(int *idx, double *val, int width, double *b, work_bicgstab &wm, int nval) {
+    const linear_op A = {idx, val, width, NULL, nval};
+    bicgstab_solve(A, b, wm);
+}
+
+/*!
+  \brief Uniform-viscosity momentum system as DIM scalar solves
+  \details Without eta_s no row couples different components except the oblique frame term u_x <- u_y, so the
+  system is block lower triangular: u_y and u_z are solved first and Shear_rate_eff u_y is moved into the
+  u_x slice of b (b is overwritten). Each component works on a third of the vectors and stops on its own; its
+  tolerance is shifted so that the components together meet |r| <= 10^eps |b|. iter is the largest count.
+ */
+static void bicgstab_split(const ns_stencil &A, double *b, work_bicgstab &wm, int nval) {
+    const int    nxyz     = nval / DIM;
+    const int    order[3] = {1, 2, 0};
+    double *     x        = wm.x;
+    const double eps      = wm.eps;
+    const int    nsolve   = wm.nsolve;
+
+    double bb = 0.;
+#pragma omp parallel for reduction(+ : bb)
+    for (int i = 0; i < nval; i++) {
+        bb += b[i] * b[i];
+    }
+    int iter_max = 0;
+    for (int n = 0; n < DIM; n++) {
+        const int d = (A.oblique) ? order[n] : n;
+        if (d == 0 && A.oblique) {
+            const double *x1 = x + nxyz;
+#pragma omp parallel for
+            for (int c = 0; c < nxyz; c++) {
+                b[c] -= Shear_rate_eff * x1[c];
+            }
+        }
+        double bb_d = 0.;
+#pragma omp parallel for reduction(+ : bb_d)
+        for (int c = 0; c < nxyz; c++) {
+            bb_d += b[d * nxyz + c] * b[d * nxyz + c];
+        }
+
+        ns_stencil A_d = A;
+        A_d.comp       = d;
+
+        // wm itself is solved on, so the preconditioner state it keeps (ILU pattern, Chebyshev bounds) carries over
+        wm.x = x + d * nxyz;
+        if (bb_d > 0.) {
+            wm.eps = eps + 0.5 * log10(bb / (DIM * bb_d));
+        }
+        const linear_op op = {NULL, NULL, 0, &A_d, nxyz};
+        bicgstab_solve(op, b + d * nxyz, wm);
+        iter_max = MAX(iter_max, wm.iter);
+        wm.x     = x;
+        wm.eps   = eps;
+    }
+    wm.iter   = iter_max;
+    wm.nsolve = nsolve + 1;
+}
+
+void bicgstab(const ns_stencil &A, double *b, work_bicgstab &wm, int nval) {
+    if (wm.split && A.eta_s == NULL) {
+        bicgstab_split(A, b, wm, nval);
+        return;
+    }
+    const linear_op op = {NULL, NULL, 0, &A, nval};
+    bicgstab_solve(op, b, wm);
+}
+void Init_ns(void) {
+    wm_ns.eps           = eps_ns;
+    wm_ns.maxiter       = maxiter_ns;
+    wm_ns.precond       = precond_ns;
+    wm_ns.degree        = cheb_degree_ns;
+    wm_ns.mg_sweeps     = mg_sweeps_ns;
+    wm_ns.mg_standalone = mg_standalone_ns;
+    wm_ns.split         = split_ns;
+    fprintf(stderr, "# NS iter setting: %f %d\n", wm_ns.eps, wm_ns.maxiter);
+    fprintf(stderr, "# NS initial guess: %s\n", INITIAL_GUESS_name[wm_ns.guess]);
+    fprintf(stderr, "# NS Krylov method: %s\n", (wm_ns.pipelined) ? "pipelined BiCGSTAB" : "BiCGSTAB");
+    if (wm_ns.mixed) {
+        fprintf(stderr, "# NS mixed precision: ON (float inner solve, double residual)\n");
+    }
+    if (wm_ns.split) {
+        fprintf(stderr, "# NS component split: ON (uniform viscosity solves only)\n");
+    }
+    fprintf(stderr, "# NS preconditioner: %s", PRECOND_name[wm_ns.precond]);
+    if (wm_ns.precond == block_ilu0_precond) {
+        fprintf(stderr, " (matrix-free operator: %d x %d velocity blocks)", DIM, DIM);
+    } else if (wm_ns.precond == chebyshev_precond) {
+        fprintf(stderr, " (degree %d)", wm_ns.degree);
+    } else if (wm_ns.precond == multigrid_precond) {
+        const mg_level &C = wm_ns.mg[wm_ns.mg_nlevel - 1];
+        fprintf(stderr,
+                " (%d levels, coarsest %d x %d x %d %s, %d sweeps%s)",
+                wm_ns.mg_nlevel,
+                C.A.nx,
+                C.A.ny,
+                C.A.nz,
+                (wm_ns.mg_inv != NULL) ? "direct" : "smoothed",
+                wm_ns.mg_sweeps,
+                (wm_ns.mg_standalone) ? ", standalone" : "");
+    }
+    fprintf(stderr, "\n");
+}
+void Init_ch(void) {
+    wm_ch.eps     = eps_ch;
+    wm_ch.maxiter = maxiter_ch;
+    wm_ch.precond = precond_ch;
+    wm_ch.degree  = cheb_degree_ch;
+    fprintf(stderr, "# CH iter setting: %f %d\n", wm_ch.eps, wm_ch.maxiter);
+    fprintf(stderr, "# CH initial guess: %s\n", INITIAL_GUESS_name[wm_ch.guess]);
+    fprintf(stderr, "# CH Krylov method: %s\n", (wm_ch.pipelined) ? "pipelined BiCGSTAB" : "BiCGSTAB");
+    if (wm_ch.mixed) {
+        fprintf(stderr, "# CH mixed precision: ON (float inner solve, double residual)\n");
+    }
+    fprintf(stderr, "# CH preconditioner: %s", PRECOND_name[wm_ch.precond]);
+    if (wm_ch.precond == block_ilu0_precond) {
+        fprintf(stderr, " (%d blocks)", wm_ch.ilu_nblock);
+    } else if (wm_ch.precond == chebyshev_precond) {
+        fprintf(stderr, " (degree %d)", wm_ch.degree);
+    }
+    fprintf(stderr, "\n");
 }
 
 void Make_potential_deriv(double *f_prime, double *psi) {
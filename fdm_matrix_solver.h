@@ -9,6 +9,20 @@
 #include "lis.h"
 #endif
 
+/*!
+  \brief Rows per slice of the sliced-ELLPACK (SELL-C) storage of the assembled CH matrix
+  \details Entry q of the rows of a slice is stored contiguously at sell_offset(row, width) + SELL_C * q, so the
+  SpMV runs over the rows of a slice in SIMD lanes. All rows have the same width, so no row sorting is needed.
+  LIS takes the rows as CSR, which is the SELL_C == 1 case.
+ */
+#ifdef _LIS_SOLVER
+const int SELL_C = 1;
+#else
+const int SELL_C = 8;
+#endif
+inline int sell_offset(int row, int width) { return (row / SELL_C) * width * SELL_C + row % SELL_C; }
+inline int sell_size(int nrow, int width) { return ((nrow + SELL_C - 1) / SELL_C) * width * SELL_C; }
+
 #ifdef _LIS_SOLVER
 extern LIS_INT *   ptr_ns, *idx_ns_csr;
 extern LIS_SCALAR *val_ns_csr;
@@ -24,9 +38,15 @@ extern LIS_VECTOR  b_ch, x_ch;
 extern LIS_SOLVER  lis_solver_ch;
 extern LIS_INT     is_ch, ie_ch;
 #else
+struct mg_level;
+
 struct work_bicgstab {
     double  eps;
     int     maxiter;
+    int     iter;    // iterations of the last solve
+    IG      guess;   // initial guess in x (see Set_initial_guess)
+    int     nsolve;  // number of solves so far
+    double *x_o;     // previous solution, for extrapolated_guess
     double *p;
     double *r;
     double *t;
@@ -35,6 +55,105 @@ struct work_bicgstab {
     double *r0s;
     double *x;
     double *Ax;
+
+    // preconditioner (right preconditioning, see Setup_precond / Apply_precond)
+    PC      precond;
+    int     degree;    // Chebyshev polynomial degree
+    double  lmin;      // spectral bounds of D^-1 A for Chebyshev
+    double  lmax;
+    double *ph;        // M^-1 p
+    double *th;        // M^-1 t
+    double *diag_inv;  // inverse diagonal of A
+    double *res;       // Chebyshev work
+    double *dir;
+
+    // block-Jacobi ILU(0), one block per thread, on a sorted copy of the CSR pattern
+    int     ilu_nblock;
+    int     ilu_ready;  // pattern built
+    int *   ilu_ptr;
+    int *   ilu_idx;
+    int *   ilu_diag;
+    int *   ilu_map;  // CSR entry -> ILU entry (-1: outside the block)
+    int *   ilu_iw;
+    double *ilu_val;
+
+    // geometric multigrid, matrix-free NS operator only
+    int       mg_nlevel;
+    int       mg_sweeps;      // pre- and post-smoothing sweeps
+    int       mg_standalone;  // iterate V-cycles instead of BiCGSTAB
+    mg_level *mg;
+    double ** mg_mat;  // dense coarsest operator and its inverse (NULL: smoothing only)
+    double ** mg_inv;
+
+    // uniform-viscosity NS system solved one velocity component at a time (see bicgstab)
+    int split;
+
+    // mixed-precision iterative refinement (see Solve_mixed): float operator copy and inner BiCGSTAB vectors
+    int     mixed;
+    float * f_val;  // CSR values
+    float **f_u_s;  // stencil coefficients, padded like u_s
+    float * f_eta_s;
+    float * f_diag_inv;
+    float * f_x;
+    float * f_r;
+    float * f_r0s;
+    float * f_p;
+    float * f_t;
+    float * f_Ap;
+    float * f_At;
+    float * f_ph;
+    float * f_th;
+    float * f_Ax;  // Chebyshev work
+    float * f_res;
+    float * f_dir;
+
+    // pipelined BiCGSTAB (see Solve_pipelined); p holds M^-1 p, the *h vectors are M^-1 times their partner
+    int     pipelined;
+    double *w;  // A M^-1 r
+    double *wh;
+    double *rh;
+    double *s;
+    double *sh;
+    double *z;
+    double *zh;
+    double *v;
+    double *q;
+    double *qh;
+    double *y;
+};
+
+/*!
+  \brief Coefficients of the implicit MAC momentum operator, applied matrix-free
+  \details Rows follow ijkd2idx ordering on an nx * ny * nz grid (the fluid mesh, or a coarser multigrid level).
+  eta_s == NULL selects the uniform viscosity NU; oblique adds the sheared-grid cross terms and the frame
+  coupling to u_y.
+ */
+struct ns_stencil {
+    double **u_s;
+    double * eta_s;
+    double   inv_dt;
+    double   gt;
+    bool     oblique;
+    int      nx, ny, nz;
+    int      nz_;  // z stride of u_s and eta_s
+    double   dx;
+    int      comp;  // -1: all DIM components; d: the scalar system of component d only (eta_s == NULL)
+};
+
+/*!
+  \brief One level of the geometric multigrid for the momentum operator
+  \details Level 0 is the fluid mesh; each coarser level halves the mesh in every direction and
+  rediscretizes the stencil with the 2x2x2-averaged u_s and eta_s.
+ */
+struct mg_level {
+    ns_stencil A;
+    int        n;      // DIM * nx * ny * nz
+    double **  u_s;    // restricted advecting velocity (level > 0)
+    double *   eta_s;  // restricted viscosity (level > 0)
+    double *   x;
+    double *   b;
+    double *   r;
+    double *   diag_inv;
 };
 
 extern work_bicgstab wm_ns;
@@ -46,21 +165,16 @@ void Init_lis(int argc, char *argv[]);
 void Mem_alloc_lis(void);
 void Free_lis(void);
 #else
-void                 Init_ns(void);
-void                 Init_ch(void);
-inline void          Calc_Ax(double *x, int *idx, double *val, int *row_ptr, double *ans, int iend) {
-#pragma omp parallel for
-    for (int i = 0; i < iend; i++) {
-        double sum = 0.;
-        for (int ii = row_ptr[i]; ii < row_ptr[i + 1]; ii++) {
-            sum += val[ii] * x[idx[ii]];
-        }
-        ans[i] = sum;
-    }
-}
+void Init_ns(void);
+void Init_ch(void);
+void Calc_Ax(double *x, int *idx, double *val, int width, double *ans, int nrow);
+void Calc_Ax_ns(double *x, const ns_stencil &A, double *ans);
+void Calc_diag_ns(const ns_stencil &A, double *diag);
+void Set_initial_guess(double **field, int ncomp, work_bicgstab &wm);
 void Mem_alloc_matrix_solver(void);
 void Free_matrix_solver(void);
-void bicgstab(int *idx, double *val, int *row_ptr, double *b, work_bicgstab &wm, int iend);
+void bicgstab(int *idx, double *val, int width, double *b, work_bicgstab &wm, int iend);
+void bicgstab(const ns_stencil &A, double *b, work_bicgstab &wm, int iend);
 #endif
 
 void NS_MAC_solver_implicit(double **u, double *pressure, double **u_s, const CTime &jikan, int is_ns, int ie_ns);
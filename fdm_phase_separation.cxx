@@ -9,149 +9,220 @@ double * phi_obl;
 double **stress;
 double **stress_o;
 
-void        Calc_cp(double *phi, double *psi, double *cp) {
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
+// chemical potential at one grid point
+static inline double Cp_at(const double *phi, const double *psi, const Stencil_point &sp) {
+    const int im = sp.im;
 
-                double lap_psi = calc_laplacian(psi, im);
+    double lap_psi = calc_laplacian(psi, sp);
 
-                double dphi_dx = calc_gradient_o1_to_o1(phi, im, 0);
-                double dphi_dy = calc_gradient_o1_to_o1(phi, im, 1);
-                double dphi_dz = calc_gradient_o1_to_o1(phi, im, 2);
+    double dphi_dx = calc_gradient_o1_to_o1(phi, sp, 0);
+    double dphi_dy = calc_gradient_o1_to_o1(phi, sp, 1);
+    double dphi_dz = calc_gradient_o1_to_o1(phi, sp, 2);
 
-                double dpsi_dx = calc_gradient_o1_to_o1(psi, im, 0);
-                double dpsi_dy = calc_gradient_o1_to_o1(psi, im, 1);
-                double dpsi_dz = calc_gradient_o1_to_o1(psi, im, 2);
+    double dpsi_dx = calc_gradient_o1_to_o1(psi, sp, 0);
+    double dpsi_dy = calc_gradient_o1_to_o1(psi, sp, 1);
+    double dpsi_dz = calc_gradient_o1_to_o1(psi, sp, 2);
 
-                double grad_phi_norm = dphi_dx * dphi_dx + dphi_dy * dphi_dy + dphi_dz * dphi_dz;
+    double grad_phi_norm = dphi_dx * dphi_dx + dphi_dy * dphi_dy + dphi_dz * dphi_dz;
 
-                cp[im] = potential_deriv(psi[im]) - (ps.alpha + 2. * ps.z * phi[im]) * lap_psi -
-                         2. * ps.z * (dphi_dx * dpsi_dx + dphi_dy * dpsi_dy + dphi_dz * dpsi_dz) +
-                         ps.w * A_XI * grad_phi_norm + 2. * ps.d * (psi[im] - ps.neutral) * phi[im];
+    return potential_deriv(psi[im]) - (ps.alpha + 2. * ps.z * phi[im]) * lap_psi -
+           2. * ps.z * (dphi_dx * dpsi_dx + dphi_dy * dpsi_dy + dphi_dz * dpsi_dz) + ps.w * A_XI * grad_phi_norm +
+           2. * ps.d * (psi[im] - ps.neutral) * phi[im];
+}
+
+void        Calc_cp(double *phi, double *psi, double *cp) {
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    cp[sp.im]        = Cp_at(phi, psi, sp);
+                }
             }
         }
     }
 }
-void        Calc_cp_wall(double *phi, double *phi_p, double *phi_wall_prime, double *psi_all, double *cp) {
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
 
-                double lap_psi = calc_laplacian(psi_all, im);
-
-                double dphi_dx      = calc_gradient_o1_to_o1(phi_p, im, 0);
-                double dphi_dy      = calc_gradient_o1_to_o1(phi_p, im, 1);
-                double dphi_dz      = calc_gradient_o1_to_o1(phi_p, im, 2);
-                double dphi_wall_dx = calc_gradient_o1_to_o1(phi_wall, im, 0);
-                double dphi_wall_dy = calc_gradient_o1_to_o1(phi_wall, im, 1);
-                double dphi_wall_dz = calc_gradient_o1_to_o1(phi_wall, im, 2);
-
-                double dpsi_dx = calc_gradient_o1_to_o1(psi_all, im, 0);
-                double dpsi_dy = calc_gradient_o1_to_o1(psi_all, im, 1);
-                double dpsi_dz = calc_gradient_o1_to_o1(psi_all, im, 2);
+static void Calc_cp_plane(double *phi, double *psi, double *cp, int i) {
+    for (int j = 0; j < NY; j++) {
+        for (int k = 0; k < NZ; k++) {
+            Stencil_point sp = stencil_point(i, j, k);
+            cp[sp.im]        = Cp_at(phi, psi, sp);
+        }
+    }
+}
 
-                double grad_phi_norm = dphi_dx * dphi_dx + dphi_dy * dphi_dy + dphi_dz * dphi_dz;
-                double grad_phi_wall_norm =
-                    dphi_wall_dx * dphi_wall_dx + dphi_wall_dy * dphi_wall_dy + dphi_wall_dz * dphi_wall_dz;
+static void Cp2stress_plane(double *cp, double *psi, double **stress, int i) {
+    for (int j = 0; j < NY; j++) {
+        for (int k = 0; k < NZ; k++) {
+            Stencil_point sp = stencil_point(i, j, k);
+            int           im = sp.im;
+            stress[0][im]    = psi[im] * calc_gradient_o1_to_o1(cp, sp, 0) * IRHO;
+            stress[1][im]    = psi[im] * calc_gradient_o1_to_o1(cp, sp, 1) * IRHO;
+            stress[2][im]    = psi[im] * calc_gradient_o1_to_o1(cp, sp, 2) * IRHO;
+        }
+    }
+}
 
-                cp[im] = potential_deriv(psi_all[im]) - (ps.alpha + 2. * ps.z * phi[im]) * lap_psi -
-                         2.0 * ps.z * (dphi_dx * dpsi_dx + dphi_dy * dpsi_dy + dphi_dz * dpsi_dz) +
-                         ps.w * A_XI * grad_phi_norm + ps.w_wall * A_XI * grad_phi_wall_norm +
-                         2. * ps.d * (psi_all[im] - ps.neutral) * phi_p[im] +
-                         2. * ps.d * (psi_all[im] - ps.neutral_wall[im]) * phi_wall_prime[im];
+void Calc_cp_stress(double *phi, double *psi, double *cp, double **stress) {
+#pragma omp parallel
+    {
+        const int nthread = omp_get_num_threads();
+        const int tid     = omp_get_thread_num();
+        const int i0      = NX * tid / nthread;
+        const int i1      = NX * (tid + 1) / nthread;
+
+        // end planes of each slab are also read by the neighbouring threads
+        if (i0 < i1) {
+            Calc_cp_plane(phi, psi, cp, i0);
+            if (i1 - 1 > i0) {
+                Calc_cp_plane(phi, psi, cp, i1 - 1);
+            }
+        }
+#pragma omp barrier
+        // interior cp planes are produced one plane ahead of the stress sweep and consumed while cached
+        for (int i = i0; i < i1; i++) {
+            if (i + 1 < i1 - 1) {
+                Calc_cp_plane(phi, psi, cp, i + 1);
+            }
+            Cp2stress_plane(cp, psi, stress, i);
+        }
+    }
+}
+void        Calc_cp_wall(double *phi, double *phi_p, double *phi_wall_prime, double *psi_all, double *cp) {
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double lap_psi = calc_laplacian(psi_all, sp);
+
+                    double dphi_dx      = calc_gradient_o1_to_o1(phi_p, sp, 0);
+                    double dphi_dy      = calc_gradient_o1_to_o1(phi_p, sp, 1);
+                    double dphi_dz      = calc_gradient_o1_to_o1(phi_p, sp, 2);
+                    double dphi_wall_dx = calc_gradient_o1_to_o1(phi_wall, sp, 0);
+                    double dphi_wall_dy = calc_gradient_o1_to_o1(phi_wall, sp, 1);
+                    double dphi_wall_dz = calc_gradient_o1_to_o1(phi_wall, sp, 2);
+
+                    double dpsi_dx = calc_gradient_o1_to_o1(psi_all, sp, 0);
+                    double dpsi_dy = calc_gradient_o1_to_o1(psi_all, sp, 1);
+                    double dpsi_dz = calc_gradient_o1_to_o1(psi_all, sp, 2);
+
+                    double grad_phi_norm = dphi_dx * dphi_dx + dphi_dy * dphi_dy + dphi_dz * dphi_dz;
+                    double grad_phi_wall_norm =
+                        dphi_wall_dx * dphi_wall_dx + dphi_wall_dy * dphi_wall_dy + dphi_wall_dz * dphi_wall_dz;
+
+                    cp[im] = potential_deriv(psi_all[im]) - (ps.alpha + 2. * ps.z * phi[im]) * lap_psi -
+                             2.0 * ps.z * (dphi_dx * dpsi_dx + dphi_dy * dpsi_dy + dphi_dz * dpsi_dz) +
+                             ps.w * A_XI * grad_phi_norm + ps.w_wall * A_XI * grad_phi_wall_norm +
+                             2. * ps.d * (psi_all[im] - ps.neutral) * phi_p[im] +
+                             2. * ps.d * (psi_all[im] - ps.neutral_wall[im]) * phi_wall_prime[im];
+                }
             }
         }
     }
 }
 
-void Calc_flux(double **flux, double **u, double *psi_all, double *cp) {
-    if (SW_WALL != NO_WALL) {
-        Calc_cp_wall(phi, phi_p, phi_wall_prime, psi_all, cp);
+// surface normal n and mobility projection I - n n of the psi_dry model at one grid point, as stored by Calc_coef
+static inline void Coef_at(const double *phi_p, const Stencil_point &sp, double n[DIM], double c[DIM][DIM]) {
+    const int im        = sp.im;
+    double    dphi_p_dx = calc_gradient_o1_to_o1(phi_p, sp, 0);
+    double    dphi_p_dy = calc_gradient_o1_to_o1(phi_p, sp, 1);
+    double    dphi_p_dz = calc_gradient_o1_to_o1(phi_p, sp, 2);
+    double    grad_phi_norm =
+        dphi_p_dx * dphi_p_dx + dphi_p_dy * dphi_p_dy +
+        (dphi_p_dz + grad_phi_wall_prime[im]) * (dphi_p_dz + grad_phi_wall_prime[im]);
+    double grad_phi_norm_sqrt = sqrt(grad_phi_norm);
+    if (grad_phi_norm_sqrt != 0.) {
+        n[0] = -dphi_p_dx / grad_phi_norm_sqrt;
+        n[1] = -dphi_p_dy / grad_phi_norm_sqrt;
+        n[2] = -(dphi_p_dz + grad_phi_wall_prime[im]) / grad_phi_norm_sqrt;
     } else {
-        Calc_cp(phi, psi_all, cp);
+        n[0] = n[1] = n[2] = 0.;
     }
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
+    for (int d1 = 0; d1 < DIM; d1++) {
+        for (int d2 = 0; d2 < DIM; d2++) {
+            c[d1][d2] = ((d1 == d2) ? 1. : 0.) - n[d1] * n[d2];
+        }
+    }
+}
 
-                double dcp_dx = calc_gradient_o1_to_o1(cp, im, 0);
-                double dcp_dy = calc_gradient_o1_to_o1(cp, im, 1);
-                double dcp_dz = calc_gradient_o1_to_o1(cp, im, 2);
-
-                if (ps.psi_dry != 0.0) {
-                    flux[0][im] = psi_all[im] * u[0][im] -
-                                  ps.kappa * (1. - phi_wall[im]) *
-                                      (coef[0][0][im] * dcp_dx + coef[0][1][im] * dcp_dy + coef[0][2][im] * dcp_dz);
-                    flux[1][im] = psi_all[im] * u[1][im] -
-                                  ps.kappa * (1. - phi_wall[im]) *
-                                      (coef[1][0][im] * dcp_dx + coef[1][1][im] * dcp_dy + coef[1][2][im] * dcp_dz);
-                    flux[2][im] = psi_all[im] * u[2][im] -
-                                  ps.kappa * (1. - phi_wall[im]) *
-                                      (coef[2][0][im] * dcp_dx + coef[2][1][im] * dcp_dy + coef[2][2][im] * dcp_dz);
-                } else {
-                    flux[0][im] = psi_all[im] * u[0][im] - ps.kappa * calc_gradient_o1_to_o1(cp, im, 0);
-                    flux[1][im] = psi_all[im] * u[1][im] - ps.kappa * calc_gradient_o1_to_o1(cp, im, 1);
-                    flux[2][im] = psi_all[im] * u[2][im] - ps.kappa * calc_gradient_o1_to_o1(cp, im, 2);
-                }
+// mobility tensor at one grid point: taken from the stored fields when coef is given, evaluated otherwise
+static inline void Coef_get(double ***coef, const Stencil_point &sp, double c[DIM][DIM]) {
+    if (coef != NULL) {
+        for (int d1 = 0; d1 < DIM; d1++) {
+            for (int d2 = 0; d2 < DIM; d2++) {
+                c[d1][d2] = coef[d1][d2][sp.im];
             }
         }
+    } else {
+        double n[DIM];
+        Coef_at(phi_p, sp, n, c);
     }
 }
 
-void        Calc_coef(double ***coef, double *phi_p, double *phi_wall_prime) {
-#pragma omp parallel for
-    for (int d = 0; d < DIM; d++) {
+void Calc_flux(double **flux, double **u, double *psi_all, double *cp, double ***coef) {
+    if (SW_WALL != NO_WALL) {
+        Calc_cp_wall(phi, phi_p, phi_wall_prime, psi_all, cp);
+    } else {
+        Calc_cp(phi, psi_all, cp);
+    }
+    const bool dry = (ps.psi_dry != 0.0);
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
         for (int i = 0; i < NX; i++) {
-            for (int j = 0; j < NY; j++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
                 for (int k = 0; k < NZ; k++) {
-                    int    im        = (i * NY * NZ_) + (j * NZ_) + k;
-                    double dphi_p_dx = calc_gradient_o1_to_o1(phi_p, im, 0);
-                    double dphi_p_dy = calc_gradient_o1_to_o1(phi_p, im, 1);
-                    double dphi_p_dz = calc_gradient_o1_to_o1(phi_p, im, 2);
-                    double grad_phi_norm =
-                        dphi_p_dx * dphi_p_dx + dphi_p_dy * dphi_p_dy +
-                        (dphi_p_dz + grad_phi_wall_prime[im]) * (dphi_p_dz + grad_phi_wall_prime[im]);
-                    double grad_phi_norm_sqrt = sqrt(grad_phi_norm);
-                    if (grad_phi_norm_sqrt != 0.) {
-                        if (d == 2) {
-                            ns[d][im] = -(dphi_p_dz + grad_phi_wall_prime[im]) / grad_phi_norm_sqrt;
-                        } else {
-                            ns[d][im] = -calc_gradient_o1_to_o1(phi_p, im, d) / grad_phi_norm_sqrt;
-                        }
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double dcp_dx = calc_gradient_o1_to_o1(cp, sp, 0);
+                    double dcp_dy = calc_gradient_o1_to_o1(cp, sp, 1);
+                    double dcp_dz = calc_gradient_o1_to_o1(cp, sp, 2);
+
+                    if (dry) {
+                        double c[DIM][DIM];
+                        Coef_get(coef, sp, c);
+                        double mob = ps.kappa * (1. - phi_wall[im]);
+                        flux[0][im] =
+                            psi_all[im] * u[0][im] - mob * (c[0][0] * dcp_dx + c[0][1] * dcp_dy + c[0][2] * dcp_dz);
+                        flux[1][im] =
+                            psi_all[im] * u[1][im] - mob * (c[1][0] * dcp_dx + c[1][1] * dcp_dy + c[1][2] * dcp_dz);
+                        flux[2][im] =
+                            psi_all[im] * u[2][im] - mob * (c[2][0] * dcp_dx + c[2][1] * dcp_dy + c[2][2] * dcp_dz);
                     } else {
-                        ns[d][im] = 0.;
+                        flux[0][im] = psi_all[im] * u[0][im] - ps.kappa * dcp_dx;
+                        flux[1][im] = psi_all[im] * u[1][im] - ps.kappa * dcp_dy;
+                        flux[2][im] = psi_all[im] * u[2][im] - ps.kappa * dcp_dz;
                     }
                 }
             }
         }
     }
+}
 
-#pragma omp parallel for
-    for (int d1 = 0; d1 < DIM; d1++) {  // make unit tensor for 3D
-        for (int d2 = 0; d2 < DIM; d2++) {
-            if (d1 == d2) {
-                I[d1][d2] = 1.;
-            } else {
-                I[d1][d2] = 0.;
-            }
-        }
-    }
-
-#pragma omp parallel for
-    for (int d1 = 0; d1 < DIM; d1++) {
-        for (int d2 = 0; d2 < DIM; d2++) {
-            for (int i = 0; i < NX; i++) {
-                for (int j = 0; j < NY; j++) {
-                    for (int k = 0; k < NZ; k++) {
-                        int im           = (i * NY * NZ_) + (j * NZ_) + k;
-                        coef[d1][d2][im] = I[d1][d2] - ns[d1][im] * ns[d2][im];
+void        Calc_coef(double ***coef, double *phi_p, double *phi_wall_prime) {
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    double        n[DIM], c[DIM][DIM];
+                    Coef_at(phi_p, sp, n, c);
+                    for (int d1 = 0; d1 < DIM; d1++) {
+                        ns[d1][sp.im] = n[d1];
+                        for (int d2 = 0; d2 < DIM; d2++) {
+                            coef[d1][d2][sp.im] = c[d1][d2];
+                        }
                     }
                 }
             }
@@ -160,71 +231,86 @@ void        Calc_coef(double ***coef, double *phi_p, double *phi_wall_prime) {
 }
 
 void        Calc_cp_OBL(double *phi, double *psi, double *cp, const double degree_oblique) {
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
 
-                double lap_psi = calc_laplacian_OBL(psi, im, degree_oblique);
+                    double lap_psi = calc_laplacian_OBL(psi, sp, degree_oblique);
 
-                double dphi_dx_co = calc_gradient_o1_to_o1(phi, im, 0);
-                double dphi_dy_co = calc_gradient_o1_to_o1(phi, im, 1);
-                double dphi_dz_co = calc_gradient_o1_to_o1(phi, im, 2);
+                    double dphi_dx_co = calc_gradient_o1_to_o1(phi, sp, 0);
+                    double dphi_dy_co = calc_gradient_o1_to_o1(phi, sp, 1);
+                    double dphi_dz_co = calc_gradient_o1_to_o1(phi, sp, 2);
 
-                double dphi_dx = calc_gradient_o1_to_o1(phi, im, 0);
-                double dphi_dy = calc_gradient_o1_to_o1(phi, im, 1);
-                double dphi_dz = calc_gradient_o1_to_o1(phi, im, 2);
+                    double dphi_dx = calc_gradient_o1_to_o1(phi, sp, 0);
+                    double dphi_dy = calc_gradient_o1_to_o1(phi, sp, 1);
+                    double dphi_dz = calc_gradient_o1_to_o1(phi, sp, 2);
 
-                double dpsi_dx = calc_gradient_o1_to_o1(psi, im, 0);
-                double dpsi_dy = calc_gradient_o1_to_o1(psi, im, 1);
-                double dpsi_dz = calc_gradient_o1_to_o1(psi, im, 2);
+                    double dpsi_dx = calc_gradient_o1_to_o1(psi, sp, 0);
+                    double dpsi_dy = calc_gradient_o1_to_o1(psi, sp, 1);
+                    double dpsi_dz = calc_gradient_o1_to_o1(psi, sp, 2);
 
-                double dphi_dx_contra =
-                    ((1. + degree_oblique * degree_oblique) * dphi_dx_co) - (degree_oblique * dphi_dy_co);
-                double dphi_dy_contra = -(degree_oblique * dphi_dx_co) + dphi_dy_co;
-                double dphi_dz_contra = dphi_dz_co;
+                    double dphi_dx_contra =
+                        ((1. + degree_oblique * degree_oblique) * dphi_dx_co) - (degree_oblique * dphi_dy_co);
+                    double dphi_dy_contra = -(degree_oblique * dphi_dx_co) + dphi_dy_co;
+                    double dphi_dz_contra = dphi_dz_co;
 
-                double grad_phi_norm =
-                    dphi_dx_co * dphi_dx_contra + dphi_dy_co * dphi_dy_contra + dphi_dz_co * dphi_dz_contra;
+                    double grad_phi_norm =
+                        dphi_dx_co * dphi_dx_contra + dphi_dy_co * dphi_dy_contra + dphi_dz_co * dphi_dz_contra;
 
-                cp[im] = potential_deriv(psi[im]) - (ps.alpha + 2. * ps.z * phi[im]) * lap_psi -
-                         2. * ps.z * (dphi_dx * dpsi_dx + dphi_dy * dpsi_dy + dphi_dz * dpsi_dz) +
-                         ps.w * A_XI * grad_phi_norm + 2. * ps.d * (psi[im] - ps.neutral) * phi[im];
+                    cp[im] = potential_deriv(psi[im]) - (ps.alpha + 2. * ps.z * phi[im]) * lap_psi -
+                             2. * ps.z * (dphi_dx * dpsi_dx + dphi_dy * dpsi_dy + dphi_dz * dpsi_dz) +
+                             ps.w * A_XI * grad_phi_norm + 2. * ps.d * (psi[im] - ps.neutral) * phi[im];
+                }
             }
         }
     }
 }
 
 void        Cp2stress(double *cp, double *psi, double **stress) {
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im        = (i * NY * NZ_) + (j * NZ_) + k;
-                stress[0][im] = psi[im] * calc_gradient_o1_to_o1(cp, im, 0) * IRHO;
-                stress[1][im] = psi[im] * calc_gradient_o1_to_o1(cp, im, 1) * IRHO;
-                stress[2][im] = psi[im] * calc_gradient_o1_to_o1(cp, im, 2) * IRHO;
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    stress[0][im] = psi[im] * calc_gradient_o1_to_o1(cp, sp, 0) * IRHO;
+                    stress[1][im] = psi[im] * calc_gradient_o1_to_o1(cp, sp, 1) * IRHO;
+                    stress[2][im] = psi[im] * calc_gradient_o1_to_o1(cp, sp, 2) * IRHO;
+                }
             }
         }
     }
 }
 
 void        Cp2stress_OBL(double *cp, double *psi, double **stress, const double degree_oblique) {
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int    im        = (i * NY * NZ_) + (j * NZ_) + k;
-                double dcp_dx_co = calc_gradient_o1_to_o1(cp, im, 0);
-                double dcp_dy_co = calc_gradient_o1_to_o1(cp, im, 1);
-                double dcp_dz_co = calc_gradient_o1_to_o1(cp, im, 2);
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double dcp_dx_co = calc_gradient_o1_to_o1(cp, sp, 0);
+                    double dcp_dy_co = calc_gradient_o1_to_o1(cp, sp, 1);
+                    double dcp_dz_co = calc_gradient_o1_to_o1(cp, sp, 2);
 
-                double dmy = psi[im] / RHO;
+                    double dmy = psi[im] / RHO;
 
-                stress[0][im] = dmy * ((1. + degree_oblique * degree_oblique) * dcp_dx_co - degree_oblique * dcp_dy_co);
-                stress[1][im] = dmy * (-degree_oblique * dcp_dx_co + dcp_dy_co);
-                stress[2][im] = dmy * dcp_dz_co;
+                    stress[0][im] =
+                        dmy * ((1. + degree_oblique * degree_oblique) * dcp_dx_co - degree_oblique * dcp_dy_co);
+                    stress[1][im] = dmy * (-degree_oblique * dcp_dx_co + dcp_dy_co);
+                    stress[2][im] = dmy * dcp_dz_co;
+                }
             }
         }
     }
@@ -253,38 +339,44 @@ void        Set_poisson_rhs_viscosity(double **u,
                                       double * eta_s,
                                       double * s,
                                       CTime &  jikan) {
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
-                for (int d = 0; d < DIM; d++) {
-                    double nu = eta_s[im] * IRHO;
-                    double vt = 0.;
-                    switch (d) {
-                        case 0:
-                            vt = 2. * calc_gradient_o1_to_o1(eta_s, im, 0) * calc_gradient_o1_to_o1(u_s[0], im, 0) +
-                                 calc_gradient_o1_to_o1(eta_s, im, 1) *
-                                     (calc_gradient_o1_to_o1(u_s[0], im, 1) + calc_gradient_o1_to_o1(u_s[1], im, 0)) +
-                                 calc_gradient_o1_to_o1(eta_s, im, 2) *
-                                     (calc_gradient_o1_to_o1(u_s[0], im, 2) + calc_gradient_o1_to_o1(u_s[2], im, 0));
-                            break;
-                        case 1:
-                            vt = 2. * calc_gradient_o1_to_o1(eta_s, im, 1) * calc_gradient_o1_to_o1(u_s[1], im, 1) +
-                                 calc_gradient_o1_to_o1(eta_s, im, 0) *
-                                     (calc_gradient_o1_to_o1(u_s[0], im, 1) + calc_gradient_o1_to_o1(u_s[1], im, 0)) +
-                                 calc_gradient_o1_to_o1(eta_s, im, 2) *
-                                     (calc_gradient_o1_to_o1(u_s[1], im, 2) + calc_gradient_o1_to_o1(u_s[2], im, 1));
-                            break;
-                        case 2:
-                            vt = 2. * calc_gradient_o1_to_o1(eta_s, im, 2) * calc_gradient_o1_to_o1(u_s[2], im, 2) +
-                                 calc_gradient_o1_to_o1(eta_s, im, 0) *
-                                     (calc_gradient_o1_to_o1(u_s[0], im, 2) + calc_gradient_o1_to_o1(u_s[2], im, 0)) +
-                                 calc_gradient_o1_to_o1(eta_s, im, 1) *
-                                     (calc_gradient_o1_to_o1(u_s[1], im, 2) + calc_gradient_o1_to_o1(u_s[2], im, 1));
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double nu    = eta_s[im] * IRHO;
+                    double eta_x = calc_gradient_o1_to_o1(eta_s, sp, 0);
+                    double eta_y = calc_gradient_o1_to_o1(eta_s, sp, 1);
+                    double eta_z = calc_gradient_o1_to_o1(eta_s, sp, 2);
+                    double u_xx  = calc_gradient_o1_to_o1(u_s[0], sp, 0);
+                    double u_xy  = calc_gradient_o1_to_o1(u_s[0], sp, 1);
+                    double u_xz  = calc_gradient_o1_to_o1(u_s[0], sp, 2);
+                    double u_yx  = calc_gradient_o1_to_o1(u_s[1], sp, 0);
+                    double u_yy  = calc_gradient_o1_to_o1(u_s[1], sp, 1);
+                    double u_yz  = calc_gradient_o1_to_o1(u_s[1], sp, 2);
+                    double u_zx  = calc_gradient_o1_to_o1(u_s[2], sp, 0);
+                    double u_zy  = calc_gradient_o1_to_o1(u_s[2], sp, 1);
+                    double u_zz  = calc_gradient_o1_to_o1(u_s[2], sp, 2);
+
+                    for (int d = 0; d < DIM; d++) {
+                        double vt = 0.;
+                        switch (d) {
+                            case 0:
+                                vt = 2. * eta_x * u_xx + eta_y * (u_xy + u_yx) + eta_z * (u_xz + u_zx);
+                                break;
+                            case 1:
+                                vt = 2. * eta_y * u_yy + eta_x * (u_xy + u_yx) + eta_z * (u_yz + u_zy);
+                                break;
+                            case 2:
+                                vt = 2. * eta_z * u_zz + eta_x * (u_xz + u_zx) + eta_y * (u_yz + u_zy);
+                        }
+                        vt *= IRHO;
+                        w_v3_3[d][im] = adv[d][im] - nu * lap[d][im] - vt + stress[d][im];
                     }
-                    vt *= IRHO;
-                    w_v3_3[d][im] = adv[d][im] - nu * lap[d][im] - vt + stress[d][im];
                 }
             }
         }
@@ -308,47 +400,52 @@ void Set_poisson_rhs_viscosity_OBL(double **u,
     const double g22 = 1.;
     const double g33 = 1.;
 
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int    im = (i * NY * NZ_) + (j * NZ_) + k;
-                double nu = eta_s[im] * IRHO;
-
-                double eta_x = calc_gradient_o1_to_o1(eta_s, im, 0);
-                double eta_y = calc_gradient_o1_to_o1(eta_s, im, 1);
-                double eta_z = calc_gradient_o1_to_o1(eta_s, im, 2);
-                double u_xx  = calc_gradient_o1_to_o1(u[0], im, 0);
-                double u_xy  = calc_gradient_o1_to_o1(u[0], im, 1);
-                double u_xz  = calc_gradient_o1_to_o1(u[0], im, 2);
-                double u_yx  = calc_gradient_o1_to_o1(u[1], im, 0);
-                double u_yy  = calc_gradient_o1_to_o1(u[1], im, 1);
-                double u_yz  = calc_gradient_o1_to_o1(u[1], im, 2);
-                double u_zx  = calc_gradient_o1_to_o1(u[2], im, 0);
-                double u_zy  = calc_gradient_o1_to_o1(u[2], im, 1);
-                double u_zz  = calc_gradient_o1_to_o1(u[2], im, 2);
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
 
-                for (int d = 0; d < DIM; d++) {
-                    double vt = 0.;
-
-                    switch (d) {
-                        case 0:
-                            vt = (2. * g11 * eta_x + g21 * eta_y) * u_xx + g11 * eta_y * u_yx + g11 * eta_z * u_zx +
-                                 (2. * g12 * eta_x + g22 * eta_y) * u_xy + g12 * eta_y * u_yy + g12 * eta_z * u_zy +
-                                 g33 * eta_z * u_xz;
-                            break;
-                        case 1:
-                            vt = g21 * eta_x * u_xx + (g11 * eta_x + 2. * g21 * eta_y) * u_yx + g21 * eta_z * u_zx +
-                                 g22 * eta_x * u_xy + (g12 * eta_x + 2. * g22 * eta_y) * u_yy + g22 * eta_z * u_zy +
-                                 g33 * eta_z * u_yz;
-                            break;
-                        case 2:
-                            vt = (g11 * eta_x + g21 * eta_y) * u_zx + (g12 * eta_x + g22 * eta_y) * u_zy +
-                                 g33 * eta_x * u_xz + g33 * eta_y * u_yz + 2. * g33 * eta_z * u_zz;
-                            break;
+                    double nu = eta_s[im] * IRHO;
+
+                    double eta_x = calc_gradient_o1_to_o1(eta_s, sp, 0);
+                    double eta_y = calc_gradient_o1_to_o1(eta_s, sp, 1);
+                    double eta_z = calc_gradient_o1_to_o1(eta_s, sp, 2);
+                    double u_xx  = calc_gradient_o1_to_o1(u[0], sp, 0);
+                    double u_xy  = calc_gradient_o1_to_o1(u[0], sp, 1);
+                    double u_xz  = calc_gradient_o1_to_o1(u[0], sp, 2);
+                    double u_yx  = calc_gradient_o1_to_o1(u[1], sp, 0);
+                    double u_yy  = calc_gradient_o1_to_o1(u[1], sp, 1);
+                    double u_yz  = calc_gradient_o1_to_o1(u[1], sp, 2);
+                    double u_zx  = calc_gradient_o1_to_o1(u[2], sp, 0);
+                    double u_zy  = calc_gradient_o1_to_o1(u[2], sp, 1);
+                    double u_zz  = calc_gradient_o1_to_o1(u[2], sp, 2);
+
+                    for (int d = 0; d < DIM; d++) {
+                        double vt = 0.;
+
+                        switch (d) {
+                            case 0:
+                                vt = (2. * g11 * eta_x + g21 * eta_y) * u_xx + g11 * eta_y * u_yx + g11 * eta_z * u_zx +
+                                     (2. * g12 * eta_x + g22 * eta_y) * u_xy + g12 * eta_y * u_yy + g12 * eta_z * u_zy +
+                                     g33 * eta_z * u_xz;
+                                break;
+                            case 1:
+                                vt = g21 * eta_x * u_xx + (g11 * eta_x + 2. * g21 * eta_y) * u_yx + g21 * eta_z * u_zx +
+                                     g22 * eta_x * u_xy + (g12 * eta_x + 2. * g22 * eta_y) * u_yy + g22 * eta_z * u_zy +
+                                     g33 * eta_z * u_yz;
+                                break;
+                            case 2:
+                                vt = (g11 * eta_x + g21 * eta_y) * u_zx + (g12 * eta_x + g22 * eta_y) * u_zy +
+                                     g33 * eta_x * u_xz + g33 * eta_y * u_yz + 2. * g33 * eta_z * u_zz;
+                                break;
+                        }
+                        vt *= IRHO;
+                        w_v3_3[d][im] = adv[d][im] - nu * lap[d][im] - vt + stress[d][im];
                     }
-                    vt *= IRHO;
-                    w_v3_3[d][im] = adv[d][im] - nu * lap[d][im] - vt + stress[d][im];
                 }
             }
         }
@@ -389,93 +486,214 @@ void Update_psi_euler(double *  psi_all,
                       double *  cp,
                       double ***coef,
                       CTime &   jikan) {
-    double  INV_2DX = 1. / (2. * DX);
-    double *coef_dmu_dx, *coef_dmu_dy, *coef_dmu_dz;
+    const bool dry      = (ps.psi_dry != 0.0);
+    double **  coef_dmu = w_v3_2;  // (I - n n) grad cp, only with psi_dry
 
-    coef_dmu_dx = alloc_1d_double(NX * NY * NZ_);
-    coef_dmu_dy = alloc_1d_double(NX * NY * NZ_);
-    coef_dmu_dz = alloc_1d_double(NX * NY * NZ_);
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    w_v3_3[0][im] = psi_all[im] * u[0][im];
+                    w_v3_3[1][im] = psi_all[im] * u[1][im];
+                    w_v3_3[2][im] = psi_all[im] * u[2][im];
+
+                    if (dry) {
+                        double dcp_dx = calc_gradient_o1_to_o1(cp, sp, 0);
+                        double dcp_dy = calc_gradient_o1_to_o1(cp, sp, 1);
+                        double dcp_dz = calc_gradient_o1_to_o1(cp, sp, 2);
+
+                        double c[DIM][DIM];
+                        Coef_get(coef, sp, c);
+                        coef_dmu[0][im] = c[0][0] * dcp_dx + c[0][1] * dcp_dy + c[0][2] * dcp_dz;
+                        coef_dmu[1][im] = c[1][0] * dcp_dx + c[1][1] * dcp_dy + c[1][2] * dcp_dz;
+                        coef_dmu[2][im] = c[2][0] * dcp_dx + c[2][1] * dcp_dy + c[2][2] * dcp_dz;
+                    }
+                }
+            }
+        }
+    }
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double advective_term = calc_gradient_o1_to_o1(w_v3_3[0], sp, 0) +
+                                            calc_gradient_o1_to_o1(w_v3_3[1], sp, 1) +
+                                            calc_gradient_o1_to_o1(w_v3_3[2], sp, 2);
+
+                    if (dry) {
+                        double grad_term = ps.kappa * (1. - phi_wall[im]) *
+                                           (calc_gradient_o1_to_o1(coef_dmu[0], sp, 0) +
+                                            calc_gradient_o1_to_o1(coef_dmu[1], sp, 1) +
+                                            calc_gradient_o1_to_o1(coef_dmu[2], sp, 2));
+                        psi_all[im] += jikan.dt_fluid * (-advective_term + grad_term);
+                        psi[im] = psi_all[im] - ps.neutral * phi_p[im] - ps.neutral_wall[im] * phi_wall_prime[im] -
+                                  ps.psi_dry * phi_wall_double_prime[im];
+                    } else {
+                        double lap_term = ps.kappa * calc_laplacian(cp, sp);
+                        psi_all[im] += jikan.dt_fluid * (-advective_term + lap_term);
+                        psi[im] = psi_all[im] - ps.neutral * phi_p[im] - ps.neutral_wall[im] * phi_wall_prime[im];
+                    }
+                }
+            }
+        }
+    }
+}
 
+void        Update_psi_euler_OBL(double *psi, double **u, double *cp, CTime &jikan, const double degree_oblique) {
 #pragma omp parallel for
     for (int i = 0; i < NX; i++) {
         for (int j = 0; j < NY; j++) {
             for (int k = 0; k < NZ; k++) {
                 for (int d = 0; d < DIM; d++) {
-                    int im = (i * NY * NZ_) + (j * NZ_) + k;
-
-                    double dcp_dx = calc_gradient_o1_to_o1(cp, im, 0);
-                    double dcp_dy = calc_gradient_o1_to_o1(cp, im, 1);
-                    double dcp_dz = calc_gradient_o1_to_o1(cp, im, 2);
-
-                    coef_dmu_dx[im] = coef[0][0][im] * dcp_dx + coef[0][1][im] * dcp_dy + coef[0][2][im] * dcp_dz;
-                    coef_dmu_dy[im] = coef[1][0][im] * dcp_dx + coef[1][1][im] * dcp_dy + coef[1][2][im] * dcp_dz;
-                    coef_dmu_dz[im] = coef[2][0][im] * dcp_dx + coef[2][1][im] * dcp_dy + coef[2][2][im] * dcp_dz;
-                    w_v3_3[d][im]   = psi_all[im] * u[d][im];
+                    int im        = (i * NY * NZ_) + (j * NZ_) + k;
+                    w_v3_3[d][im] = psi[im] * u[d][im];
                 }
             }
         }
     }
-#pragma omp parallel for
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = (i * NY * NZ_) + (j * NZ_) + k;
-                int ip1, im1, jp1, jm1, kp1, km1;
-                ip1 = adj(1, i, NX);
-                jp1 = adj(1, j, NY);
-                kp1 = adj(1, k, NZ);
-                im1 = adj(-1, i, NX);
-                jm1 = adj(-1, j, NY);
-                km1 = adj(-1, k, NZ);
-
-                double advective_term = calc_gradient_o1_to_o1(w_v3_3[0], im, 0) +
-                                        calc_gradient_o1_to_o1(w_v3_3[1], im, 1) +
-                                        calc_gradient_o1_to_o1(w_v3_3[2], im, 2);
-                double lap_term = ps.kappa * calc_laplacian(cp, im);
-                double grad_term =
-                    ps.kappa * (1. - phi_wall[im]) *
-                    (calc_gradient_o1_to_o1(coef_dmu_dx, im, 0) + calc_gradient_o1_to_o1(coef_dmu_dy, im, 1) +
-                     calc_gradient_o1_to_o1(coef_dmu_dz, im, 2));
-
-                if (ps.psi_dry != 0.0) {
-                    psi_all[im] += jikan.dt_fluid * (-advective_term + grad_term);
-                    psi[im] = psi_all[im] - ps.neutral * phi_p[im] - ps.neutral_wall[im] * phi_wall_prime[im] -
-                              ps.psi_dry * phi_wall_double_prime[im];
-                } else {
-                    psi_all[im] += jikan.dt_fluid * (-advective_term + lap_term);
-                    psi[im] = psi_all[im] - ps.neutral * phi_p[im] - ps.neutral_wall[im] * phi_wall_prime[im];
+
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double lap_term       = ps.kappa * calc_laplacian_OBL(cp, sp, degree_oblique);
+                    double advective_term = calc_gradient_o1_to_o1(w_v3_3[0], sp, 0) +
+                                            calc_gradient_o1_to_o1(w_v3_3[1], sp, 1) +
+                                            calc_gradient_o1_to_o1(w_v3_3[2], sp, 2);
+                    psi[im] += jikan.dt_fluid * (-advective_term + lap_term);
                 }
             }
         }
     }
 }
 
-void        Update_psi_euler_OBL(double *psi, double **u, double *cp, CTime &jikan, const double degree_oblique) {
-#pragma omp parallel for
+static double *lap_k;     // eigenvalues of -(7-point Laplacian) at each Fourier mode
+static double *rhs_ch;    // explicit increment, solved in place in Fourier space
+static double *rhs_ch_o;  // explicit increment of the previous step (SBDF2)
+static int     rhs_ch_set;
+
+void CH_solver_spectral(double *     psi,
+                        double *     psi_all,
+                        double *     psi_o,
+                        double *     psi_all_o,
+                        double *     phi,
+                        double *     phi_p,
+                        double **    u,
+                        const CTime &jikan) {
+    const int    sbdf2   = (jikan.ts >= 2 && rhs_ch_set);
+    const double INV_DT  = 1. / jikan.dt_fluid;
+    double       f2_max  = 0.;
+    double       phi_max = 0.;
+
+    Calc_cp(phi, psi_all, cp);
+#pragma omp parallel for reduction(max : f2_max, phi_max)
     for (int i = 0; i < NX; i++) {
         for (int j = 0; j < NY; j++) {
             for (int k = 0; k < NZ; k++) {
+                int im = (i * NY * NZ_) + (j * NZ_) + k;
                 for (int d = 0; d < DIM; d++) {
-                    int im        = (i * NY * NZ_) + (j * NZ_) + k;
-                    w_v3_3[d][im] = psi[im] * u[d][im];
+                    w_v3_3[d][im] = psi_all[im] * u[d][im];
+                }
+                f2_max  = MAX(f2_max, fabs(potential_deriv2(psi_all[im])) + 2. * fabs(ps.d) * phi[im]);
+                phi_max = MAX(phi_max, phi[im]);
+            }
+        }
+    }
+
+    // explicit increment r = kappa lap(mu) - div(psi u); SBDF2 solves for psi^{n+1} - (2 psi^n - psi^{n-1})
+#pragma omp parallel for collapse(2)
+    for (int jb = 0; jb < NY; jb += STENCIL_TILE_J) {
+        for (int i = 0; i < NX; i++) {
+            const int je = stencil_tile_end(jb);
+            for (int j = jb; j < je; j++) {
+                for (int k = 0; k < NZ; k++) {
+                    Stencil_point sp = stencil_point(i, j, k);
+                    int           im = sp.im;
+
+                    double advective_term = calc_gradient_o1_to_o1(w_v3_3[0], sp, 0) +
+                                            calc_gradient_o1_to_o1(w_v3_3[1], sp, 1) +
+                                            calc_gradient_o1_to_o1(w_v3_3[2], sp, 2);
+                    double r = ps.kappa * calc_laplacian(cp, sp) - advective_term;
+                    if (sbdf2) {
+                        rhs_ch[im] = (psi_all_o[im] - psi_all[im]) * INV_DT + 2. * r - rhs_ch_o[im];
+                    } else {
+                        rhs_ch[im] = r;
+                    }
+                    rhs_ch_o[im] = r;
                 }
             }
         }
     }
 
+    // implicit part kappa lap(-A lap + S): A bounds the z term, S = max|f''|/2 the local potential curvature
+    const double c0 = (sbdf2) ? 1.5 * INV_DT : INV_DT;
+    const double A  = ps.alpha + 2. * fabs(ps.z) * phi_max;
+    const double S  = 0.5 * f2_max;
+    A2a_k(rhs_ch);
+#pragma omp parallel for
+    for (int im = 0; im < NX * NY * NZ_; im++) {
+        rhs_ch[im] /= c0 + ps.kappa * lap_k[im] * (A * lap_k[im] + S);
+    }
+    A_k2a(rhs_ch);
+
+    Cpy_v1(psi_o, psi);
 #pragma omp parallel for
     for (int i = 0; i < NX; i++) {
         for (int j = 0; j < NY; j++) {
             for (int k = 0; k < NZ; k++) {
-                int    im             = (i * NY * NZ_) + (j * NZ_) + k;
-                double lap_term       = ps.kappa * calc_laplacian_OBL(cp, im, degree_oblique);
-                double advective_term = calc_gradient_o1_to_o1(w_v3_3[0], im, 0) +
-                                        calc_gradient_o1_to_o1(w_v3_3[1], im, 1) +
-                                        calc_gradient_o1_to_o1(w_v3_3[2], im, 2);
-                psi[im] += jikan.dt_fluid * (-advective_term + lap_term);
+                int    im   = (i * NY * NZ_) + (j * NZ_) + k;
+                double base = (sbdf2) ? 2. * psi_all[im] - psi_all_o[im] : psi_all[im];
+                psi_all[im] = base + rhs_ch[im];
+                psi[im]     = psi_all[im] - ps.psi_0_p * phi_p[im] - ps.psi_0_wall[im] * phi_wall_prime[im];
             }
         }
     }
+    rhs_ch_set = 1;
+}
+
+void Init_ch_spectral(void) {
+    if (!spectral_ch) return;
+    if (SW_EQ != Navier_Stokes_Cahn_Hilliard_FDM || SW_WALL != NO_WALL || ps.psi_dry != 0.0) {
+        spectral_ch = 0;
+        fprintf(stderr, "# CH spectral solve: needs constant mobility without walls, BiCGSTAB is used\n");
+        return;
+    }
+    lap_k      = alloc_1d_double(NX * NY * NZ_);
+    rhs_ch     = alloc_1d_double(NX * NY * NZ_);
+    rhs_ch_o   = alloc_1d_double(NX * NY * NZ_);
+    rhs_ch_set = 0;
+
+    const double INV_DX2 = 1. / (DX * DX);
+#pragma omp parallel for
+    for (int im = 0; im < NX * NY * NZ_; im++) {
+        double sx = sin(0.5 * WAVE_X * KX_int[im] * DX);
+        double sy = sin(0.5 * WAVE_Y * KY_int[im] * DX);
+        double sz = sin(0.5 * WAVE_Z * KZ_int[im] * DX);
+        lap_k[im] = 4. * INV_DX2 * (sx * sx + sy * sy + sz * sz);
+    }
+    fprintf(stderr, "# CH spectral solve: ON (stabilised semi-implicit, Euler then SBDF2)\n");
+}
+
+void Free_ch_spectral(void) {
+    if (!spectral_ch) return;
+    free_1d_double(rhs_ch_o);
+    free_1d_double(rhs_ch);
+    free_1d_double(lap_k);
 }
 
 void Init_phase_separation(double *phi, double *psi) {
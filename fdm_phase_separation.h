@@ -30,18 +30,36 @@ inline double potential_deriv(double x) {
         retval = gl.a * (x * x * x) - gl.b * x;
     } else if (SW_POTENTIAL == Flory_Huggins) {
         retval = (1. / fh.na) - (1. / fh.nb) + (log(x) / fh.na) - (log(1. - x) / fh.nb) + fh.chi * (1. - 2. * x);
+    } else {
+        fprintf(stderr, "# unknown free energy potential (SW_POTENTIAL = %d)\n", SW_POTENTIAL);
+        exit_job(EXIT_FAILURE);
+    }
+    return retval;
+}
+inline double potential_deriv2(double x) {
+    double retval;
+    if (SW_POTENTIAL == Landau) {
+        retval = 3. * gl.a * (x * x) - gl.b;
+    } else if (SW_POTENTIAL == Flory_Huggins) {
+        retval = (1. / (fh.na * x)) + (1. / (fh.nb * (1. - x))) - 2. * fh.chi;
+    } else {
+        fprintf(stderr, "# unknown free energy potential (SW_POTENTIAL = %d)\n", SW_POTENTIAL);
+        exit_job(EXIT_FAILURE);
     }
     return retval;
 }
 
 void Calc_cp(double *phi, double *psi, double *cp);
 void Calc_cp_wall(double *phi, double *phi_p, double *phi_wall_prime, double *psi_all, double *cp);
-void Calc_flux(double **flux, double **u, double *psi_all, double *cp);
+// coef: stored mobility tensor (Calc_coef), or NULL to evaluate it on the fly from phi_p
+void Calc_flux(double **flux, double **u, double *psi_all, double *cp, double ***coef);
 void Calc_coef(double ***coef, double *phi_p, double *phi_wall_prime);
 void Calc_cp_OBL(double *phi, double *psi, double *cp, const double degree_oblique);
 
 void Cp2stress(double *cp, double *psi, double **stress);
 void Cp2stress_OBL(double *cp, double *psi, double **stress, const double degree_oblique);
+// Calc_cp followed by Cp2stress, with each cp plane consumed by the stress sweep while still in cache
+void Calc_cp_stress(double *phi, double *psi, double *cp, double **stress);
 
 void Set_poisson_rhs_ps(double **u, double **adv, double **lap, double **stress, double *s, CTime &jikan);
 void Set_poisson_rhs_viscosity(double **u,
@@ -64,6 +82,7 @@ void Set_poisson_rhs_viscosity_OBL(double **u,
 void Update_u_stress_euler(double **u, double **stress, CTime &jikan);
 void Update_u_stress_ab2(double **u, double **stress, double **stress_o, CTime &jikan);
 
+// coef as in Calc_flux; the psi_dry scratch lives in w_v3_2
 void Update_psi_euler(double *  psi_all,
                       double *  psi,
                       double ** u,
@@ -74,6 +93,24 @@ void Update_psi_euler(double *  psi_all,
                       CTime &   jikan);
 void Update_psi_euler_OBL(double *psi, double **u, double *cp, CTime &jikan, const double degree_oblique);
 
+/*!
+  \brief Stabilised semi-implicit Fourier solve of the Cahn-Hilliard equation
+  \details Constant-mobility, wall-free replacement of CH_solver_implicit_euler and CH_solver_implicit_bdfab.
+  The biharmonic term and a stabilisation proportional to max|f''| are implicit and diagonal in Fourier space
+  (modified wavenumbers of the finite-difference Laplacian); the chemical potential and advection are explicit.
+  Euler for the first two steps, then SBDF2.
+ */
+void CH_solver_spectral(double *     psi,
+                        double *     psi_all,
+                        double *     psi_o,
+                        double *     psi_all_o,
+                        double *     phi,
+                        double *     phi_p,
+                        double **    u,
+                        const CTime &jikan);
+void Init_ch_spectral(void);
+void Free_ch_spectral(void);
+
 void Init_phase_separation(double *phi, double *psi);
 
 void Output_xdmf_sca(std::string filename, std::string hdffilename, std::string dataname, CTime &jikan);
@@ -25,8 +25,10 @@ double **I, **ns, ***coef;
 int *    KX_int, *KY_int, *KZ_int;
 double * K2, *IK2;
 
-splineSystem **splineOblique;
-double ***     uspline;
+splineBatch **splineOblique;
+double **     uspline;
+ooura_plan    ooura_oblique;
+double **     uspectral;
 
 Index_range *ijk_range_two_third_filter;
 int          n_ijk_range_two_third_filter;
@@ -37,6 +37,7 @@ extern "C" {
 #endif
 extern void rdft3d(int n1, int n2, int n3, int sign, double ***a, double *t, int *ip, double *w);
 extern void rdft3dsort(int, int, int, int, double ***);
+extern void rdft(int n, int isgn, double *a, int *ip, double *w);
 #ifdef __cplusplus
 }
 #endif
@@ -67,8 +68,10 @@ extern double **work_v3, **work_v2, *work_v1;
 extern int *   KX_int, *KY_int, *KZ_int;
 extern double *K2, *IK2;
 
-extern splineSystem **splineOblique;
-extern double ***     uspline;
+extern splineBatch **splineOblique;
+extern double **     uspline;
+extern ooura_plan    ooura_oblique;
+extern double **     uspectral;
 
 extern Index_range *ijk_range_two_third_filter;
 extern int          n_ijk_range_two_third_filter;
@@ -358,15 +361,41 @@ inline void Init_Transform_obl() {
 #pragma omp parallel
         { nthreads = omp_get_num_threads(); }
 #endif
-        uspline       = (double ***)malloc(sizeof(double **) * nthreads);
-        splineOblique = new splineSystem *[nthreads];
+        // one batch per thread holds all DIM * NZ lines of a y-plane
+        uspline       = (double **)malloc(sizeof(double *) * nthreads);
+        splineOblique = new splineBatch *[nthreads];
 
         for (int np = 0; np < nthreads; np++) {
-            splineInit(splineOblique[np], NX, DX);
-            uspline[np] = (double **)malloc(sizeof(double *) * DIM);
-
-            for (int d = 0; d < DIM; d++) uspline[np][d] = alloc_1d_double(NX);
+            splineBatchInit(splineOblique[np], NX, DIM * NZ, DX);
+            uspline[np] = alloc_1d_double(DIM * NZ);
+        }
+    } else if (SW_OBL_INT == spectral_int) {
+        if (NX < 2 || (NX & (NX - 1)) != 0) {
+            fprintf(stderr, "# spectral OBL/RCT transform requires NX to be a power of 2 (NX = %d)\n", NX);
+            exit_job(EXIT_FAILURE);
         }
+        int nthreads;
+#ifndef _OPENMP
+        nthreads = 1;
+#else
+#pragma omp parallel
+        { nthreads = omp_get_num_threads(); }
+#endif
+        // the cos/sin tables are built by a first transform and are only read afterwards
+        ooura_oblique.ip    = alloc_1d_int(2 + (int)sqrt((double)NX + 0.5));
+        ooura_oblique.w     = alloc_1d_double(NX / 2);
+        ooura_oblique.t     = NULL;
+        ooura_oblique.a     = NULL;
+        ooura_oblique.ip[0] = 0;
+        {
+            double *dmy = calloc_1d_double(NX);
+            rdft(NX, 1, dmy, ooura_oblique.ip, ooura_oblique.w);
+            free_1d_double(dmy);
+        }
+
+        // per thread: the x-lines of a y-plane followed by the phase table
+        uspectral = (double **)malloc(sizeof(double *) * nthreads);
+        for (int np = 0; np < nthreads; np++) uspectral[np] = alloc_1d_double((DIM * NZ + 1) * NX);
     }
 }
 
@@ -380,22 +409,32 @@ inline void Free_Transform_obl() {
         { nthreads = omp_get_num_threads(); }
 #endif
         for (int np = 0; np < nthreads; np++) {
-            for (int d = 0; d < DIM; d++) free_1d_double(uspline[np][d]);
-
-            free(uspline[np]);
-            splineFree(splineOblique[np]);
+            free_1d_double(uspline[np]);
+            splineBatchFree(splineOblique[np]);
         }
         delete[] splineOblique;
         free(uspline);
+    } else if (SW_OBL_INT == spectral_int) {
+        int nthreads;
+#ifndef _OPENMP
+        nthreads = 1;
+#else
+#pragma omp parallel
+        { nthreads = omp_get_num_threads(); }
+#endif
+        for (int np = 0; np < nthreads; np++) free_1d_double(uspectral[np]);
+        free(uspectral);
+        free_1d_double(ooura_oblique.w);
+        free_1d_int(ooura_oblique.ip);
     }
 }
 
 // Periodic spline interpolation
+// All k-lines and components of a y-plane are interpolated together (line l = d * NZ + k), so that the gather, the
+// spline recurrences and the scatter all run over contiguous k rows.
 inline void Spline_u_oblique_transform(double **uu, const OBL_TRANSFORM &flag) {
-    int    im;
-    double dmy_x;
-    double delta_y;
-    double sign;
+    const int m = DIM * NZ;
+    double    sign;
     if (flag == oblique2cartesian) {
         sign = -1.0;
     } else if (flag == cartesian2oblique) {
@@ -404,7 +443,7 @@ inline void Spline_u_oblique_transform(double **uu, const OBL_TRANSFORM &flag) {
         exit_job(EXIT_FAILURE);
     }
 
-#pragma omp parallel for private(im, dmy_x, delta_y)
+#pragma omp parallel for
     for (int j = 0; j < NY; j++) {  // original coord
         int np;
 #ifndef _OPENMP
@@ -412,39 +451,118 @@ inline void Spline_u_oblique_transform(double **uu, const OBL_TRANSFORM &flag) {
 #else
         np = omp_get_thread_num();
 #endif
-        splineSystem *spl = splineOblique[np];
-        double **     us0 = uspline[np];
-
-        delta_y = (double)(j - NY / 2) * DX;
+        splineBatch *spl     = splineOblique[np];
+        double *     us      = uspline[np];
+        double       delta_y = (double)(j - NY / 2) * DX;
+
+        // setup interpolation grid
+        for (int i = 0; i < NX; i++) {  // original coord
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+            double *  a   = spl->a + i * m;
+
+            // velocity components in transformed basis defined over
+            // original grid points x0
+#pragma omp simd
+            for (int k = 0; k < NZ; k++) {
+                a[k]          = uu[0][im0 + k] - sign * degree_oblique * uu[1][im0 + k];
+                a[NZ + k]     = uu[1][im0 + k];
+                a[2 * NZ + k] = uu[2][im0 + k];
+            }
+        }  // i
+
+        // compute interpolated points
+        splineBatchCompute(spl, m);
+        for (int i = 0; i < NX; i++) {  // transformed coord
+            const int    im0   = (i * NY * NZ_) + (j * NZ_);
+            const double dmy_x = fmod(i * DX + sign * degree_oblique * delta_y + 4.0 * LX, LX);  // original coord
+
+            splineBatchFx(spl, m, dmy_x, us);
+            for (int d = 0; d < DIM; d++) {
+#pragma omp simd
+                for (int k = 0; k < NZ; k++) uu[d][im0 + k] = us[d * NZ + k];
+            }
+            if (sign < 0) {
+#pragma omp simd
+                for (int k = 0; k < NZ; k++) uu[0][im0 + k] += Shear_rate_eff * delta_y;
+            }
+        }  // i
+    }      // j
+}
 
-        for (int k = 0; k < NZ; k++) {  // original coord
+// Spectral phase-shift interpolation
+// Each of the m x-lines stored contiguously in buf (NX samples per line) is replaced by the same line shifted to
+// x + shift, i.e. its Fourier modes along x are multiplied by exp(i kx shift). The Nyquist mode keeps its cosine part.
+// phase holds NX doubles of work space.
+inline void Phase_shift_lines(double *buf, const int &m, const double &shift, double *phase) {
+    const double theta = PI2 * shift / LX;
+    const double scale = 2.0 / (double)NX;
+    for (int kx = 1; kx < NX / 2; kx++) {
+        phase[2 * kx]     = cos(theta * kx);
+        phase[2 * kx + 1] = sin(theta * kx);
+    }
+    phase[1] = cos(theta * (NX / 2));
+
+    for (int l = 0; l < m; l++) {
+        double *a = buf + l * NX;
+        rdft(NX, 1, a, ooura_oblique.ip, ooura_oblique.w);
+
+        // rdft stores a[2kx] = Re, a[2kx+1] = -Im of the forward transform
+        a[1] *= phase[1];
+        for (int kx = 1; kx < NX / 2; kx++) {
+            const double re = a[2 * kx];
+            const double im = a[2 * kx + 1];
+            a[2 * kx]       = re * phase[2 * kx] + im * phase[2 * kx + 1];
+            a[2 * kx + 1]   = im * phase[2 * kx] - re * phase[2 * kx + 1];
+        }
 
-            // setup interpolation grid
-            for (int i = 0; i < NX; i++) {  // original coord
-                im    = (i * NY * NZ_) + (j * NZ_) + k;
-                dmy_x = fmod(i * DX - sign * degree_oblique * delta_y + 4.0 * LX, LX);  // transformed coord
+        rdft(NX, -1, a, ooura_oblique.ip, ooura_oblique.w);
+        for (int i = 0; i < NX; i++) a[i] *= scale;
+    }
+}
 
-                // velocity components in transformed basis defined over
-                // original grid points x0
-                us0[0][i] = uu[0][im] - sign * degree_oblique * uu[1][im];
-                us0[1][i] = uu[1][im];
-                us0[2][i] = uu[2][im];
-            }  // i
+inline void Spectral_u_oblique_transform(double **uu, const OBL_TRANSFORM &flag) {
+    const int m = DIM * NZ;
+    double    sign;
+    if (flag == oblique2cartesian) {
+        sign = -1.0;
+    } else if (flag == cartesian2oblique) {
+        sign = 1.0;
+    } else {
+        exit_job(EXIT_FAILURE);
+    }
 
-            // compute interpolated points
-            for (int d = DIM - 1; d >= 0; d--) {
-                splineCompute(spl, us0[d]);
+#pragma omp parallel for
+    for (int j = 0; j < NY; j++) {  // original coord
+        int np;
+#ifndef _OPENMP
+        np = 0;
+#else
+        np = omp_get_thread_num();
+#endif
+        double *buf     = uspectral[np];
+        double  delta_y = (double)(j - NY / 2) * DX;
 
-                for (int i = 0; i < NX; i++) {  // transformed coord
-                    im    = (i * NY * NZ_) + (j * NZ_) + k;
-                    dmy_x = fmod(i * DX + sign * degree_oblique * delta_y + 4.0 * LX, LX);  // original coord
+        // velocity components in transformed basis defined over original grid points x0, line l = d * NZ + k
+        for (int i = 0; i < NX; i++) {  // original coord
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+            for (int k = 0; k < NZ; k++) {
+                buf[k * NX + i]            = uu[0][im0 + k] - sign * degree_oblique * uu[1][im0 + k];
+                buf[(NZ + k) * NX + i]     = uu[1][im0 + k];
+                buf[(2 * NZ + k) * NX + i] = uu[2][im0 + k];
+            }
+        }  // i
 
-                    uu[d][im] = splineFx(spl, dmy_x);
-                    if (d == 0 && sign < 0) uu[d][im] += Shear_rate_eff * delta_y;
-                }  // i
-            }      // d
+        Phase_shift_lines(buf, m, sign * degree_oblique * delta_y, buf + m * NX);
 
-        }  // k
+        for (int i = 0; i < NX; i++) {  // transformed coord
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+            for (int d = 0; d < DIM; d++) {
+                for (int k = 0; k < NZ; k++) uu[d][im0 + k] = buf[(d * NZ + k) * NX + i];
+            }
+            if (sign < 0) {
+                for (int k = 0; k < NZ; k++) uu[0][im0 + k] += Shear_rate_eff * delta_y;
+            }
+        }  // i
     }      // j
 }
 
@@ -566,6 +684,8 @@ inline void Transform_obl_u(double **uu, const OBL_TRANSFORM &flag) {
         }
     } else if (SW_OBL_INT == spline_int) {
         Spline_u_oblique_transform(uu, flag);
+    } else if (SW_OBL_INT == spectral_int) {
+        Spectral_u_oblique_transform(uu, flag);
     } else {
         exit_job(EXIT_FAILURE);
     }
@@ -38,8 +38,8 @@ void Add_random_force_thermostat(Particle *p, const CTime &jikan) {
             }
         }
     } else {  // if rigid
-        int    rigidID;
-        double fdt[3], ndt[3], **forceGsdt, **torqueGsdt;
+        int      rigidID;
+        double **forceGsdt, **torqueGsdt;
         forceGsdt  = alloc_2d_double(Rigid_Number, DIM);
         torqueGsdt = alloc_2d_double(Rigid_Number, DIM);
         for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
@@ -48,26 +48,22 @@ void Add_random_force_thermostat(Particle *p, const CTime &jikan) {
                 torqueGsdt[rigidID][d] = 0.0;
             }
         }
+        // random numbers are drawn serially (reproducible sequence), then summed per rigid body
         for (int n = 0; n < Particle_Number; n++) {
             double dmy[6];
             Gauss2(dmy);
             Gauss2(dmy + 2);
             Gauss2(dmy + 4);
 
-            rigidID = Particle_RigidID[n];
-
             for (int d = 0; d < DIM; d++) {
-                fdt[d] = dmy[d] * noise_intensity_v;
-                ndt[d] = dmy[d + 3] * noise_intensity_o;
-                forceGsdt[rigidID][d] += fdt[d];
-                torqueGsdt[rigidID][d] += ndt[d];  // If same forces exist on a particle's surface,
-                                                   // sum of torques around gravity point of constituent particles and
-                                                   // the torque around gravity point of the rigid particle are same.
+                Rigid_Bead_Forces[n][d]  = dmy[d] * noise_intensity_v;
+                Rigid_Bead_Torques[n][d] = dmy[d + 3] * noise_intensity_o;
+                // If same forces exist on a particle's surface,
+                // sum of torques around gravity point of constituent particles and
+                // the torque around gravity point of the rigid particle are same.
             }
-            torqueGsdt[rigidID][0] += GRvecs[n][1] * fdt[2] - GRvecs[n][2] * fdt[1];
-            torqueGsdt[rigidID][1] += GRvecs[n][2] * fdt[0] - GRvecs[n][0] * fdt[2];
-            torqueGsdt[rigidID][2] += GRvecs[n][0] * fdt[1] - GRvecs[n][1] * fdt[0];
         }
+        rigid_segmented_sum(forceGsdt, torqueGsdt, Rigid_Bead_Forces, Rigid_Bead_Torques);
 
         int rigid_spec;
         for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
@@ -135,6 +135,27 @@ inline void Field_solver_Euler(const int &        dim,
         }
     }
 }
+// Euler step of the ion concentrations. With NP_semi_implicit the linear diffusion kBT Gamma_n nabla^2 c_n is taken
+// at the new time level: the explicit rhs, which still carries the full diffusion flux (impermeability included),
+// is divided by 1 + dt kBT Gamma_n k^2. Steady states are unchanged.
+inline void Solute_solver_Euler(double **conc_k, const CTime &jikan, double **rhs, const Index_range &ijk_range) {
+    if (!NP_semi_implicit) {
+        Field_solver_Euler(N_spec, conc_k, jikan, rhs, ijk_range);
+        return;
+    }
+    for (int n = 0; n < N_spec; n++) {
+        const double dt_diff = jikan.dt_fluid * kBT * Onsager_coeff[n];
+#pragma omp parallel for
+        for (int i = ijk_range.istart; i <= ijk_range.iend; i++) {
+            for (int j = ijk_range.jstart; j <= ijk_range.jend; j++) {
+                for (int k = ijk_range.kstart; k <= ijk_range.kend; k++) {
+                    const int im = (i * NY * NZ_) + (j * NZ_) + k;
+                    conc_k[n][im] += (jikan.dt_fluid * rhs[n][im]) / (1.0 + dt_diff * K2[im]);
+                }
+            }
+        }
+    }
+}
 inline void Rhs_NS(double **          zeta,
                    double             uk_dc[DIM],
                    double **          rhs,
@@ -301,7 +322,7 @@ void Ion_diffusion_solver_Euler(double **          zeta,
                              jikan);
     }
     for (int n = 0; n < n_ijk_range; n++) {
-        Field_solver_Euler(N_spec, concentration_k, jikan, Concentration_rhs0, ijk_range[n]);
+        Solute_solver_Euler(concentration_k, jikan, Concentration_rhs0, ijk_range[n]);
     }
     {
         // double rescale_factor[N_spec];
@@ -337,7 +358,7 @@ void NSsolute_solver_Euler(double **          zeta,
 
     for (int n = 0; n < n_ijk_range; n++) {
         Field_solver_Euler(DIM - 1, zeta, jikan, f_ns1, ijk_range[n]);
-        Field_solver_Euler(N_spec, concentration_k, jikan, Concentration_rhs0, ijk_range[n]);
+        Solute_solver_Euler(concentration_k, jikan, Concentration_rhs0, ijk_range[n]);
     }
 
     for (int d = 0; d < DIM; d++) {
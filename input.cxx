@@ -30,6 +30,8 @@ ST          SW_CHST;
 PO          SW_POTENTIAL;
 const char *NS_SOLVERTYPE_name[] = {"explicit_scheme", "implicit_scheme"};
 const char *CH_SOLVERTYPE_name[] = {"explicit_scheme", "implicit_scheme"};
+const char *PRECOND_name[]       = {"none", "jacobi", "block_ilu0", "chebyshev", "multigrid"};
+const char *INITIAL_GUESS_name[] = {"zero", "current", "extrapolate"};
 const char *POTENTIAL_name[]     = {"Landau", "Flory_Huggins"};
 const char *PSI_0_WALL_name[]    = {"uniform", "user_specify"};
 int         PHASE_SEPARATION;
@@ -38,6 +40,20 @@ double      eps_ns;
 int         maxiter_ns;
 double      eps_ch;
 int         maxiter_ch;
+PC          precond_ns;
+PC          precond_ch;
+int         cheb_degree_ns;
+int         cheb_degree_ch;
+IG          guess_ns;
+int         mg_sweeps_ns;
+int         mg_standalone_ns;
+int         pipelined_ns;
+int         split_ns;
+int         mixed_ns;
+IG          guess_ch;
+int         pipelined_ch;
+int         mixed_ch;
+int         spectral_ch;
 double      XYaspect;
 double      ETA_A;
 double      ETA_B;
@@ -50,7 +66,7 @@ PT          SW_PT;
 const char *PT_name[] = {"spherical_particle", "chain", "rigid"};
 //////
 OBL_INT     SW_OBL_INT;
-const char *OBL_INT_name[] = {"linear", "spline"};
+const char *OBL_INT_name[] = {"linear", "spline", "spectral"};
 //////
 WALL        SW_WALL;
 const char *WALL_name[] = {"NONE", "FLAT"};
@@ -236,6 +252,8 @@ int *     Particle_RigidID;
 ////
 double **GRvecs;
 double **GRvecs_body;
+double **Rigid_Bead_Forces;
+double **Rigid_Bead_Torques;
 //
 double  NU;
 double  IRHO;
@@ -287,6 +305,7 @@ int    N_spec;
 double Onsager_solute_coeff;
 /////// Electrolyte
 int     Poisson_Boltzmann;
+int     NP_semi_implicit;
 int     External_field;
 int     AC;
 int     Shear_AC;
@@ -388,6 +407,14 @@ inline void Set_quincke_parameters() {
 
 inline void Set_multipole_parameters() {
     if (SW_MULTIPOLE == MULTIPOLE_ON) {
+        if (ewald_param.m_image) {  // conducting images across the lower wall surface
+            if (SW_WALL != FLAT_WALL) {
+                fprintf(stderr, "# Error : mirror images require a FLAT_WALL...\n");
+                exit(-1);
+            }
+            ewald_param.mirror_axis = wall.axis;
+            ewald_param.mirror_pos  = wall.lo;
+        }
         {
             fprintf(stderr, "#\n");
             fprintf(stderr, "# Ewald Multipole Enabled \n");
@@ -417,6 +444,13 @@ inline void Set_multipole_parameters() {
                     for (int i = 0; i < Component_Number; i++)
                         fprintf(stderr, "# \tSpecies = %2d, p_0 = %5.2f\n", i, multipole_mu[i][0]);  // Quincke Hack
                 }
+                if (ewald_param.polarizable) {
+                    fprintf(stderr,
+                            "# Induced Dipoles : alpha = %5.2f, tol = %8g, max iter = %d\n",
+                            ewald_param.polarizability,
+                            ewald_param.pol_tol,
+                            ewald_param.pol_max_iter);
+                }
             }
             fprintf(stderr, "#\n");
         }
@@ -508,7 +542,21 @@ inline void Set_global_parameters(void) {
                 exit_job(EXIT_FAILURE);
             }
             double diffusion_time = 1. / (kBT * dmy_onsager_coeff * KMAX2);
-            Tdump                 = MIN(Tdump, diffusion_time);
+            if (NP_semi_implicit) {
+                // electromigration stays explicit: charge fluctuations relax at the k-independent rate
+                // kBT Gamma / lambda_D^2, which bounds the step once diffusion is implicit
+                fprintf(stderr, "# ion diffusion is implicit (diffusion time %g not imposed)\n", diffusion_time);
+                if (N_spec == 2) {
+                    double debye_time = SQ(Debye_length) / (kBT * dmy_onsager_coeff);
+                    fprintf(stderr, "# Debye time %g imposed\n", debye_time);
+                    Tdump = MIN(Tdump, debye_time);
+                } else {
+                    // salt free: lambda_D follows from the counterion density, checked against DT in Init_rho_ion
+                    fprintf(stderr, "# Debye time checked at initialisation (salt free)\n");
+                }
+            } else {
+                Tdump = MIN(Tdump, diffusion_time);
+            }
             if (External_field) {
                 if (AC) {
                     double dmy            = 1.e-2;
@@ -676,6 +724,89 @@ bool io_parser_check(const Location &location, T &var) {
     return in;
 }
 
+/*!
+    \brief Read the (optional) preconditioner of the built-in BiCGSTAB solver
+    \param[in] target UDF location of the implicit_scheme node
+    \param[out] pc preconditioner type (no_precond if absent)
+    \param[out] degree polynomial degree of the Chebyshev preconditioner
+    \param[out] mg_sweeps smoothing sweeps of the multigrid V-cycle (NULL: multigrid not available)
+    \param[out] mg_standalone iterate V-cycles without BiCGSTAB
+ */
+inline void Read_preconditioner(Location &target, PC &pc, int &degree, int *mg_sweeps, int *mg_standalone) {
+    string str;
+    pc     = no_precond;
+    degree = 0;
+    if (io_parser_check(target.sub("preconditioner.type"), str)) {
+        if (str == PRECOND_name[no_precond]) {
+            pc = no_precond;
+        } else if (str == PRECOND_name[jacobi_precond]) {
+            pc = jacobi_precond;
+        } else if (str == PRECOND_name[block_ilu0_precond]) {
+            pc = block_ilu0_precond;
+        } else if (str == PRECOND_name[chebyshev_precond]) {
+            pc = chebyshev_precond;
+            io_parser(target.sub("preconditioner.chebyshev.degree"), degree);
+            if (degree < 1) {
+                fprintf(stderr, "invalid Chebyshev preconditioner degree\n");
+                exit_job(EXIT_FAILURE);
+            }
+        } else if (str == PRECOND_name[multigrid_precond] && mg_sweeps != NULL) {
+            pc = multigrid_precond;
+            io_parser(target.sub("preconditioner.multigrid.sweeps"), *mg_sweeps);
+            io_parser(target.sub("preconditioner.multigrid.standalone"), str);
+            if (*mg_sweeps < 1 || (str != "ON" && str != "OFF")) {
+                fprintf(stderr, "invalid multigrid preconditioner parameters\n");
+                exit_job(EXIT_FAILURE);
+            }
+            *mg_standalone = (str == "ON") ? 1 : 0;
+        } else {
+            fprintf(stderr, "invalid preconditioner selection\n");
+            exit_job(EXIT_FAILURE);
+        }
+    }
+}
+
+/*!
+    \brief Read the (optional) initial guess of the built-in BiCGSTAB solver
+    \param[in] target UDF location of the implicit_scheme node
+    \param[out] guess initial guess type (zero_guess if absent)
+ */
+inline void Read_initial_guess(Location &target, IG &guess) {
+    string str;
+    guess = zero_guess;
+    if (io_parser_check(target.sub("initial_guess"), str)) {
+        if (str == INITIAL_GUESS_name[zero_guess]) {
+            guess = zero_guess;
+        } else if (str == INITIAL_GUESS_name[current_guess]) {
+            guess = current_guess;
+        } else if (str == INITIAL_GUESS_name[extrapolated_guess]) {
+            guess = extrapolated_guess;
+        } else {
+            fprintf(stderr, "invalid initial guess selection\n");
+            exit_job(EXIT_FAILURE);
+        }
+    }
+}
+
+/*!
+    \brief Read an optional ON/OFF switch of an implicit_scheme node
+    \param[in] target UDF location of the implicit_scheme node
+    \param[in] name switch name
+    \param[out] flag 1 for ON (0 if absent)
+ */
+inline void Read_switch(Location &target, const char *name, int &flag) {
+    string str;
+    flag = 0;
+    if (io_parser_check(target.sub(name), str)) {
+        if (str == "ON") {
+            flag = 1;
+        } else if (str != "OFF") {
+            fprintf(stderr, "invalid %s selection\n", name);
+            exit_job(EXIT_FAILURE);
+        }
+    }
+}
+
 void Gourmet_file_io(const char *infile,
                      const char *outfile,
                      const char *sumfile,
@@ -869,6 +1000,17 @@ void Gourmet_file_io(const char *infile,
                             exit_job(EXIT_FAILURE);
                         }
                     }
+                    {
+                        NP_semi_implicit = 0;
+                        if (io_parser_check(target.sub("Nernst_Planck_scheme"), str)) {
+                            if (str == "semi_implicit") {
+                                NP_semi_implicit = 1;
+                            } else if (str != "explicit") {
+                                fprintf(stderr, "invalid Nernst_Planck_scheme\n");
+                                exit_job(EXIT_FAILURE);
+                            }
+                        }
+                    }
                     {
                         Location target("constitutive_eq.Electrolyte.Add_salt");
                         io_parser(target.sub("type"), str);
@@ -954,6 +1096,11 @@ void Gourmet_file_io(const char *infile,
                         target.down("NS_solver.implicit_scheme");
                         io_parser(target.sub("tolerance"), eps_ns);
                         io_parser(target.sub("maximum_iteration"), maxiter_ns);
+                        Read_preconditioner(target, precond_ns, cheb_degree_ns, &mg_sweeps_ns, &mg_standalone_ns);
+                        Read_initial_guess(target, guess_ns);
+                        Read_switch(target, "pipelined", pipelined_ns);
+                        Read_switch(target, "mixed_precision", mixed_ns);
+                        Read_switch(target, "component_split", split_ns);
                         target.up();
                         target.up();
                     } else {
@@ -985,6 +1132,11 @@ void Gourmet_file_io(const char *infile,
 
                         io_parser(target.sub("tolerance"), eps_ns);
                         io_parser(target.sub("maximum_iteration"), maxiter_ns);
+                        Read_preconditioner(target, precond_ns, cheb_degree_ns, &mg_sweeps_ns, &mg_standalone_ns);
+                        Read_initial_guess(target, guess_ns);
+                        Read_switch(target, "pipelined", pipelined_ns);
+                        Read_switch(target, "mixed_precision", mixed_ns);
+                        Read_switch(target, "component_split", split_ns);
                         io_parser(target.sub("viscosity_change"), str);
                         {
                             if (str == "OFF") {
@@ -1017,6 +1169,11 @@ void Gourmet_file_io(const char *infile,
                         target.down("CH_solver.implicit_scheme");
                         io_parser(target.sub("tolerance"), eps_ch);
                         io_parser(target.sub("maximum_iteration"), maxiter_ch);
+                        Read_preconditioner(target, precond_ch, cheb_degree_ch, NULL, NULL);
+                        Read_initial_guess(target, guess_ch);
+                        Read_switch(target, "pipelined", pipelined_ch);
+                        Read_switch(target, "mixed_precision", mixed_ch);
+                        Read_switch(target, "spectral", spectral_ch);
                         target.up();
                         target.up();
                     } else {
@@ -1125,6 +1282,11 @@ void Gourmet_file_io(const char *infile,
                         target.down("NS_solver.implicit_scheme");
                         io_parser(target.sub("tolerance"), eps_ns);
                         io_parser(target.sub("maximum_iteration"), maxiter_ns);
+                        Read_preconditioner(target, precond_ns, cheb_degree_ns, &mg_sweeps_ns, &mg_standalone_ns);
+                        Read_initial_guess(target, guess_ns);
+                        Read_switch(target, "pipelined", pipelined_ns);
+                        Read_switch(target, "mixed_precision", mixed_ns);
+                        Read_switch(target, "component_split", split_ns);
                         target.up();
                         target.up();
                     } else {
@@ -1180,6 +1342,11 @@ void Gourmet_file_io(const char *infile,
                         target.down("NS_solver.implicit_scheme");
                         io_parser(target.sub("tolerance"), eps_ns);
                         io_parser(target.sub("maximum_iteration"), maxiter_ns);
+                        Read_preconditioner(target, precond_ns, cheb_degree_ns, &mg_sweeps_ns, &mg_standalone_ns);
+                        Read_initial_guess(target, guess_ns);
+                        Read_switch(target, "pipelined", pipelined_ns);
+                        Read_switch(target, "mixed_precision", mixed_ns);
+                        Read_switch(target, "component_split", split_ns);
                         io_parser(target.sub("viscosity_change"), str);
                         {
                             if (str == "OFF") {
@@ -1212,6 +1379,10 @@ void Gourmet_file_io(const char *infile,
                         target.down("CH_solver.implicit_scheme");
                         io_parser(target.sub("tolerance"), eps_ch);
                         io_parser(target.sub("maximum_iteration"), maxiter_ch);
+                        Read_preconditioner(target, precond_ch, cheb_degree_ch, NULL, NULL);
+                        Read_initial_guess(target, guess_ch);
+                        Read_switch(target, "pipelined", pipelined_ch);
+                        Read_switch(target, "mixed_precision", mixed_ch);
                         target.up();
                         target.up();
                     } else {
@@ -2090,6 +2261,8 @@ void Gourmet_file_io(const char *infile,
                     SW_OBL_INT = linear_int;
                 } else if (str == OBL_INT_name[spline_int]) {
                     SW_OBL_INT = spline_int;
+                } else if (str == OBL_INT_name[spectral_int]) {
+                    SW_OBL_INT = spectral_int;
                 } else {
                     exit_job(EXIT_FAILURE);
                 }
@@ -2100,6 +2273,8 @@ void Gourmet_file_io(const char *infile,
                     fprintf(stderr, "# OBL/RCT transform. scheme: linear\n");
                 } else if (SW_OBL_INT == spline_int) {
                     fprintf(stderr, "# OBL/RCT transform. scheme: periodic spline\n");
+                } else if (SW_OBL_INT == spectral_int) {
+                    fprintf(stderr, "# OBL/RCT transform. scheme: spectral phase shift\n");
                 } else {
                     exit_job(EXIT_FAILURE);
                 }
@@ -2322,8 +2497,6 @@ void Gourmet_file_io(const char *infile,
                                     mu_vec[0] = magnitude;  // hack the dipole array to store the magnitude
                                     compute_particle_dipole =
                                         compute_particle_dipole_quincke;  // use quincke dipole definition
-                                    compute_particle_dipole_image =
-                                        compute_particle_dipole_quincke_image;  // use quincke dipole definition image
                                     target.down("QUINCKE");
                                     io_parser(target.sub("type"), str);
                                     if (str == "with_mirror_image") {
@@ -2346,6 +2519,29 @@ void Gourmet_file_io(const char *infile,
                                 for (int i = 0; i < Component_Number; i++)
                                     for (int d = 0; d < DIM; d++) multipole_mu[i][d] = mu_vec[d];
 
+                                {  // optional: self-consistent induced dipoles
+                                    string str_pol;
+                                    target.down("Polarization");
+                                    if (io_parser_check(target.sub("type"), str_pol) && str_pol == "ON") {
+                                        double pol_alpha    = ewald_param.polarizability;
+                                        double pol_tol      = ewald_param.pol_tol;
+                                        int    pol_max_iter = ewald_param.pol_max_iter;
+                                        target.down("ON");
+                                        io_parser(target.sub("alpha"), pol_alpha);
+                                        io_parser(target.sub("tol"), pol_tol);
+                                        io_parser(target.sub("max_iter"), pol_max_iter);
+                                        target.up();  // ON
+                                        if (pol_alpha <= 0.0 || pol_tol <= 0.0 || pol_max_iter < 1) {
+                                            fprintf(stderr,
+                                                    "# Error : polarizability, tolerance and iterations must be "
+                                                    "positive\n");
+                                            exit(-1);
+                                        }
+                                        ewald_param.init_polarization(pol_alpha, pol_tol, pol_max_iter);
+                                    }
+                                    target.up();  // Polarization
+                                }
+
                                 target.up();  // Dipole ON
                             }
                         }
@@ -2365,10 +2561,46 @@ void Gourmet_file_io(const char *infile,
                             io_parser(target.sub("delta"), delta);
                             io_parser(target.sub("converge"), conv);
                             io_parser(target.sub("epsilon"), epsilon);
+                            io_parser_check(target.sub("rcut"), ewald_param.rcut);
                             target.up();
                         }
 
                         ewald_param.init(alpha, delta, conv, epsilon, charge, dipole);
+
+                        {  // optional: smooth particle mesh ewald
+                            string str_spme;
+                            target.down("EwaldParams");
+                            target.down("SPME");
+                            if (io_parser_check(target.sub("type"), str_spme) && str_spme == "ON") {
+                                int mesh_x = ewald_param.spme_mesh[0];
+                                int mesh_y = ewald_param.spme_mesh[1];
+                                int mesh_z = ewald_param.spme_mesh[2];
+                                int order  = ewald_param.spme_order;
+                                target.down("ON");
+                                io_parser(target.sub("mesh_x"), mesh_x);
+                                io_parser(target.sub("mesh_y"), mesh_y);
+                                io_parser(target.sub("mesh_z"), mesh_z);
+                                io_parser(target.sub("order"), order);
+                                target.up();  // ON
+
+                                int mesh[DIM] = {mesh_x, mesh_y, mesh_z};
+                                for (int d = 0; d < DIM; d++) {
+                                    if (mesh[d] < order || (mesh[d] & (mesh[d] - 1)) != 0) {
+                                        fprintf(stderr,
+                                                "# Error : SPME mesh must be a power of 2 and larger than the spline "
+                                                "order\n");
+                                        exit(-1);
+                                    }
+                                }
+                                if (order < 4) {
+                                    fprintf(stderr, "# Error : SPME spline order must be >= 4\n");
+                                    exit(-1);
+                                }
+                                ewald_param.init_spme(mesh_x, mesh_y, mesh_z, order);
+                            }
+                            target.up();  // SPME
+                            target.up();  // EwaldParams
+                        }
                     }
                 }
                 target.up();  // Multipole ON
@@ -2545,8 +2777,10 @@ void Gourmet_file_io(const char *infile,
 
     if (SW_PT == rigid) {
         // allocation (using Particle_Number)
-        GRvecs      = alloc_2d_double(Particle_Number, DIM);
-        GRvecs_body = alloc_2d_double(Particle_Number, DIM);
+        GRvecs             = alloc_2d_double(Particle_Number, DIM);
+        GRvecs_body        = alloc_2d_double(Particle_Number, DIM);
+        Rigid_Bead_Forces  = alloc_2d_double(Particle_Number, DIM);
+        Rigid_Bead_Torques = alloc_2d_double(Particle_Number, DIM);
 
         // set Particle_RigidID
         int rigid_n1     = 0;
@@ -43,6 +43,8 @@ enum EQ {
     Shear_NS_LE_CH_FDM
 };
 enum ST { explicit_scheme, implicit_scheme };
+enum PC { no_precond, jacobi_precond, block_ilu0_precond, chebyshev_precond, multigrid_precond };
+enum IG { zero_guess, current_guess, extrapolated_guess };
 enum PO { Landau, Flory_Huggins };
 enum PT { spherical_particle, chain, rigid };
 enum JAX { x_axis, y_axis, z_axis, no_axis };
@@ -50,7 +52,7 @@ enum JP { motor, slip, obstacle, no_propulsion };
 enum WALL { NO_WALL, FLAT_WALL };
 enum QUINCKE { QUINCKE_OFF, QUINCKE_ON };
 enum MULTIPOLE { MULTIPOLE_OFF, MULTIPOLE_ON };
-enum OBL_INT { linear_int, spline_int };
+enum OBL_INT { linear_int, spline_int, spectral_int };
 enum OBL_TRANSFORM { oblique2cartesian, cartesian2oblique };
 
 enum OUTFORMAT { OUT_NONE, OUT_AVS_ASCII, OUT_AVS_BINARY, OUT_EXT };
@@ -67,6 +69,8 @@ extern ST          SW_CHST;
 extern PO          SW_POTENTIAL;
 extern const char *NS_SOLVERTYPE_name[];
 extern const char *CH_SOLVERTYPE_name[];
+extern const char *PRECOND_name[];
+extern const char *INITIAL_GUESS_name[];
 extern const char *POTENTIAL_name[];
 extern int         PHASE_SEPARATION;
 extern int         VISCOSITY_CHANGE;
@@ -74,6 +78,20 @@ extern double      eps_ns;
 extern int         maxiter_ns;
 extern double      eps_ch;
 extern int         maxiter_ch;
+extern PC          precond_ns;
+extern PC          precond_ch;
+extern int         cheb_degree_ns;
+extern int         cheb_degree_ch;
+extern IG          guess_ns;
+extern int         mg_sweeps_ns;
+extern int         mg_standalone_ns;
+extern int         pipelined_ns;
+extern int         split_ns;
+extern int         mixed_ns;
+extern IG          guess_ch;
+extern int         pipelined_ch;
+extern int         mixed_ch;
+extern int         spectral_ch;
 extern double      XYaspect;
 extern double      ETA_A;
 extern double      ETA_B;
@@ -217,13 +235,11 @@ extern void compute_particle_dipole_standard(double *mu_space, const double *mu_
     \param[in]  q orientation quaternion
 */
 extern void compute_particle_dipole_quincke(double *mu_space, const double *mu_body, quaternion &q);
-extern void compute_particle_dipole_quincke_image(double *mu_space, const double *mu_body, quaternion &q);
 
 /*!
     \brief Generic funtion pointer used to compute particle dipole
 */
 extern void (*compute_particle_dipole)(double *mu_space, const double *mu_body, quaternion &q);
-extern void (*compute_particle_dipole_image)(double *mu_space, const double *mu_body, quaternion &q);
 
 //////
 extern char Out_dir[];
@@ -335,6 +351,8 @@ extern int *     Particle_RigidID;
 ////
 extern double **GRvecs;
 extern double **GRvecs_body;
+extern double **Rigid_Bead_Forces;   // per-bead scratch for segmented reductions
+extern double **Rigid_Bead_Torques;
 //////
 extern int GTS;
 extern int Num_snap;
@@ -366,6 +384,7 @@ extern int    N_spec;
 extern double Onsager_solute_coeff;
 /////// Electrolyte
 extern int     Poisson_Boltzmann;
+extern int     NP_semi_implicit;
 extern int     External_field;
 extern int     AC;
 extern int     Shear_AC;
@@ -7,3 +7,77 @@
  */
 
 #include "interaction.h"
+
+int *               Particle_Group           = NULL;
+unsigned long long *Species_Interaction_Mask = NULL;
+int                 Species_Mask_Words       = 0;
+int *               Partner_Range_Ptr        = NULL;
+int *               Partner_Range            = NULL;
+
+inline int push_partner_range(int *range, int nrange, const int &begin, const int &end) {
+    if (begin >= end) return nrange;
+    if (nrange > 0 && range[2 * nrange - 1] == begin) {  // merge with previous range
+        range[2 * nrange - 1] = end;
+        return nrange;
+    }
+    range[2 * nrange]     = begin;
+    range[2 * nrange + 1] = end;
+    return nrange + 1;
+}
+
+void Init_pair_exclusion() {
+    // exclusion groups
+    Particle_Group = alloc_1d_int(Particle_Number);
+    for (int n = 0; n < Particle_Number; n++) {
+        Particle_Group[n] = (SW_PT == rigid ? Particle_RigidID[n] : -1);
+    }
+
+    // species interaction mask
+    Species_Mask_Words       = (Component_Number + 63) / 64;
+    Species_Interaction_Mask = calloc_1d<unsigned long long>(Component_Number * Species_Mask_Words, MEMORY_ALIGNMENT);
+    for (int spec_i = 0; spec_i < Component_Number; spec_i++) {
+        for (int spec_j = 0; spec_j < Component_Number; spec_j++) {
+            if (!((janus_propulsion[spec_i] == obstacle) && (janus_propulsion[spec_j] == obstacle))) {
+                Species_Interaction_Mask[spec_i * Species_Mask_Words + (spec_j >> 6)] |= (1ULL << (spec_j & 63));
+            }
+        }
+    }
+
+    // partner ranges: species blocks [spec_first[s], spec_first[s+1]) cut below the end of the own group
+    // (groups are contiguous and contain n, so only partners m >= group_end survive)
+    int *spec_first = alloc_1d_int(Component_Number + 1);
+    spec_first[0]   = 0;
+    for (int s = 0; s < Component_Number; s++) spec_first[s + 1] = spec_first[s] + Particle_Numbers[s];
+
+    const int max_range = Component_Number;
+    int *     range     = alloc_1d_int(2 * max_range);
+    Partner_Range_Ptr   = alloc_1d_int(Particle_Number + 1);
+    Partner_Range       = alloc_1d_int(2 * max_range * Particle_Number);
+
+    Partner_Range_Ptr[0] = 0;
+    int spec_n           = 0;
+    for (int n = 0; n < Particle_Number; n++) {
+        while (n >= spec_first[spec_n + 1]) spec_n++;
+        const int group_end = (Particle_Group[n] >= 0 ? Rigid_Particle_Cumul[Particle_Group[n] + 1] : n + 1);
+
+        int nrange = 0;
+        for (int s = spec_n; s < Component_Number; s++) {
+            if (!((Species_Interaction_Mask[spec_n * Species_Mask_Words + (s >> 6)] >> (s & 63)) & 1ULL)) continue;
+            nrange = push_partner_range(range, nrange, MAX(spec_first[s], group_end), spec_first[s + 1]);
+        }
+
+        const int offset          = Partner_Range_Ptr[n];
+        Partner_Range_Ptr[n + 1] = offset + nrange;
+        for (int k = 0; k < 2 * nrange; k++) Partner_Range[2 * offset + k] = range[k];
+    }
+
+    free_1d_int(range);
+    free_1d_int(spec_first);
+}
+
+void Free_pair_exclusion() {
+    free_1d_int(Particle_Group);
+    free_1d(Species_Interaction_Mask);
+    free_1d_int(Partner_Range_Ptr);
+    free_1d_int(Partner_Range);
+}
@@ -13,25 +13,43 @@
 #include "macro.h"
 
 /*!
-  \brief Determine if two particle belong to the same rigid chain
+  \brief Exclusion group of each particle (rigid body ID, or -1 if the particle belongs to no group)
+  \details Pairs of particles sharing a non-negative group ID never interact.
  */
-inline int rigid_chain(const int &i, const int &j) {
-    int dmy = 0;
-    if (SW_PT == rigid) {
-        if (Particle_RigidID[i] == Particle_RigidID[j]) dmy = 1;
-    }
-    return dmy;
-}
+extern int *Particle_Group;
 
-/*
-  \brief Determine if two particles are both obstacles
+/*!
+  \brief Species interaction bitsets
+  \details Bit \f$s_j\f$ of row \f$s_i\f$ (Species_Mask_Words words per row) is set if particles of species
+  \f$s_i\f$ and \f$s_j\f$ interact (obstacle-obstacle pairs are masked out)
  */
-inline int obstacle_chain(const int &spec_i, const int &spec_j) {
-    int dmy = 0;
-    if ((janus_propulsion[spec_i] == obstacle) && (janus_propulsion[spec_j] == obstacle)) {
-        dmy = 1;
-    }
-    return dmy;
+extern unsigned long long *Species_Interaction_Mask;
+extern int                 Species_Mask_Words;
+
+/*!
+  \brief Ranges of interacting partners for the all-pairs force loop
+  \details Partners m > n of particle n which are not excluded are given by the half-open ranges
+  [Partner_Range[2k], Partner_Range[2k+1]) with Partner_Range_Ptr[n] <= k < Partner_Range_Ptr[n+1].
+  Rigid bodies and species occupy contiguous blocks of particle IDs, so exclusions reduce to a few gaps.
+ */
+extern int *Partner_Range_Ptr;
+extern int *Partner_Range;
+
+/*!
+  \brief Build the particle exclusion groups, species interaction mask and partner ranges
+  \details Exclusions are purely topological, so this is called once after the particles are set up
+ */
+void Init_pair_exclusion();
+void Free_pair_exclusion();
+
+/*!
+  \brief Determine if two particles interact, i.e., they are neither in the same rigid body nor both obstacles
+  \details Meant to be used while building neighbour lists, not inside the force loop
+ */
+inline bool interacting_pair(const int &i, const int &j, const int &spec_i, const int &spec_j) {
+    const int group_i = Particle_Group[i];
+    if (group_i >= 0 && group_i == Particle_Group[j]) return false;
+    return (Species_Interaction_Mask[spec_i * Species_Mask_Words + (spec_j >> 6)] >> (spec_j & 63)) & 1ULL;
 }
 
 /*!
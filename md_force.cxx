@@ -25,23 +25,10 @@ void compute_particle_dipole_quincke(double *mu_space, const double *mu_body, qu
     mu_space[2] *= magnitude;
     mu_space[2] -= magnitude * ewald_param.Pz_factor;
 }
-void compute_particle_dipole_quincke_image(double *mu_space, const double *mu_body, quaternion &q) {
-    double e_omega_space[DIM] = {0.0, 0.0, 0.0};
-    rigid_body_rotation(e_omega_space, quincke.e_omega, q, BODY2SPACE);
-    mu_space[0]            = quincke.n[1] * e_omega_space[2] - quincke.n[2] * e_omega_space[1];
-    mu_space[1]            = quincke.n[2] * e_omega_space[0] - quincke.n[0] * e_omega_space[2];
-    mu_space[2]            = quincke.n[0] * e_omega_space[1] - quincke.n[1] * e_omega_space[0];
-    const double magnitude = mu_body[0] / sqrt(SQ(mu_space[0]) + SQ(mu_space[1]) + SQ(mu_space[2]));
-    mu_space[0] *= -magnitude;
-    mu_space[1] *= -magnitude;
-    mu_space[2] *= magnitude;
-    mu_space[2] -= magnitude * ewald_param.Pz_factor;
-}
 void compute_particle_dipole_standard(double *mu_space, const double *mu_body, quaternion &q) {
     rigid_body_rotation(mu_space, mu_body, q, BODY2SPACE);
 }
 void (*compute_particle_dipole)(double *mu_space, const double *mu_body, quaternion &q);
-void (*compute_particle_dipole_image)(double *mu_space, const double *mu_body, quaternion &q);
 
 void Calc_f_Lennard_Jones_shear_cap_primitive_lnk(
     Particle *p,
@@ -89,6 +76,9 @@ void Calc_f_Lennard_Jones_shear_cap_primitive_lnk(
         head[cn] = n;
     }
 
+    // Neighbour list construction: excluded pairs (same rigid body, obstacle-obstacle) are filtered here
+    static std::vector<int> pair_list;
+    pair_list.clear();
     for (ic[0] = 0; ic[0] < lc[0]; ic[0]++) {
         for (ic[1] = 0; ic[1] < lc[1]; ic[1]++) {
             for (ic[2] = 0; ic[2] < lc[2]; ic[2]++) {
@@ -114,63 +104,11 @@ void Calc_f_Lennard_Jones_shear_cap_primitive_lnk(
                             // Scan atom i in cell c
                             i = head[cn];
                             while (i != -1) {
-                                j             = head[cl];
-                                int rigidID_i = -1;
-                                if (SW_PT == rigid) rigidID_i = Particle_RigidID[i];
-
+                                j = head[cl];
                                 while (j != -1) {
-                                    if (i > j && !rigid_chain(i, j) && !obstacle_chain(p[i].spec, p[j].spec)) {
-                                        distance0_func(p[i].x, p[j].x, r_ij, r_ij_vec);
-
-                                        if (r_ij < pair_cutoff) {
-                                            double dmy_r = 0.0;
-
-                                            dmy_r = MIN(cap / r_ij, Lennard_Jones_f(r_ij, LJ_dia, EPSILON, LJ_powers));
-
-                                            {
-                                                // spherical particle forces
-                                                double dmy_fi[DIM] = {0.0, 0.0, 0.0};
-                                                for (int d = 0; d < DIM; d++) {
-                                                    dmy_fi[d] = (dmy_r) * (-r_ij_vec[d]);
-
-                                                    p[i].fr[d] += dmy_fi[d];
-                                                    p[j].fr[d] -= dmy_fi[d];
-                                                }
-
-                                                // stress
-                                                shear_stress[0] += (dmy_fi[0] * r_ij_vec[1]);
-
-                                                // rigid body forces & torques
-                                                // particles treated as additive LJ centers: overlaps are not corrected
-                                                if (SW_PT == rigid) {
-                                                    int rigidID_j = Particle_RigidID[j];
-
-                                                    for (int d = 0; d < DIM; d++) {
-                                                        forceGrs[rigidID_i][d] += dmy_fi[d];
-                                                        forceGrs[rigidID_j][d] -= dmy_fi[d];
-                                                    }
-
-                                                    torqueGrs[rigidID_i][0] +=
-                                                        ((GRvecs[i][1] * dmy_fi[2] - GRvecs[i][2] * dmy_fi[1]));
-                                                    torqueGrs[rigidID_i][1] +=
-                                                        ((GRvecs[i][2] * dmy_fi[0] - GRvecs[i][0] * dmy_fi[2]));
-                                                    torqueGrs[rigidID_i][2] +=
-                                                        ((GRvecs[i][0] * dmy_fi[1] - GRvecs[i][1] * dmy_fi[0]));
-
-                                                    torqueGrs[rigidID_j][0] +=
-                                                        ((GRvecs[j][1] * dmy_fi[2] - GRvecs[j][2] * dmy_fi[1]));
-                                                    torqueGrs[rigidID_j][1] +=
-                                                        ((GRvecs[j][2] * dmy_fi[0] - GRvecs[j][0] * dmy_fi[2]));
-                                                    torqueGrs[rigidID_j][2] +=
-                                                        ((GRvecs[j][0] * dmy_fi[1] - GRvecs[j][1] * dmy_fi[0]));
-
-                                                    double R_IJ_vec[DIM];
-                                                    double R_IJ;
-                                                    distance0_func(xGs[rigidID_i], xGs[rigidID_j], R_IJ, R_IJ_vec);
-                                                    rigid_shear_stress[0] += (dmy_fi[0] * R_IJ_vec[1]);
-                                                }
-                                            }
-                                        }
+                                    if (i > j && interacting_pair(i, j, p[i].spec, p[j].spec)) {
+                                        pair_list.push_back(i);
+                                        pair_list.push_back(j);
                                     }
                                     j = lscl[j];
                                 }
@@ -183,10 +121,56 @@ void Calc_f_Lennard_Jones_shear_cap_primitive_lnk(
         }
     }
 
+    if (SW_PT == rigid) Reset_rigid_bead_forces();
+
+    // Force loop over the neighbour list (no exclusion tests needed)
+    const int num_pairs = pair_list.size() / 2;
+    for (int k = 0; k < num_pairs; k++) {
+        i = pair_list[2 * k];
+        j = pair_list[2 * k + 1];
+        distance0_func(p[i].x, p[j].x, r_ij, r_ij_vec);
+
+        if (r_ij < pair_cutoff) {
+            double dmy_r = 0.0;
+
+            dmy_r = MIN(cap / r_ij, Lennard_Jones_f(r_ij, LJ_dia, EPSILON, LJ_powers));
+
+            {
+                // spherical particle forces
+                double dmy_fi[DIM] = {0.0, 0.0, 0.0};
+                for (int d = 0; d < DIM; d++) {
+                    dmy_fi[d] = (dmy_r) * (-r_ij_vec[d]);
+
+                    p[i].fr[d] += dmy_fi[d];
+                    p[j].fr[d] -= dmy_fi[d];
+                }
+
+                // stress
+                shear_stress[0] += (dmy_fi[0] * r_ij_vec[1]);
+
+                // rigid body forces & torques
+                // particles treated as additive LJ centers: overlaps are not corrected
+                if (SW_PT == rigid) {
+                    for (int d = 0; d < DIM; d++) {
+                        Rigid_Bead_Forces[i][d] += dmy_fi[d];
+                        Rigid_Bead_Forces[j][d] -= dmy_fi[d];
+                    }
+
+                    double R_IJ_vec[DIM];
+                    double R_IJ;
+                    distance0_func(xGs[Particle_RigidID[i]], xGs[Particle_RigidID[j]], R_IJ, R_IJ_vec);
+                    rigid_shear_stress[0] += (dmy_fi[0] * R_IJ_vec[1]);
+                }
+            }
+        }
+    }
+
     dev_shear_stress_lj += shear_stress[0];
     dev_shear_stress_rot += shear_stress[1];
 
     if (SW_PT == rigid) {
+        rigid_segmented_sum(forceGrs, torqueGrs, Rigid_Bead_Forces, NULL);
+
         double dmy_shear = 0.0;
 #pragma omp parallel for reduction(+ : dmy_shear)
         for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
@@ -219,6 +203,8 @@ void Calc_f_Lennard_Jones_shear_cap_primitive(
     double ss0 = 0.0;
     double rs0 = 0.0;
 
+    if (SW_PT == rigid) Reset_rigid_bead_forces();
+
     for (int n = 0; n < Particle_Number; n++) {
         Particle *p_n       = &p[n];
         int       rigidID_n = -1;
@@ -228,68 +214,56 @@ void Calc_f_Lennard_Jones_shear_cap_primitive(
         double sum_dmy_fn_1 = 0.0;
         double sum_dmy_fn_2 = 0.0;
 
-        double sum_torqueGrs_0 = 0.0;
-        double sum_torqueGrs_1 = 0.0;
-        double sum_torqueGrs_2 = 0.0;
-
-#pragma omp parallel for reduction(+: ss0, rs0, sum_dmy_fn_0, sum_dmy_fn_1, sum_dmy_fn_2, sum_torqueGrs_0, sum_torqueGrs_1, sum_torqueGrs_2)
-        for (int m = n + 1; m < Particle_Number; m++) {
-            Particle *p_m           = &p[m];
-            double    r_ij_vec[DIM] = {0.0, 0.0, 0.0};
-            double    r_ij          = 0.0;
+        // partners of n are the precomputed ranges of non-excluded particles m > n
+#pragma omp parallel reduction(+ : ss0, rs0, sum_dmy_fn_0, sum_dmy_fn_1, sum_dmy_fn_2)
+        for (int k = Partner_Range_Ptr[n]; k < Partner_Range_Ptr[n + 1]; k++) {
+#pragma omp for nowait
+            for (int m = Partner_Range[2 * k]; m < Partner_Range[2 * k + 1]; m++) {
+                Particle *p_m           = &p[m];
+                double    r_ij_vec[DIM] = {0.0, 0.0, 0.0};
+                double    r_ij          = 0.0;
 
-            distance0_func((*p_n).x, (*p_m).x, r_ij, r_ij_vec);
+                distance0_func((*p_n).x, (*p_m).x, r_ij, r_ij_vec);
 
-            if (r_ij < pair_cutoff && !rigid_chain(n, m) && !obstacle_chain((*p_n).spec, (*p_m).spec)) {
-                double dmy_r = MIN(cap / r_ij, Lennard_Jones_f(r_ij, LJ_dia, EPSILON, LJ_powers));
-
-                {
-                    // forces
-                    double dmy_fn[DIM] = {0.0, 0.0, 0.0};
-                    for (int d = 0; d < DIM; d++) {
-                        dmy_fn[d] = (dmy_r) * (-r_ij_vec[d]);
-                        (*p_m).fr[d] -= dmy_fn[d];
-                    }
-                    sum_dmy_fn_0 += dmy_fn[0];
-                    sum_dmy_fn_1 += dmy_fn[1];
-                    sum_dmy_fn_2 += dmy_fn[2];
-
-                    // stress
-                    ss0 += (dmy_fn[0] * r_ij_vec[1]);
-
-                    // rigid body forces & torques
-                    if (SW_PT == rigid) {
-                        int rigidID_m = Particle_RigidID[m];
+                if (r_ij < pair_cutoff) {
+                    double dmy_r = MIN(cap / r_ij, Lennard_Jones_f(r_ij, LJ_dia, EPSILON, LJ_powers));
 
+                    {
+                        // forces
+                        double dmy_fn[DIM] = {0.0, 0.0, 0.0};
                         for (int d = 0; d < DIM; d++) {
-                            forceGrs[rigidID_m][d] -= dmy_fn[d];
+                            dmy_fn[d] = (dmy_r) * (-r_ij_vec[d]);
+                            (*p_m).fr[d] -= dmy_fn[d];
                         }
+                        sum_dmy_fn_0 += dmy_fn[0];
+                        sum_dmy_fn_1 += dmy_fn[1];
+                        sum_dmy_fn_2 += dmy_fn[2];
+
+                        // stress
+                        ss0 += (dmy_fn[0] * r_ij_vec[1]);
 
-                        sum_torqueGrs_0 += ((GRvecs[n][1] * dmy_fn[2] - GRvecs[n][2] * dmy_fn[1]));
-                        sum_torqueGrs_1 += ((GRvecs[n][2] * dmy_fn[0] - GRvecs[n][0] * dmy_fn[2]));
-                        sum_torqueGrs_2 += ((GRvecs[n][0] * dmy_fn[1] - GRvecs[n][1] * dmy_fn[0]));
+                        // rigid body forces & torques
+                        if (SW_PT == rigid) {
+                            int rigidID_m = Particle_RigidID[m];
 
-                        torqueGrs[rigidID_m][0] += ((GRvecs[m][1] * dmy_fn[2] - GRvecs[m][2] * dmy_fn[1]));
-                        torqueGrs[rigidID_m][1] += ((GRvecs[m][2] * dmy_fn[0] - GRvecs[m][0] * dmy_fn[2]));
-                        torqueGrs[rigidID_m][2] += ((GRvecs[m][0] * dmy_fn[1] - GRvecs[m][1] * dmy_fn[0]));
+                            for (int d = 0; d < DIM; d++) {
+                                Rigid_Bead_Forces[m][d] -= dmy_fn[d];
+                            }
 
-                        double R_IJ_vec[DIM];
-                        double R_IJ;
-                        distance0_func(xGs[rigidID_n], xGs[rigidID_m], R_IJ, R_IJ_vec);
-                        rs0 += (dmy_fn[0] * R_IJ_vec[1]);
+                            double R_IJ_vec[DIM];
+                            double R_IJ;
+                            distance0_func(xGs[rigidID_n], xGs[rigidID_m], R_IJ, R_IJ_vec);
+                            rs0 += (dmy_fn[0] * R_IJ_vec[1]);
+                        }
                     }
                 }
             }
         }
 
         if (SW_PT == rigid) {
-            forceGrs[rigidID_n][0] += sum_dmy_fn_0;
-            forceGrs[rigidID_n][1] += sum_dmy_fn_1;
-            forceGrs[rigidID_n][2] += sum_dmy_fn_2;
-
-            torqueGrs[rigidID_n][0] += sum_torqueGrs_0;
-            torqueGrs[rigidID_n][1] += sum_torqueGrs_1;
-            torqueGrs[rigidID_n][2] += sum_torqueGrs_2;
+            Rigid_Bead_Forces[n][0] += sum_dmy_fn_0;
+            Rigid_Bead_Forces[n][1] += sum_dmy_fn_1;
+            Rigid_Bead_Forces[n][2] += sum_dmy_fn_2;
         }
         (*p_n).fr[0] += sum_dmy_fn_0;
         (*p_n).fr[1] += sum_dmy_fn_1;
@@ -300,6 +274,8 @@ void Calc_f_Lennard_Jones_shear_cap_primitive(
     // dev_shear_stress_rot += shear_stress[1];
 
     if (SW_PT == rigid) {
+        rigid_segmented_sum(forceGrs, torqueGrs, Rigid_Bead_Forces, NULL);
+
         double dmy_shear = 0.0;
 #pragma omp parallel for reduction(+ : dmy_shear)
         for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
@@ -417,9 +393,6 @@ void Calc_f_hydro_correct_precision(Particle *p, double const *phi_sum, double c
     double v_rot[DIM];
     int    pspec;
 
-    double forceg[DIM];
-    double torqueg[DIM];
-    int    rigidID;
     // initialize forceGs and torqueGs
     for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
         for (int d = 0; d < DIM; d++) {
@@ -443,22 +416,17 @@ void Calc_f_hydro_correct_precision(Particle *p, double const *phi_sum, double c
                                  dmyR,       \
                                  dmy_phi,    \
                                  v_rot,      \
-                                 pspec,      \
-                                 rigidID,    \
-                                 forceg,     \
-                                 torqueg)
+                                 pspec)
     for (int n = 0; n < Particle_Number; n++) {
         // double xp[DIM],vp[DIM],omega_p[DIM];
         // int x_int[DIM];
         // double residue[DIM];
-        if (SW_PT == rigid) rigidID = Particle_RigidID[n];
         for (int d = 0; d < DIM; d++) {
             xp[d]      = p[n].x[d];
             vp[d]      = p[n].v[d];
             omega_p[d] = p[n].omega[d];
 
             force[d] = torque[d] = 0.0;
-            forceg[d] = torqueg[d] = 0.0;
         }
 
         sw_in_cell = Particle_cell(xp, DX, x_int, residue);  // {1,0} が返ってくる
@@ -484,13 +452,6 @@ void Calc_f_hydro_correct_precision(Particle *p, double const *phi_sum, double c
                 torque[1] += (r[2] * dmy_fp[0] - r[0] * dmy_fp[2]);
                 torque[2] += (r[0] * dmy_fp[1] - r[1] * dmy_fp[0]);
             }
-
-            if (SW_PT == rigid) {
-                for (int d = 0; d < DIM; d++) forceg[d] += dmy_fp[d];
-                torqueg[0] += ((GRvecs[n][1] + r[1]) * dmy_fp[2] - (GRvecs[n][2] + r[2]) * dmy_fp[1]);
-                torqueg[1] += ((GRvecs[n][2] + r[2]) * dmy_fp[0] - (GRvecs[n][0] + r[0]) * dmy_fp[2]);
-                torqueg[2] += ((GRvecs[n][0] + r[0]) * dmy_fp[1] - (GRvecs[n][1] + r[1]) * dmy_fp[0]);
-            }
         }  // mesh
 
         pspec = p[n].spec;
@@ -507,14 +468,12 @@ void Calc_f_hydro_correct_precision(Particle *p, double const *phi_sum, double c
         }
         if (SW_PT == rigid) {
             for (int d = 0; d < DIM; d++) {
-#pragma omp atomic
-                forceGs[rigidID][d] += dmy * forceg[d];
-
-#pragma omp atomic
-                torqueGs[rigidID][d] += dmy * torqueg[d];
+                Rigid_Bead_Forces[n][d]  = dmy * force[d];
+                Rigid_Bead_Torques[n][d] = dmy * torque[d];
             }
         }
     }  // Particle_Number
+    if (SW_PT == rigid) rigid_segmented_sum(forceGs, torqueGs, Rigid_Bead_Forces, Rigid_Bead_Torques);
 }
 
 void Calc_f_hydro_correct_precision_OBL(Particle *           p,
@@ -549,8 +508,6 @@ void Calc_f_hydro_correct_precision_OBL(Particle *           p,
     double sum_force  = 0.0;
     double sum_volume = 0.0;
 
-    double forceg[DIM];
-    double torqueg[DIM];
     double dVg[Rigid_Number][DIM];
     double dWg[Rigid_Number][DIM];
     // initialize forceGs and torqueGs
@@ -581,13 +538,9 @@ void Calc_f_hydro_correct_precision_OBL(Particle *           p,
                                  dmy_ry,     \
                                  v_rot,      \
                                  sign,       \
-                                 im,         \
-                                 forceg,     \
-                                 torqueg)
+                                 im)
     for (int n = 0; n < Particle_Number; n++) {
-        int rigidID;
         dmy_rhop = RHO_particle[p[n].spec];
-        if (SW_PT == rigid) rigidID = Particle_RigidID[n];
 
         for (int d = 0; d < DIM; d++) {
             xp[d]      = p[n].x[d];
@@ -595,7 +548,6 @@ void Calc_f_hydro_correct_precision_OBL(Particle *           p,
             omega_p[d] = p[n].omega[d];
 
             force[d] = torque[d] = 0.0;
-            forceg[d] = torqueg[d] = 0.0;
         }
 
         volume[n]  = 0.0;
@@ -631,12 +583,6 @@ void Calc_f_hydro_correct_precision_OBL(Particle *           p,
                 torque[1] += (r[2] * dmy_fp[0] - r[0] * dmy_fp[2]);
                 torque[2] += (r[0] * dmy_fp[1] - r[1] * dmy_fp[0]);
             }
-            if (SW_PT == rigid) {
-                for (int d = 0; d < DIM; d++) forceg[d] += dmy_fp[d];
-                torqueg[0] += ((GRvecs[n][1] + r[1]) * dmy_fp[2] - (GRvecs[n][2] + r[2]) * dmy_fp[1]);
-                torqueg[1] += ((GRvecs[n][2] + r[2]) * dmy_fp[0] - (GRvecs[n][0] + r[0]) * dmy_fp[2]);
-                torqueg[2] += ((GRvecs[n][0] + r[0]) * dmy_fp[1] - (GRvecs[n][1] + r[1]) * dmy_fp[0]);
-            }
 
             dmy_ry = (r_mesh[1] + sign * L_particle[1]);
 #pragma omp atomic
@@ -659,11 +605,8 @@ void Calc_f_hydro_correct_precision_OBL(Particle *           p,
         }
         if (SW_PT == rigid) {
             for (int d = 0; d < DIM; d++) {
-#pragma omp atomic
-                forceGs[rigidID][d] += dmy * forceg[d];
-
-#pragma omp atomic
-                torqueGs[rigidID][d] += dmy * torqueg[d];
+                Rigid_Bead_Forces[n][d]  = dmy * force[d];
+                Rigid_Bead_Torques[n][d] = dmy * torque[d];
             }
         }
 
@@ -702,6 +645,7 @@ void Calc_f_hydro_correct_precision_OBL(Particle *           p,
     sum_volume /= RHO;
 
     if (SW_PT == rigid) {
+        rigid_segmented_sum(forceGs, torqueGs, Rigid_Bead_Forces, Rigid_Bead_Torques);
 #pragma omp parallel for
         for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
             for (int d = 0; d < DIM; d++) {
@@ -784,6 +728,8 @@ void Calc_multipole_interaction_force_torque(Particle *p) {
             for (int d = 0; d < DIM; d++) ri[d] = xi[d];
         }
         if (ewald_param.dipole) {
+            // with induced dipoles ewald_mem.mu keeps the total dipoles of the last step as initial guess
+            double **mu_space = (ewald_param.polarizable ? ewald_mem.mu_perm : ewald_mem.mu);
             for (int specID = 0; specID < Component_Number; specID++) {
                 const int nump    = Particle_Numbers[specID];
                 double *  mu_body = multipole_mu[specID];
@@ -791,7 +737,7 @@ void Calc_multipole_interaction_force_torque(Particle *p) {
 #pragma omp parallel for
                 for (int i0 = 0; i0 < nump; i0++) {
                     int i = offset + i0;
-                    compute_particle_dipole(ewald_mem.mu[i], mu_body, p[i].q);
+                    compute_particle_dipole(mu_space[i], mu_body, p[i].q);
                 }
                 offset += Particle_Numbers[specID];
             }
@@ -811,95 +757,6 @@ void Calc_multipole_interaction_force_torque(Particle *p) {
     }
 
     if (SW_PT == rigid) {  // Update rigid forces & torques
-#pragma omp parallel for
-        for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
-            for (int n = Rigid_Particle_Cumul[rigidID]; n < Rigid_Particle_Cumul[rigidID + 1]; n++) {
-                const double *frc = ewald_mem.force[n];
-                const double *tau = ewald_mem.torque[n];
-                for (int d = 0; d < DIM; d++) {
-                    forceGrs[rigidID][d] += frc[d];
-                    torqueGrs[rigidID][d] += tau[d];
-                }
-                {
-                    torqueGrs[rigidID][0] += (GRvecs[n][1] * frc[2] - GRvecs[n][2] * frc[1]);
-                    torqueGrs[rigidID][1] += (GRvecs[n][2] * frc[0] - GRvecs[n][0] * frc[2]);
-                    torqueGrs[rigidID][2] += (GRvecs[n][0] * frc[1] - GRvecs[n][1] * frc[0]);
-                }
-            }
-        }
-    }
-}
-
-void Calc_multipole_interaction_force_torque_with_image(Particle *p) {
-    {  // Mem copy
-#pragma omp parallel for
-        for (int i = 0; i < Particle_Number * 2; i++) {
-            double *ri = ewald_mem.r[i];
-            double *xi;
-            if (i < Particle_Number) {
-                xi = p[i].x;
-                for (int d = 0; d < DIM; d++) {
-                    ri[d] = xi[d];
-                }
-            } else {
-                xi = p[i - Particle_Number].x;
-                for (int d = 0; d < DIM; d++) {
-                    if (d == 2) {
-                        ri[d] = xi[d] - 4.1;
-                    } else {
-                        ri[d] = xi[d];
-                    }
-                }
-            }
-        }
-        if (ewald_param.dipole) {
-            for (int specID = 0; specID < Component_Number; specID++) {
-                const int nump        = Particle_Numbers[specID];
-                const int nump_double = nump * 2;
-                double *  mu_body     = multipole_mu[specID];
-                int       offset      = 0;
-#pragma omp parallel for
-                for (int i0 = 0; i0 < nump_double; i0++) {
-                    int i = offset + i0;
-                    if (i0 < nump) {
-                        compute_particle_dipole(ewald_mem.mu[i], mu_body, p[i].q);
-                    } else {
-                        compute_particle_dipole_image(ewald_mem.mu[i], mu_body, p[i - nump].q);
-                    }
-                }
-                offset += Particle_Numbers[specID] * 2;
-            }
-        }
-        compute_ewald_sum();
-    }
-
-    {  // Update particle forces & torques
-#pragma omp parallel for
-        for (int i = 0; i < Particle_Number; i++) {
-            Particle &pi = p[i];
-            for (int d = 0; d < DIM; d++) {
-                pi.fr[d] += ewald_mem.force[i][d];
-                pi.torque_r[d] += ewald_mem.torque[i][d];
-            }
-        }
-    }
-
-    if (SW_PT == rigid) {  // Update rigid forces & torques
-#pragma omp parallel for
-        for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
-            for (int n = Rigid_Particle_Cumul[rigidID]; n < Rigid_Particle_Cumul[rigidID + 1]; n++) {
-                const double *frc = ewald_mem.force[n];
-                const double *tau = ewald_mem.torque[n];
-                for (int d = 0; d < DIM; d++) {
-                    forceGrs[rigidID][d] += frc[d];
-                    torqueGrs[rigidID][d] += tau[d];
-                }
-                {
-                    torqueGrs[rigidID][0] += (GRvecs[n][1] * frc[2] - GRvecs[n][2] * frc[1]);
-                    torqueGrs[rigidID][1] += (GRvecs[n][2] * frc[0] - GRvecs[n][0] * frc[2]);
-                    torqueGrs[rigidID][2] += (GRvecs[n][0] * frc[1] - GRvecs[n][1] * frc[0]);
-                }
-            }
-        }
+        rigid_segmented_sum(forceGrs, torqueGrs, ewald_mem.force, ewald_mem.torque);
     }
 }
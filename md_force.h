@@ -10,11 +10,14 @@
 
 #include <assert.h>
 
+#include <vector>
+
 #include "ewald_wrapper.h"
 #include "input.h"
 #include "interaction.h"
 #include "make_phi.h"
 #include "particle_rotation_solver.h"
+#include "rigid.h"
 #include "variable.h"
 
 extern double *Hydro_force;
@@ -178,8 +181,11 @@ inline void rigid_chain_debug(Particle *p, const double &time, const int &rigidI
 */
 void Calc_harmonic_torque_quincke(Particle *p);
 
+/*!
+  \brief Electrostatic (charge / dipole) forces and torques from the ewald sum
+  \details With mirror images enabled the conducting images across the lower wall surface are included by the ewald
+  sum itself, without duplicating the particles
+ */
 void Calc_multipole_interaction_force_torque(Particle *p);
 
-void Calc_multipole_interaction_force_torque_with_image(Particle *p);
-
 #endif
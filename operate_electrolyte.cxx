@@ -34,6 +34,32 @@ inline void Add_external_electric_field_x(double *potential, const CTime &jikan)
         }
     }
 }
+// Solute charge density sum_n Z_n e C_n(r) (real space). The transform is linear, so the species are combined in
+// reciprocal space and a single inverse transform is needed whatever N_spec is.
+inline void Conc_k2ion_charge(double **conc_k, double *ion_charge) {
+#pragma omp parallel for
+    for (int im = 0; im < NX * NY * NZ_; im++) {
+        double dmy = 0.0;
+        for (int n = 0; n < N_spec; n++) dmy += Valency_e[n] * conc_k[n][im];
+        ion_charge[im] = dmy;
+    }
+    A_k2a(ion_charge);
+}
+
+// charge_density += (1 - phi) ion_charge
+inline void Add_ion_charge(double *charge_density, const double *phi_p, const double *ion_charge) {
+#pragma omp parallel for
+    for (int i = 0; i < NX; i++) {
+        for (int j = 0; j < NY; j++) {
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+#pragma omp simd
+            for (int k = 0; k < NZ; k++) {
+                charge_density[im0 + k] += ion_charge[im0 + k] * (1. - phi_p[im0 + k]);
+            }
+        }
+    }
+}
+
 void Conc_k2charge_field(Particle *p,
                          double ** conc_k,
                          double *  charge_density,
@@ -41,29 +67,11 @@ void Conc_k2charge_field(Particle *p,
                          ,
                          double *dmy_value  // working memory
 ) {
-    {
-        Reset_phi(phi_p);
-        Reset_phi(charge_density);
-        Make_phi_qq_particle(phi_p, charge_density, p);
-        int    im;
-        double dmy_phi;
-        double dmy_conc;
-
-        for (int n = 0; n < N_spec; n++) {
-            A_k2a_out(conc_k[n], dmy_value);
-#pragma omp parallel for private(im, dmy_phi, dmy_conc)
-            for (int i = 0; i < NX; i++) {
-                for (int j = 0; j < NY; j++) {
-                    for (int k = 0; k < NZ; k++) {
-                        im       = (i * NY * NZ_) + (j * NZ_) + k;
-                        dmy_phi  = phi_p[im];
-                        dmy_conc = dmy_value[im];
-                        charge_density[im] += Valency_e[n] * dmy_conc * (1. - dmy_phi);
-                    }
-                }
-            }
-        }
-    }
+    Reset_phi(phi_p);
+    Reset_phi(charge_density);
+    Make_phi_qq_particle(phi_p, charge_density, p);
+    Conc_k2ion_charge(conc_k, dmy_value);
+    Add_ion_charge(charge_density, phi_p, dmy_value);
 }
 
 void Charge_field_k2Coulomb_potential_k_PBC(double *potential) {
@@ -99,72 +107,28 @@ void Make_Coulomb_force_x_on_fluid(double ** force,
         Reset_phi(phi);
         Reset_phi(charge_density);
         Make_phi_qq_fixed_particle(phi, charge_density, p);
-        for (int n = 0; n < N_spec; n++) {
-            A_k2a_out(conc_k[n], potential);
-            for (int i = 0; i < NX; i++) {
-                for (int j = 0; j < NY; j++) {
-                    for (int k = 0; k < NZ; k++) {
-                        double dmy_phi  = phi[(i * NY * NZ_) + (j * NZ_) + k];
-                        double dmy_conc = potential[(i * NY * NZ_) + (j * NZ_) + k];
-                        charge_density[(i * NY * NZ_) + (j * NZ_) + k] += Valency_e[n] * dmy_conc * (1. - dmy_phi);
-                    }
-                }
-            }
-        }
+        Conc_k2ion_charge(conc_k, potential);
+        Add_ion_charge(charge_density, phi, potential);
     }
 
     double external[DIM];
     for (int d = 0; d < DIM; d++) {
-        external[d] = E_ext[d];
+        external[d] = (External_field ? E_ext[d] : 0.0);
         if (AC) {
             double time = jikan.time;
             external[d] *= sin(Angular_Frequency * time);
         }
     }
-    int    im;
-    double electric_field;
-#pragma omp parallel
-    {
-//#pragma omp parallel for private(im,electric_field)
-#pragma omp for private(im, electric_field)
-        for (int i = 0; i < NX; i++) {
-            for (int j = 0; j < NY; j++) {
-                for (int k = 0; k < NZ; k++) {
-                    im             = (i * NY * NZ_) + (j * NZ_) + k;
-                    electric_field = -force[0][im];
-                    if (External_field) {
-                        electric_field += external[0];
-                    }
-                    force[0][im] = charge_density[im] * electric_field;
-                }
-            }
-        }
-//#pragma omp parallel for private(im,electric_field)
-#pragma omp for private(im, electric_field)
-        for (int i = 0; i < NX; i++) {
-            for (int j = 0; j < NY; j++) {
-                for (int k = 0; k < NZ; k++) {
-                    im             = (i * NY * NZ_) + (j * NZ_) + k;
-                    electric_field = -force[1][im];
-                    if (External_field) {
-                        electric_field += external[1];
-                    }
-                    force[1][im] = charge_density[im] * electric_field;
-                }
-            }
-        }
-//#pragma omp parallel for private(im,electric_field)
-#pragma omp for private(im, electric_field)
-        for (int i = 0; i < NX; i++) {
-            for (int j = 0; j < NY; j++) {
-                for (int k = 0; k < NZ; k++) {
-                    im             = (i * NY * NZ_) + (j * NZ_) + k;
-                    electric_field = -force[2][im];
-                    if (External_field) {
-                        electric_field += external[2];
-                    }
-                    force[2][im] = charge_density[im] * electric_field;
-                }
+#pragma omp parallel for
+    for (int i = 0; i < NX; i++) {
+        for (int j = 0; j < NY; j++) {
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+#pragma omp simd
+            for (int k = 0; k < NZ; k++) {
+                const int im = im0 + k;
+                force[0][im] = charge_density[im] * (-force[0][im] + external[0]);
+                force[1][im] = charge_density[im] * (-force[1][im] + external[1]);
+                force[2][im] = charge_density[im] * (-force[2][im] + external[2]);
             }
         }
     }
@@ -736,6 +700,15 @@ void Init_rho_ion(double **Concentration, Particle *p, CTime &jikan) {
         fprintf(stderr,
                 "# radius of particle / Debye length  %g\n",
                 RADIUS * sqrt(PI4 * SQ(Valency[0]) * Bjerrum_length * Counterion_density));
+        if (NP_semi_implicit) {
+            // salt free: the Debye time is known only here, Set_global_parameters imposes it on Tdump with salt
+            double debye_time =
+                1. / (kBT * Onsager_coeff_counterion * PI4 * SQ(Valency[0]) * Bjerrum_length * Counterion_density);
+            fprintf(stderr, "# Debye time %g\n", debye_time);
+            if (DT > debye_time) {
+                fprintf(stderr, "# Warning : DT = %g exceeds the Debye time, electromigration is explicit\n", DT);
+            }
+        }
 
         if (Poisson_Boltzmann) {
             Set_uniform_ion_charge_density_nosalt(Concentration[0], Total_solute, p);
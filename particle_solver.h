@@ -106,11 +106,7 @@ inline void Force(Particle *p) {
     }
 
     if (SW_MULTIPOLE == MULTIPOLE_ON) {
-        if (ewald_param.m_image == true) {
-            Calc_multipole_interaction_force_torque_with_image(p);
-        } else {
-            Calc_multipole_interaction_force_torque(p);
-        }
+        Calc_multipole_interaction_force_torque(p);
     }
 }
 
@@ -106,3 +106,103 @@ void splineCompute(splineSystem* spl, const double* fx) {
         }
     }
 }
+
+void splineBatchFree(splineBatch*& spl) {
+    free_1d_double(spl->a);
+    free_1d_double(spl->b);
+    free_1d_double(spl->c);
+    free_1d_double(spl->d);
+    free_1d_double(spl->Q);
+    free_1d_double(spl->Aii);
+    free_1d_double(spl->Ain);
+    delete spl;
+    spl = NULL;
+}
+void splineBatchInit(splineBatch*& spl, const int& n, const int& mmax, const double& dx) {
+    assert(mmax >= 1);
+    // the shared matrix is that of a single-line system
+    splineSystem* line;
+    splineInit(line, n, dx);
+
+    spl       = new splineBatch;
+    spl->n    = n;
+    spl->mmax = mmax;
+    spl->dx   = dx;
+    spl->a    = calloc_1d_double(n * mmax);
+    spl->b    = calloc_1d_double(n * mmax);
+    spl->c    = calloc_1d_double(n * mmax);
+    spl->d    = calloc_1d_double(n * mmax);
+    spl->Q    = calloc_1d_double(n * mmax);
+    spl->Aii  = alloc_1d_double(n);
+    spl->Ain  = alloc_1d_double(n);
+    for (int i = 0; i < n; i++) {
+        spl->Aii[i] = line->Aii[i];
+        spl->Ain[i] = line->Ain[i];
+    }
+    splineFree(line);
+}
+
+void splineBatchCompute(splineBatch* spl, const int& m) {
+    assert(m <= spl->mmax);
+    int           n   = spl->n;
+    double        dx  = spl->dx;
+    const double* a   = spl->a;
+    double*       b   = spl->b;
+    double*       c   = spl->c;
+    double*       d   = spl->d;
+    double*       Q   = spl->Q;
+    const double* Aii = spl->Aii;
+    const double* Ain = spl->Ain;
+
+    // reduce
+    {
+        // lower part
+#pragma omp simd
+        for (int l = 0; l < m; l++) {
+            Q[l]               = 3.0 * (a[m + l] - 2.0 * a[l] + a[(n - 1) * m + l]) / SQ(dx);
+            Q[(n - 1) * m + l] = 3.0 * (a[l] - 2.0 * a[(n - 1) * m + l] + a[(n - 2) * m + l]) / SQ(dx);
+        }
+        for (int i = 1; i < n - 1; i++) {
+            const double* ai = a + i * m;
+            double*       Qi = Q + i * m;
+#pragma omp simd
+            for (int l = 0; l < m; l++)
+                Qi[l] = 3.0 * (ai[m + l] - 2.0 * ai[l] + ai[l - m]) / SQ(dx) - Qi[l - m] / Aii[i - 1];
+        }
+
+        // upper part
+        for (int i = n - 3; i >= 0; i--) {
+            double* Qi = Q + i * m;
+#pragma omp simd
+            for (int l = 0; l < m; l++) Qi[l] -= Qi[m + l] / Aii[i + 1];
+        }
+
+        // last row
+        double* Qn = Q + (n - 1) * m;
+#pragma omp simd
+        for (int l = 0; l < m; l++) Qn[l] -= (Q[l] / Aii[0] + Q[(n - 2) * m + l] / Aii[n - 2]);
+    }
+
+    // back substitute for c_i coefficient
+    {
+        const double* cn = c + (n - 1) * m;
+#pragma omp simd
+        for (int l = 0; l < m; l++) c[(n - 1) * m + l] = Q[(n - 1) * m + l] / Aii[n - 1];
+        for (int i = n - 2; i >= 0; i--) {
+#pragma omp simd
+            for (int l = 0; l < m; l++) c[i * m + l] = (Q[i * m + l] - Ain[i] * cn[l]) / Aii[i];
+        }
+    }
+
+    // b_i & d_i coefficient
+    {
+        for (int i = 0; i < n; i++) {
+            int inext = (i < n - 1 ? i + 1 : 0);
+#pragma omp simd
+            for (int l = 0; l < m; l++) {
+                d[i * m + l] = (c[inext * m + l] - c[i * m + l]) / (3.0 * dx);
+                b[i * m + l] = (a[inext * m + l] - a[i * m + l]) / dx - c[i * m + l] * dx - d[i * m + l] * SQ(dx);
+            }
+        }
+    }
+}
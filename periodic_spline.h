@@ -68,4 +68,65 @@ void splineFree(splineSystem*& spl);
  */
 void splineCompute(splineSystem* spl, const double* fx);
 
+/*!
+  \brief Periodic spline interpolation of many lines sampled on the same grid
+  \details The lines share the factorised matrix (Aii, Ain) of splineSystem. Coefficients are stored sample-major,
+  a[i * m + l] for sample i of line l, so every step of the tridiagonal recurrences is a contiguous loop over the
+  m lines. Per line the arithmetic is that of splineCompute / splineFx.
+ */
+typedef struct splineBatch {
+    int     n;     // samples per line
+    int     mmax;  // line capacity
+    double  dx;
+    double* a;  // n * mmax, sample values on input to splineBatchCompute
+    double* b;
+    double* c;
+    double* d;
+    double* Q;
+    double* Aii;
+    double* Ain;
+} splineBatch;
+
+/*!
+  \brief Evaluate m lines at x using spline interpolation
+  \param[in] *spl splineBatch object with interpolation data
+  \param[in] m number of lines, as passed to splineBatchCompute
+  \param[in] x interpolation position
+  \param[out] *fx interpolated values of the m lines
+ */
+inline void splineBatchFx(const splineBatch* spl, const int& m, const double& x, double* fx) {
+    assert(x >= 0.0 && x < (spl->n) * (spl->dx));
+    int           i      = x / (spl->dx);
+    double        delta  = (x - (double)i * spl->dx);
+    double        delta2 = delta * delta;
+    const double* a      = spl->a + i * m;
+    const double* b      = spl->b + i * m;
+    const double* c      = spl->c + i * m;
+    const double* d      = spl->d + i * m;
+#pragma omp simd
+    for (int l = 0; l < m; l++) fx[l] = a[l] + b[l] * delta + c[l] * delta2 + d[l] * delta2 * delta;
+}
+
+/*!
+  \brief Initialize working memory
+  \param[in,out] *spl splineBatch object to initialize
+  \param[in] n number of grid points for interpolation
+  \param[in] mmax maximum number of lines
+  \param[in] dx grid spacing
+ */
+void splineBatchInit(splineBatch*& spl, const int& n, const int& mmax, const double& dx);
+
+/*!
+  \brief Free working memory
+  \param[in] *spl splineBatch object to free
+ */
+void splineBatchFree(splineBatch*& spl);
+
+/*!
+  \brief Compute periodic spline interpolation of m lines whose sample values are stored in spl->a
+  \param[in,out] *spl splineBatch
+  \param[in] m number of lines (at most mmax)
+ */
+void splineBatchCompute(splineBatch* spl, const int& m);
+
 #endif
@@ -465,6 +465,53 @@ inline void solver_Rigid_Position_OBL(Particle *p, const CTime &jikan, string CA
     update_Orientation(p);
 }
 
+/*!
+  \brief Reset the per-bead force accumulator used for segmented reductions
+ */
+inline void Reset_rigid_bead_forces() {
+#pragma omp parallel for
+    for (int n = 0; n < Particle_Number; n++) {
+        for (int d = 0; d < DIM; d++) Rigid_Bead_Forces[n][d] = 0.0;
+    }
+}
+
+/*!
+  \brief Add the forces and torques acting on the beads to the totals of their rigid bodies
+  \details Beads of rigid body I are contiguous (Rigid_Particle_Cumul[I] <= n < Rigid_Particle_Cumul[I+1]), so the
+  totals are segmented sums, computed with one thread per rigid body and without atomics
+  \f{align*}{
+  \vec{F}_I &= \sum_{n\in I} \vec{f}_n \\
+  \vec{N}_I &= \sum_{n\in I} \left(\vec{\tau}_n + \vec{G}_n \times \vec{f}_n\right)
+  \f}
+  with \f$\vec{G}_n\f$ the bead position relative to the center of mass (GRvecs)
+  \param[in,out] forceG rigid body forces (incremented)
+  \param[in,out] torqueG rigid body torques (incremented)
+  \param[in] f bead forces
+  \param[in] tau bead torques (NULL if the beads carry no torque of their own)
+ */
+inline void rigid_segmented_sum(double **forceG, double **torqueG, double const *const *f, double const *const *tau) {
+#pragma omp parallel for
+    for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
+        double force[DIM]  = {0.0, 0.0, 0.0};
+        double torque[DIM] = {0.0, 0.0, 0.0};
+        for (int n = Rigid_Particle_Cumul[rigidID]; n < Rigid_Particle_Cumul[rigidID + 1]; n++) {
+            const double *fn = f[n];
+            const double *gn = GRvecs[n];
+            for (int d = 0; d < DIM; d++) force[d] += fn[d];
+            if (tau != NULL) {
+                for (int d = 0; d < DIM; d++) torque[d] += tau[n][d];
+            }
+            torque[0] += (gn[1] * fn[2] - gn[2] * fn[1]);
+            torque[1] += (gn[2] * fn[0] - gn[0] * fn[2]);
+            torque[2] += (gn[0] * fn[1] - gn[1] * fn[0]);
+        }
+        for (int d = 0; d < DIM; d++) {
+            forceG[rigidID][d] += force[d];
+            torqueG[rigidID][d] += torque[d];
+        }
+    }
+}
+
 /*!
   \brief Update rigid velocities (VelocityGs) and angular velocities (OmegaGs)
   \note set_Rigid_VOGs() after calculating xGs, Rigid_IMoments, forceGs and torqueGs!!
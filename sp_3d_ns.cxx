@@ -309,8 +309,12 @@ void Time_evolution_hydro_fdm(double **&u, double *Pressure, double **f, Particl
         }
     }
 
+    // the stored mobility tensor is only needed by the psi_dry matrix assembly; other kernels evaluate it on the fly
+    const bool coef_stored = PHASE_SEPARATION && SW_CHST == implicit_scheme && !spectral_ch && ps.psi_dry != 0.0;
     if (PHASE_SEPARATION) {
-        Calc_coef(coef, phi_p, phi_wall_prime);
+        if (coef_stored) {
+            Calc_coef(coef, phi_p, phi_wall_prime);
+        }
         if (SW_CHST == explicit_scheme) {
             Cpy_v1(psi_o, psi);
             if (SW_WALL != NO_WALL) {
@@ -318,9 +322,11 @@ void Time_evolution_hydro_fdm(double **&u, double *Pressure, double **f, Particl
             } else {
                 Calc_cp(phi, psi_all, cp);
             }
-            Update_psi_euler(psi_all, psi, u, phi, phi_wall, cp, coef, jikan);
+            Update_psi_euler(psi_all, psi, u, phi, phi_wall, cp, NULL, jikan);
         } else if (SW_CHST == implicit_scheme) {
-            if (jikan.ts < 2) {
+            if (spectral_ch) {
+                CH_solver_spectral(psi, psi_all, psi_o, psi_all_o, phi, phi_p, u, jikan);
+            } else if (jikan.ts < 2) {
 #ifdef _LIS_SOLVER
                 CH_solver_implicit_euler(
                     psi, psi_all, psi_o, phi, phi_p, phi_wall, phi_wall_prime, u, jikan, is_ch, ie_ch);
@@ -339,7 +345,7 @@ void Time_evolution_hydro_fdm(double **&u, double *Pressure, double **f, Particl
             }
         }
     }
-    Calc_flux(flux, u, psi_all, cp);
+    Calc_flux(flux, u, psi_all, cp, coef_stored ? coef : NULL);
 }
 
 void Time_evolution_hydro_OBL(double **zeta, double uk_dc[DIM], double **f, Particle *p, CTime &jikan) {
@@ -392,10 +398,8 @@ void Time_evolution_hydro_OBL(double **zeta, double uk_dc[DIM], double **f, Part
 
         // u   -> velocity field in oblique coordinates
         // ucp -> velocity fild in cartesian coordinates
-        // Calc_shear_rate_eff();
         // AC
         sreff_old = Shear_rate_eff;
-        if (!Shear_AC) Calc_shear_rate_eff();
         //
         // End Deformation
 
@@ -519,9 +523,6 @@ void Time_evolution_hydro_OBL_fdm(double **&u, double *Pressure, double **f, Par
 
         // u   -> velocity field in oblique coordinates
         // ucp -> velocity field in cartesian coordinates
-        // AC
-        if (!Shear_AC) Calc_shear_rate_eff();
-        //
         // End Deformation
 
         if (!Fixed_particle) {
@@ -828,6 +829,9 @@ int main(int argc, char *argv[]) {
             Init_ch();
         }
 #endif
+        if (SW_CHST == implicit_scheme) {
+            Init_ch_spectral();
+        }
     }
 
     Particle *particles = new Particle[Particle_Number];
@@ -838,6 +842,7 @@ int main(int argc, char *argv[]) {
         } else if ((SW_PT == rigid && SW_QUINCKE == QUINCKE_OFF) && !(DISTRIBUTION == user_specify)) {
             Init_Rigid(particles);
         }
+        Init_pair_exclusion();
     }
     if (SW_MULTIPOLE == MULTIPOLE_ON) init_ewald_sum(LX, LY, LZ, Particle_Number);
 
@@ -978,6 +983,7 @@ Shear_NS_LE_CH_FDM) { calc_shear_rate_field(u, shear_rate_field);
                 if (SW_EQ == Electrolyte) {
                     Electrolyte_free_energy(SHOW, stderr, particles, Concentration, jikan);
                 }
+                print_ewald_polarization(stderr);
                 if (jikan.ts != resumed_ts) {
                     double block_time  = block_timer.stop();
                     double global_time = global_timer.stop();
@@ -1001,7 +1007,7 @@ Shear_NS_LE_CH_FDM) { calc_shear_rate_field(u, shear_rate_field);
         jikan.time += jikan.dt_fluid;
 
         if (SW_EQ == Shear_Navier_Stokes) {
-            Shear_rate_eff = Update_strain(Shear_strain_realized, jikan, zeta, uk_dc, u);
+            Shear_rate_eff = Update_strain(Shear_strain_realized, jikan, zeta);
             Mean_shear_stress(SHOW, stderr, particles, jikan, Shear_rate_eff);
         } else if (SW_EQ == Shear_Navier_Stokes_Lees_Edwards || SW_EQ == Shear_Navier_Stokes_Lees_Edwards_FDM ||
                    SW_EQ == Shear_NS_LE_CH_FDM) {
@@ -1092,6 +1098,7 @@ Shear_NS_LE_CH_FDM) { calc_shear_rate_field(u, shear_rate_field);
         free_1d_double(zeta[d]);
     }
     free(zeta);
+    if (Particle_Number > 0) Free_pair_exclusion();
     delete[] particles;
     if (U2M) {
 #ifdef _LIS_SOLVER
@@ -1100,6 +1107,7 @@ Shear_NS_LE_CH_FDM) { calc_shear_rate_field(u, shear_rate_field);
 #else
         Free_matrix_solver();
 #endif
+        Free_ch_spectral();
         Free_fdm();
         free_1d_double(shear_rate_field);
     }
@@ -140,108 +140,108 @@ inline void Electrolyte_free_energy(const Count_SW &OPERATION,
         exit_job(EXIT_FAILURE);
     }
 }
-inline double Calc_instantaneous_shear_rate(double **zeta, double uk_dc[DIM], double **u  // working memory
-) {
+/*!
+  \brief Mean of du_x/dy over the slab NY/4 <= j < 3NY/4 (Shear_Navier_Stokes)
+  \details Summed over x and z only the kx = kz = 0 modes survive, and for those du_x/dy = -omega_z, which is stored
+  in zeta[0]. The sum over the slab is then a geometric series per ky, so the rate follows from NY modes without any
+  transform:
+  \f[\sum_{j} \partial_y u_x = -\frac{1}{N_y}\sum_{k_y} \Re\left[\ft{\omega}_z(0,k_y,0)
+  \sum_{j=N_y/4}^{3N_y/4-1} e^{i 2\pi k_y j/N_y}\right]\f]
+  \param[in] zeta vorticity field (reciprocal space)
+ */
+inline double Calc_instantaneous_shear_rate(double **zeta) {
     static const double hivolume  = Ivolume * POW3(DX) * 2.;
-    static int          ny0       = NY / 4;
-    static int          ny1       = 3 * NY / 4;
+    static const int    ny0       = NY / 4;
+    static const int    ny1       = 3 * NY / 4;
+    static double *     slab_re   = NULL;
+    static double *     slab_im   = NULL;
     double              srate_eff = 0.0;
 
-    Zeta_k2u_k(zeta, uk_dc, u);
-    A_k2dya_k(u[0], u[1]);
-    A_k2a(u[1]);
-    {
-#pragma omp parallel for reduction(+ : srate_eff)
-        for (int i = 0; i < NX; i++) {
-            for (int j = ny0; j < ny1; j++) {
-                for (int k = 0; k < NZ; k++) {
-                    srate_eff += u[1][(i * NY * NZ_) + (j * NZ_) + k];
-                }
+    if (slab_re == NULL) {  // slab weights of each ky mode
+        slab_re = alloc_1d_double(NY);
+        slab_im = alloc_1d_double(NY);
+        for (int j = 0; j < NY; j++) {
+            const double theta = PI2 * (double)KY_int[j * NZ_] / (double)NY;
+            slab_re[j] = slab_im[j] = 0.0;
+            for (int jj = ny0; jj < ny1; jj++) {
+                slab_re[j] += cos(theta * jj);
+                slab_im[j] += sin(theta * jj);
             }
+            slab_re[j] /= (double)NY;
+            slab_im[j] /= (double)NY;
         }
     }
-    return (srate_eff * hivolume);
-}
-
-inline double Calc_local_gradient_y_OBL(const double *field, int im) {
-    const double INV_2DX = 1. / (2. * DX);
-    int          i, j, k;
-    im2ijk(im, &i, &j, &k);
-    // periodic boundary condition
-    int ip1, jp1;
-    int im1, jm1;
-    ip1 = adj(1, i, NX);
-    jp1 = adj(1, j, NY);
-    im1 = adj(-1, i, NX);
-    jm1 = adj(-1, j, NY);
-    // set adjacent meshes
-    int im_ip1_jp1 = ijk2im(ip1, jp1, k);
-    int im_im1_jp1 = ijk2im(im1, jp1, k);
-    int im_ip1_jm1 = ijk2im(ip1, jm1, k);
-    int im_im1_jm1 = ijk2im(im1, jm1, k);
-    // interior division
-    double field_p1 = 0.5 * ((1 - degree_oblique) * field[im_ip1_jp1] + (1 + degree_oblique) * field[im_im1_jp1]);
-    double field_m1 = 0.5 * ((1 - degree_oblique) * field[im_im1_jm1] + (1 + degree_oblique) * field[im_ip1_jm1]);
-    double local_dfield_dy = (field_p1 - field_m1) * INV_2DX;
-    return local_dfield_dy;
-}
 
-inline void Calc_shear_rate_eff() {
-    static const double ivolume    = Ivolume * POW3(DX);
-    double              s_rate_eff = 0.;
-#pragma omp parallel for reduction(+ : s_rate_eff)
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int im = i * NY * NZ_ + j * NZ_ + k;
-                s_rate_eff += Calc_local_gradient_y_OBL(u[0], im);
-            }
-        }
+    for (int j = 0; j < NY; j++) {  // kx = kz = 0
+        const int im = j * NZ_;
+        if (KY_int[im] == 0) continue;
+        srate_eff -= (zeta[0][im] * slab_re[j] - zeta[0][im + 1] * slab_im[j]);
     }
-    s_rate_eff *= ivolume;
-    Shear_rate_eff += s_rate_eff;
+    return (srate_eff * hivolume);
 }
 
-inline double Update_strain(double &     shear_strain_realized,
-                            const CTime &jikan,
-                            double **    zeta,
-                            double       uk_dc[DIM],
-                            double **    u  // working memory
-) {
-    double srate_eff = -Calc_instantaneous_shear_rate(zeta, uk_dc, u);
+inline double Update_strain(double &shear_strain_realized, const CTime &jikan, double **zeta) {
+    double srate_eff = -Calc_instantaneous_shear_rate(zeta);
     shear_strain_realized += srate_eff * jikan.dt_fluid;
     return srate_eff;
 }
 
-inline void Calc_fluid_stress(double **u, double *eta, double &fluid_stress) {
+/*!
+  \brief Shear stresses of the oblique-grid fields, accumulated in a single pass
+  \details du_x/dy and dpsi/dy are the centred oblique differences obtained by interior division between the
+  neighbouring x-points of rows j +- 1. The neighbour rows are located once per (i, j) from the stencil tables and the
+  sums run vectorised along k. As before, each stress is added to its argument and the total is then scaled.
+  \param[in] u velocity field (oblique coordinates)
+  \param[in] eta viscosity field, or NULL to skip the fluid stress
+  \param[in] psi order parameter, or NULL to skip the interfacial stress
+  \param[in,out] fluid_stress (fluid_stress + sum (Shear_rate_eff + du_x/dy) eta) / V
+  \param[in,out] interfacial_stress -alpha (interfacial_stress + sum dpsi/dx dpsi/dy) / V
+ */
+inline void Calc_shear_stress_OBL(double **u,
+                                  double * eta,
+                                  double * psi,
+                                  double & fluid_stress,
+                                  double & interfacial_stress) {
     static const double ivolume = Ivolume * POW3(DX);
-#pragma omp parallel for reduction(+ : fluid_stress)
-    for (int i = 0; i < NX; i++) {
-        for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int    im               = i * NY * NZ_ + j * NZ_ + k;
-                double shear_rate_local = Shear_rate_eff + Calc_local_gradient_y_OBL(u[0], im);
-                fluid_stress += shear_rate_local * eta[im];
-            }
-        }
-    }
-    fluid_stress *= ivolume;
-}
+    const double        INV_2DX = 1. / (2. * DX);
+    const double        w_p     = 0.5 * (1 - degree_oblique);
+    const double        w_m     = 0.5 * (1 + degree_oblique);
+    double              fs      = 0.0;
+    double              is      = 0.0;
 
-inline void Calc_interfacial_stress(double *psi, double &interfacial_stress) {
-    static const double ivolume = Ivolume * POW3(DX);
-#pragma omp parallel for reduction(+ : interfacial_stress)
+#pragma omp parallel for reduction(+ : fs, is)
     for (int i = 0; i < NX; i++) {
         for (int j = 0; j < NY; j++) {
-            for (int k = 0; k < NZ; k++) {
-                int    im      = i * NY * NZ_ + j * NZ_ + k;
-                double dpsi_dx = calc_gradient_o1_to_o1(psi, im, 0);
-                double dpsi_dy = Calc_local_gradient_y_OBL(psi, im);
-                interfacial_stress += dpsi_dx * dpsi_dy;
+            const int im0 = (i * NY * NZ_) + (j * NZ_);
+            const int pp  = im0 + stencil.xp[i] + stencil.yp[j];  // (i + 1, j + 1)
+            const int mp  = im0 + stencil.xm[i] + stencil.yp[j];  // (i - 1, j + 1)
+            const int mm  = im0 + stencil.xm[i] + stencil.ym[j];  // (i - 1, j - 1)
+            const int pm  = im0 + stencil.xp[i] + stencil.ym[j];  // (i + 1, j - 1)
+
+            if (eta != NULL) {
+                const double *ux = u[0];
+#pragma omp simd reduction(+ : fs)
+                for (int k = 0; k < NZ; k++) {
+                    double dux_dy = ((w_p * ux[pp + k] + w_m * ux[mp + k]) - (w_p * ux[mm + k] + w_m * ux[pm + k])) *
+                                    INV_2DX;
+                    fs += (Shear_rate_eff + dux_dy) * eta[im0 + k];
+                }
+            }
+            if (psi != NULL) {
+                const int xp = im0 + stencil.xp[i];
+                const int xm = im0 + stencil.xm[i];
+#pragma omp simd reduction(+ : is)
+                for (int k = 0; k < NZ; k++) {
+                    double dpsi_dx = (psi[xp + k] - psi[xm + k]) * INV_2DX;
+                    double dpsi_dy =
+                        ((w_p * psi[pp + k] + w_m * psi[mp + k]) - (w_p * psi[mm + k] + w_m * psi[pm + k])) * INV_2DX;
+                    is += dpsi_dx * dpsi_dy;
+                }
             }
         }
     }
-    interfacial_stress *= -ivolume * ps.alpha;
+    if (eta != NULL) fluid_stress = (fluid_stress + fs) * ivolume;
+    if (psi != NULL) interfacial_stress = (interfacial_stress + is) * (-ivolume * ps.alpha);
 }
 
 inline void Mean_shear_stress(const Count_SW &OPERATION,
@@ -309,7 +309,6 @@ inline void Mean_shear_stress(const Count_SW &OPERATION,
             double dev_stress_rot = (SW_PT == rigid ? rigid_dev_shear_stress_rot : dev_shear_stress_rot);
             double ETA_EFF        = ETA;
             fluid_stress          = ETA_EFF * srate_eff;
-            if (PHASE_SEPARATION) Calc_interfacial_stress(psi, interfacial_stress);
             if (VISCOSITY_CHANGE) {
                 // volume-averaged eta
                 double dmy;
@@ -319,8 +318,12 @@ inline void Mean_shear_stress(const Count_SW &OPERATION,
                     dmy = ps.ratio;
                 }
                 ETA_EFF = (ETA_A - ETA_B) * dmy + ETA_B;
-
-                if (ETA_A != ETA_B) Calc_fluid_stress(u, eta_s, fluid_stress);
+            }
+            {
+                double *eta_field = (VISCOSITY_CHANGE && ETA_A != ETA_B) ? eta_s : NULL;
+                double *psi_field = PHASE_SEPARATION ? psi : NULL;
+                if (eta_field != NULL || psi_field != NULL)
+                    Calc_shear_stress_OBL(u, eta_field, psi_field, fluid_stress, interfacial_stress);
             }
             apparent_stress = hydro_stress_new[1][0] + Inertia_stress + dev_stress + fluid_stress + interfacial_stress;
             fprintf(fout,
@@ -193,21 +193,13 @@ void Add_f_wall(Particle* p) {
     if (SW_WALL == FLAT_WALL) {
         if (SW_PT == rigid) {
 #pragma omp parallel for
-            for (int rigidID = 0; rigidID < Rigid_Number; rigidID++) {
-                double f_h = 0.0;
-                for (int n = Rigid_Particle_Cumul[rigidID]; n < Rigid_Particle_Cumul[rigidID + 1]; n++) {
-                    double fi = Compute_f_wall_single(p[n].x[wall.axis], cutoff, offset);
-                    f_h += fi;
-                    p[n].fr[wall.axis] += fi;
-                }
-                double Fh[DIM] = {0.0, 0.0, 0.0};
-                Fh[wall.axis]  = f_h;
-
-                forceGrs[rigidID][wall.axis] += f_h;
-                torqueGrs[rigidID][0] = GRvecs[rigidID][1] * Fh[2] - GRvecs[rigidID][2] * Fh[1];
-                torqueGrs[rigidID][1] = GRvecs[rigidID][2] * Fh[0] - GRvecs[rigidID][0] * Fh[2];
-                torqueGrs[rigidID][2] = GRvecs[rigidID][0] * Fh[1] - GRvecs[rigidID][1] * Fh[0];
+            for (int n = 0; n < Particle_Number; n++) {
+                double fi = Compute_f_wall_single(p[n].x[wall.axis], cutoff, offset);
+                p[n].fr[wall.axis] += fi;
+                for (int d = 0; d < DIM; d++) Rigid_Bead_Forces[n][d] = 0.0;
+                Rigid_Bead_Forces[n][wall.axis] = fi;
             }
+            rigid_segmented_sum(forceGrs, torqueGrs, Rigid_Bead_Forces, NULL);
         } else {
 #pragma omp parallel for
             for (int n = 0; n < Particle_Number; n++)
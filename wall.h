@@ -4,6 +4,7 @@
 
 #include "input.h"
 #include "profile.h"
+#include "rigid.h"
 
 void Init_Wall(double* phi);
 void Init_bottom_Wall(double* phi_wall_prime, double* grad_phi_wall_prime);